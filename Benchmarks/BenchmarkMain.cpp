@@ -0,0 +1,36 @@
+/*
+    BenchmarkMain.cpp
+
+    Build the CynthiaBenchmarks target (on by default, see CYNTHIA_BUILD_BENCHMARKS) in Release
+    and run it. With no arguments it runs every benchmark; otherwise only the ones named:
+
+        CynthiaBenchmarks interpolation tails
+*/
+
+#include <cstdio>
+#include <cstring>
+#include "Benchmarks.h"
+
+int main(int argc, char* argv[])
+{
+    const struct { const char* name; void (*run)(); } benchmarks[] = {
+        { "interpolation", runInterpolationBenchmark },
+        { "tails",         runTailDecayBenchmark },
+    };
+
+    for (const auto& benchmark : benchmarks)
+    {
+        bool selected = argc < 2;
+
+        for (int i = 1; i < argc; ++i)
+            selected = selected || std::strcmp(argv[i], benchmark.name) == 0;
+
+        if (! selected)
+            continue;
+
+        std::printf("\n== %s ==\n", benchmark.name);
+        benchmark.run();
+    }
+
+    return 0;
+}
@@ -0,0 +1,13 @@
+/*
+    Benchmarks.h
+
+    The benchmarks CynthiaBenchmarks runs, one per file in Benchmarks/. Each prints its own table.
+*/
+
+#pragma once
+
+// InterpolationBenchmark.cpp: cost and THD+N of each wavetable interpolation mode
+void runInterpolationBenchmark();
+
+// TailDecayBenchmark.cpp: cost of release and effect tails with flush-to-zero off
+void runTailDecayBenchmark();
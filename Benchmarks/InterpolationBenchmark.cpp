@@ -0,0 +1,104 @@
+/*
+    InterpolationBenchmark.cpp
+
+    Measures what each wavetable interpolation mode costs and what it buys.
+
+    For every mode, an oscillator plays the factory sine at a few pitches. The cost is the
+    time per output sample (best of several runs, rendered in voice-sized blocks); the
+    quality is THD+N, i.e. everything that isn't the fundamental, relative to it.
+
+    Each pitch is an exact number of cycles over the analysis length, so projecting onto the
+    fundamental separates it from the residue without any windowing.
+
+    Prints one row per mode and pitch. See BenchmarkMain.cpp for how to run it.
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "Benchmarks.h"
+#include "Cynthia_DSP/MorphingOscillator.h"
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int numSamples = 1 << 16;
+    constexpr int blockSize = 32;
+    constexpr int numRuns = 10;
+
+    double measureThdPlusNoise(const std::vector<float>& signal, double frequency)
+    {
+        double sinSum = 0.0, cosSum = 0.0, totalPower = 0.0;
+
+        for (int n = 0; n < numSamples; ++n)
+        {
+            double angle = juce::MathConstants<double>::twoPi * frequency * n / sampleRate;
+            double x = signal[static_cast<size_t>(n)];
+
+            sinSum += x * std::sin(angle);
+            cosSum += x * std::cos(angle);
+            totalPower += x * x;
+        }
+
+        double a = 2.0 * sinSum / numSamples;
+        double b = 2.0 * cosSum / numSamples;
+        double fundamentalPower = 0.5 * (a * a + b * b);
+        double residualPower = juce::jmax(1.0e-30, totalPower / numSamples - fundamentalPower);
+
+        return 10.0 * std::log10(residualPower / fundamentalPower);
+    }
+
+    // returns nanoseconds per sample
+    double render(MorphingOscillator::Interpolation mode, double frequency, std::vector<float>& output)
+    {
+        double bestSeconds = 1.0e9;
+
+        for (int run = 0; run < numRuns; ++run)
+        {
+            MorphingOscillator oscillator;
+            oscillator.prepare(static_cast<float>(sampleRate));
+            oscillator.setWaveformIndices(0, 0);
+            oscillator.setInterpolation(mode);
+            oscillator.setBaseTableDelta(frequency * MorphingOscillator::tableSize / sampleRate);
+
+            auto start = std::chrono::steady_clock::now();
+
+            for (int offset = 0; offset < numSamples; offset += blockSize)
+                oscillator.renderBlock(output.data() + offset, blockSize);
+
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            bestSeconds = juce::jmin(bestSeconds, elapsed.count());
+        }
+
+        return bestSeconds * 1.0e9 / numSamples;
+    }
+}
+
+void runInterpolationBenchmark()
+{
+    const std::pair<MorphingOscillator::Interpolation, const char*> modes[] = {
+        { MorphingOscillator::Interpolation::Linear,  "linear" },
+        { MorphingOscillator::Interpolation::Hermite, "hermite" },
+        { MorphingOscillator::Interpolation::Sinc,    "sinc" },
+    };
+
+    const double pitches[] = { 110.0, 880.0, 3520.0, 7040.0 };
+
+    std::vector<float> output(numSamples);
+
+    std::printf("%-8s %10s %12s %12s\n", "mode", "pitch Hz", "ns/sample", "THD+N dB");
+
+    for (const auto& [mode, modeName] : modes)
+    {
+        for (double pitch : pitches)
+        {
+            // round to a whole number of cycles over the analysis length
+            double frequency = std::round(pitch * numSamples / sampleRate) * sampleRate / numSamples;
+
+            double nanoseconds = render(mode, frequency, output);
+            double thd = measureThdPlusNoise(output, frequency);
+
+            std::printf("%-8s %10.1f %12.2f %12.1f\n", modeName, frequency, nanoseconds, thd);
+        }
+    }
+}
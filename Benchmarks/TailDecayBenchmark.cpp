@@ -0,0 +1,133 @@
+/*
+    TailDecayBenchmark.cpp
+
+    Measures what the release and effect tails cost once a chord has been let go, with
+    flush-to-zero off.
+
+    processBlock() sets flush-to-zero with ScopedNoDenormals, but nothing else that drives Synth
+    does (the tests, this benchmark, a host that restores the FPU flags between calls). Tails decay
+    exponentially, and a tail that goes denormal makes every sample it touches many times slower,
+    long after it has become inaudible. So the voices and effects flush their own state.
+
+    A chord goes through a resonant filter, the chorus, a 1/16 delay with feedback and the reverb,
+    and is released after half a second. The time per output sample is then printed for every
+    second of the tail, with flush-to-zero off and, for comparison, on (best of several runs).
+    As long as the state is denormal safe, the two columns stay level all the way down.
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "Benchmarks.h"
+#include "Cynthia_DSP/Synth.h"
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 256;
+    constexpr int heldSamples = 24000;
+    constexpr int tailSeconds = 30;
+    constexpr int numRuns = 3;
+
+    void preparePatch(Synth& synth)
+    {
+        synth.allocateResources(sampleRate, blockSize);
+        synth.numVoices = Synth::DEFAULT_VOICES;
+        synth.outputGain = 0.3f;
+
+        synth.setEnvAttack(0.01f);
+        synth.setEnvDecay(0.1f);
+        synth.setEnvSustain(0.8f);
+        synth.setEnvRelease(2.0f);
+
+        synth.setFilterType(0);
+        synth.setFilterCutoff(2000.0f);
+        synth.setFilterResonance(0.9f);
+
+        synth.setChorus(0.3f, 0.5f, 0.5f);
+        synth.setDelay(0.5f, 0.5f, 0);
+        synth.setReverb(0.3f, 0.8f, 0.5f);
+
+        synth.reset();
+    }
+
+    // returns nanoseconds per sample for every second after the chord is released
+    std::vector<double> renderTail()
+    {
+        Synth synth;
+        preparePatch(synth);
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        const uint8_t chord[] = { 48, 55, 60, 64 };
+
+        auto renderBlocks = [&](int numSamples)
+        {
+            for (int done = 0; done < numSamples; done += blockSize)
+            {
+                buffer.clear();
+                synth.render(buffer, blockSize, 0);
+            }
+        };
+
+        for (auto note : chord)
+            synth.midiMessage(0x90, note, 100);
+
+        renderBlocks(heldSamples);
+
+        for (auto note : chord)
+            synth.midiMessage(0x80, note, 0);
+
+        std::vector<double> nanoseconds;
+        int samplesPerSecond = static_cast<int>(sampleRate);
+
+        for (int second = 0; second < tailSeconds; ++second)
+        {
+            auto start = std::chrono::steady_clock::now();
+            renderBlocks(samplesPerSecond);
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+            nanoseconds.push_back(elapsed.count() * 1.0e9 / samplesPerSecond);
+        }
+
+        return nanoseconds;
+    }
+
+    std::vector<double> bestOfRuns(bool flushToZero)
+    {
+        // FloatVectorOperations sets (or clears) the FTZ/DAZ flags for this thread
+        juce::FloatVectorOperations::disableDenormalisedNumberSupport(flushToZero);
+
+        std::vector<double> best(tailSeconds, 1.0e9);
+
+        for (int run = 0; run < numRuns; ++run)
+        {
+            auto nanoseconds = renderTail();
+
+            for (size_t second = 0; second < best.size(); ++second)
+                best[second] = juce::jmin(best[second], nanoseconds[second]);
+        }
+
+        juce::FloatVectorOperations::disableDenormalisedNumberSupport(false);
+        return best;
+    }
+}
+
+void runTailDecayBenchmark()
+{
+    auto withoutFlush = bestOfRuns(false);
+    auto withFlush = bestOfRuns(true);
+
+    std::printf("%-8s %16s %16s %8s\n", "tail s", "FTZ off ns/smp", "FTZ on ns/smp", "ratio");
+
+    double worstRatio = 0.0;
+
+    for (size_t second = 0; second < withoutFlush.size(); ++second)
+    {
+        double ratio = withoutFlush[second] / withFlush[second];
+        worstRatio = juce::jmax(worstRatio, ratio);
+
+        std::printf("%-8d %16.2f %16.2f %8.2f\n", static_cast<int>(second), withoutFlush[second], withFlush[second], ratio);
+    }
+
+    std::printf("worst ratio %.2f (close to 1 means the tails never went denormal)\n", worstRatio);
+}
@@ -0,0 +1,76 @@
+/*
+    DelayLine.h
+
+    A mono delay line for the effects (see Effects.h).
+
+    The buffer is allocated once in prepare(), rounded up to a power of two so the read and
+    write positions wrap with a mask, and freed in release(). In between, writing and reading
+    never allocate, so it is safe on the audio thread. Reads can fall between samples (linear interpolation), which
+    the chorus needs for its sweeping delay times.
+*/
+
+#pragma once
+
+#include <vector>
+#include <juce_core/juce_core.h>
+
+class DelayLine
+{
+public:
+
+    // make room for delays of up to maxDelaySamples. Allocates, so not on the audio thread
+    void prepare(int maxDelaySamples)
+    {
+        int size = juce::nextPowerOfTwo(juce::jmax(4, maxDelaySamples + 2));
+        buffer.assign(static_cast<size_t>(size), 0.0f);
+        mask = size - 1;
+        writePosition = 0;
+    }
+
+    void reset()
+    {
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+        writePosition = 0;
+    }
+
+    // free the buffer. prepare() must be called again before the next write or read
+    void release()
+    {
+        buffer.clear();
+        buffer.shrink_to_fit();
+        mask = 0;
+        writePosition = 0;
+    }
+
+    // the longest delay read() can give
+    int getMaxDelay() const
+    {
+        return juce::jmax(0, mask - 1);
+    }
+
+    void write(float sample)
+    {
+        buffer[static_cast<size_t>(writePosition)] = sample;
+        writePosition = (writePosition + 1) & mask;
+    }
+
+    // the sample written delaySamples writes ago (1 is the last one written).
+    // fractional delays are linearly interpolated
+    float read(float delaySamples) const
+    {
+        delaySamples = juce::jlimit(1.0f, static_cast<float>(getMaxDelay()), delaySamples);
+
+        int whole = static_cast<int>(delaySamples);
+        float frac = delaySamples - static_cast<float>(whole);
+
+        float newer = buffer[static_cast<size_t>((writePosition - whole) & mask)];
+        float older = buffer[static_cast<size_t>((writePosition - whole - 1) & mask)];
+
+        return newer + frac * (older - newer);
+    }
+
+private:
+    std::vector<float> buffer;
+    int mask = 0;
+    int writePosition = 0;
+};
@@ -0,0 +1,352 @@
+/*
+    Effects.h
+
+    The effects the voice mix goes through on its way out, in this order:
+
+        ChorusEffect   two delay lines swept by a quadrature LFO, one per side
+        DelayEffect    a ping-pong delay, timed in beats so it follows the host's tempo
+        ReverbEffect   algorithmic reverb (internally JUCE's Freeverb-style Reverb)
+
+    EffectsChain owns them and runs them over a stereo block. Every effect is off while its
+    mix is 0, and an effect that's off isn't run at all, so a patch without effects costs
+    one check per block. An effect that's switched back on starts from silence rather than
+    playing what was left in its delay lines.
+
+    All the memory (the delay lines, the reverb's comb and all-pass filters) is allocated in
+    prepare(), which Synth calls from allocateResources(), and freed in release(), which it
+    calls from deallocateResources().
+
+    The tails mustn't decay into denormals, even when nobody has switched on flush-to-zero
+    (ScopedNoDenormals only covers processBlock()). The delay flushes its feedback to 0 once it's
+    inaudible, juce::Reverb undenormalises its own filters, and the chorus has no feedback.
+*/
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <memory>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "Cynthia_DSP/DelayLine.h"
+
+class ChorusEffect
+{
+public:
+
+    void prepare(float newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        int maxDelay = static_cast<int>(std::ceil((baseDelaySeconds + maxSweepSeconds) * sampleRate)) + 1;
+        left.prepare(maxDelay);
+        right.prepare(maxDelay);
+        setParameters(mix, rate, depth);
+        reset();
+    }
+
+    void release()
+    {
+        left.release();
+        right.release();
+    }
+
+    void reset()
+    {
+        left.reset();
+        right.reset();
+        lfoSin = 0.0f;
+        lfoCos = 1.0f;
+        samplesUntilNormalise = normaliseInterval;
+    }
+
+    // mix 0 to 1 (0.5 is the classic chorus, 1 is all wet, i.e. vibrato), rate in Hz, depth 0 to 1
+    void setParameters(float newMix, float newRate, float newDepth)
+    {
+        mix = newMix;
+        rate = newRate;
+        depth = newDepth;
+
+        float angle = juce::MathConstants<float>::twoPi * rate / sampleRate;
+        rotationSin = std::sin(angle);
+        rotationCos = std::cos(angle);
+    }
+
+    bool isOn() const
+    {
+        return mix > 0.0f;
+    }
+
+    void process(float* leftSamples, float* rightSamples, int numSamples)
+    {
+        float baseDelay = baseDelaySeconds * sampleRate;
+        float sweep = 0.5f * depth * maxSweepSeconds * sampleRate;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // the left side follows the sine and the right the cosine, a quarter cycle apart
+            float delayLeft = baseDelay + sweep * (1.0f + lfoSin);
+            float delayRight = baseDelay + sweep * (1.0f + lfoCos);
+
+            left.write(leftSamples[i]);
+            right.write(rightSamples[i]);
+
+            float wetLeft = left.read(delayLeft);
+            float wetRight = right.read(delayRight);
+
+            leftSamples[i] += mix * (wetLeft - leftSamples[i]);
+            rightSamples[i] += mix * (wetRight - rightSamples[i]);
+
+            // step the LFO by rotating it, rather than calling sin() and cos() every sample
+            float nextSin = lfoSin * rotationCos + lfoCos * rotationSin;
+            lfoCos = lfoCos * rotationCos - lfoSin * rotationSin;
+            lfoSin = nextSin;
+
+            // rounding makes the rotation drift in amplitude over time, so pull it back now and then.
+            // on a fixed count rather than once per block, so the output doesn't depend on the block size
+            if (--samplesUntilNormalise == 0)
+            {
+                float magnitude = std::sqrt(lfoSin * lfoSin + lfoCos * lfoCos);
+                lfoSin /= magnitude;
+                lfoCos /= magnitude;
+                samplesUntilNormalise = normaliseInterval;
+            }
+        }
+    }
+
+private:
+    static constexpr float baseDelaySeconds = 0.007f;
+    static constexpr float maxSweepSeconds = 0.012f;
+    static constexpr int normaliseInterval = 256;
+
+    DelayLine left, right;
+    float sampleRate = 44100.0f;
+    float mix = 0.0f, rate = 0.5f, depth = 0.5f;
+    float lfoSin = 0.0f, lfoCos = 1.0f;
+    float rotationSin = 0.0f, rotationCos = 1.0f;
+    int samplesUntilNormalise = normaliseInterval;
+};
+
+class DelayEffect
+{
+public:
+
+    // the choices of the delay time parameter, in beats
+    static constexpr std::array<float, 7> noteValueBeats { 0.25f, 0.5f, 0.75f, 1.0f, 1.5f, 2.0f, 4.0f };
+    static constexpr float maxDelaySeconds = 4.0f;
+
+    void prepare(float newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        int maxDelay = static_cast<int>(std::ceil(maxDelaySeconds * sampleRate));
+        left.prepare(maxDelay);
+        right.prepare(maxDelay);
+        updateDelayTime();
+        reset();
+    }
+
+    void release()
+    {
+        left.release();
+        right.release();
+    }
+
+    void reset()
+    {
+        left.reset();
+        right.reset();
+    }
+
+    // mix is the level of the echoes (the dry signal is always kept), feedback 0 to below 1
+    void setParameters(float newMix, float newFeedback, int noteValueIndex)
+    {
+        mix = newMix;
+        feedback = newFeedback;
+        beats = noteValueBeats[static_cast<size_t>(juce::jlimit(0, static_cast<int>(noteValueBeats.size()) - 1, noteValueIndex))];
+        updateDelayTime();
+    }
+
+    void setTempo(double newBpm)
+    {
+        if (newBpm <= 0.0 || newBpm == bpm)
+            return;
+
+        bpm = newBpm;
+        updateDelayTime();
+    }
+
+    bool isOn() const
+    {
+        return mix > 0.0f;
+    }
+
+    void process(float* leftSamples, float* rightSamples, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float echoLeft = left.read(delaySamples);
+            float echoRight = right.read(delaySamples);
+
+            // the input only goes in on the left, and each side feeds the other,
+            // so the echoes bounce from side to side
+            left.write(flushToZero(0.5f * (leftSamples[i] + rightSamples[i]) + feedback * echoRight));
+            right.write(flushToZero(feedback * echoLeft));
+
+            leftSamples[i] += mix * echoLeft;
+            rightSamples[i] += mix * echoRight;
+        }
+    }
+
+private:
+    // the echoes shrink by the feedback every time round, and without this they'd end up as
+    // denormals that keep circulating. -300 dB is far below anything audible
+    static float flushToZero(float sample)
+    {
+        constexpr float threshold = 1.0e-15f;
+        return std::abs(sample) < threshold ? 0.0f : sample;
+    }
+
+    void updateDelayTime()
+    {
+        float seconds = static_cast<float>(beats * 60.0 / bpm);
+        delaySamples = juce::jlimit(1.0f, maxDelaySeconds * sampleRate, seconds * sampleRate);
+    }
+
+    DelayLine left, right;
+    float sampleRate = 44100.0f;
+    double bpm = 120.0;
+    float beats = 0.5f;
+    float delaySamples = 1.0f;
+    float mix = 0.0f, feedback = 0.4f;
+};
+
+class ReverbEffect
+{
+public:
+
+    // juce::Reverb allocates its filters as soon as it's constructed, so it only exists while prepared
+    void prepare(float newSampleRate)
+    {
+        sampleRate = newSampleRate;
+
+        if (reverb == nullptr)
+            reverb = std::make_unique<juce::Reverb>();
+
+        reverb->setParameters(parameters);
+        reset();
+    }
+
+    void release()
+    {
+        reverb.reset();
+    }
+
+    // setSampleRate() rather than Reverb::reset(), which only clears the filters. At the same rate
+    // nothing is reallocated, and the parameter smoothing also jumps to its targets, so a reset
+    // reverb always starts out the same way
+    void reset()
+    {
+        if (reverb != nullptr)
+            reverb->setSampleRate(sampleRate);
+    }
+
+    // mix 0 to 1 crossfades dry into wet, size and damping 0 to 1
+    void setParameters(float newMix, float size, float damping)
+    {
+        mix = newMix;
+
+        parameters.roomSize = size;
+        parameters.damping = damping;
+        parameters.wetLevel = mix;
+        parameters.dryLevel = 1.0f - mix;
+        parameters.width = 1.0f;
+
+        if (reverb != nullptr)
+            reverb->setParameters(parameters);
+    }
+
+    bool isOn() const
+    {
+        return mix > 0.0f;
+    }
+
+    void process(float* leftSamples, float* rightSamples, int numSamples)
+    {
+        jassert(reverb != nullptr);
+        reverb->processStereo(leftSamples, rightSamples, numSamples);
+    }
+
+private:
+    std::unique_ptr<juce::Reverb> reverb;
+    juce::Reverb::Parameters parameters;
+    float sampleRate = 44100.0f;
+    float mix = 0.0f;
+};
+
+class EffectsChain
+{
+public:
+
+    void prepare(float sampleRate)
+    {
+        chorus.prepare(sampleRate);
+        delay.prepare(sampleRate);
+        reverb.prepare(sampleRate);
+    }
+
+    void release()
+    {
+        chorus.release();
+        delay.release();
+        reverb.release();
+        skip();
+    }
+
+    void reset()
+    {
+        chorus.reset();
+        delay.reset();
+        reverb.reset();
+    }
+
+    // true when at least one effect is on. When it isn't, process() needn't be called
+    bool isOn() const
+    {
+        return chorus.isOn() || delay.isOn() || reverb.isOn();
+    }
+
+    // call instead of process() for a block where isOn() is false, so an effect that's
+    // switched on later knows it was off
+    void skip()
+    {
+        chorusWasOn = delayWasOn = reverbWasOn = false;
+    }
+
+    // run the effects that are on over a stereo block, in place
+    void process(float* left, float* right, int numSamples)
+    {
+        processIfOn(chorus, chorusWasOn, left, right, numSamples);
+        processIfOn(delay, delayWasOn, left, right, numSamples);
+        processIfOn(reverb, reverbWasOn, left, right, numSamples);
+    }
+
+    ChorusEffect chorus;
+    DelayEffect delay;
+    ReverbEffect reverb;
+
+private:
+    template <typename Effect>
+    static void processIfOn(Effect& effect, bool& wasOn, float* left, float* right, int numSamples)
+    {
+        bool on = effect.isOn();
+
+        // coming back on: clear out what was left over from last time
+        if (on && ! wasOn)
+            effect.reset();
+
+        wasOn = on;
+
+        if (on)
+            effect.process(left, right, numSamples);
+    }
+
+    bool chorusWasOn = false, delayWasOn = false, reverbWasOn = false;
+};
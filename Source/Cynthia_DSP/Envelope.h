@@ -16,16 +16,25 @@ public:
 
     void prepare(float sampleRate)
     {
+        this->sampleRate = sampleRate;
         adsr.setSampleRate(sampleRate);
     }
 
     void reset()
     {
         adsr.reset();
+        released = false;
+        samplesInStage = 0;
     }
 
     void setParameters(float attack, float decay, float sustain, float release)
     {
+        // ADSR recalculates its rates on every call, which is wasted work at note on
+        // when nothing has changed since the last note
+        if (params.attack == attack && params.decay == decay
+            && params.sustain == sustain && params.release == release)
+            return;
+
         params.attack = attack;
         params.decay = decay;
         params.sustain = sustain;
@@ -57,26 +66,59 @@ public:
     void noteOn() 
     {
         adsr.noteOn();
+        released = false;
+        samplesInStage = 0;
     }
 
     void noteOff()
     {
         adsr.noteOff();
+        released = true;
+        samplesInStage = 0;
+    }
+
+    // true once the key has been let go (the envelope is in its release stage)
+    bool isReleased() const
+    {
+        return released;
+    }
+
+    // time since the note on, or since the note off once released. Only used for displays
+    float getSecondsInStage() const
+    {
+        return static_cast<float>(samplesInStage) / sampleRate;
     }
 
     float getNextSample()
     {
         currentLevel = adsr.getNextSample();
+        ++samplesInStage;
         return currentLevel;
     }
 
+    void renderBlock(float* output, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            output[i] = adsr.getNextSample();
+
+        if (numSamples > 0)
+            currentLevel = output[numSamples - 1];
+
+        samplesInStage += numSamples;
+    }
+
     bool isActive() const
     {
         return adsr.isActive();
     }
 
 private:
+    // ADSR ramps linearly and stops at exactly 0 (or the sustain level), so unlike an
+    // exponential release it never ends up in denormals
     juce::ADSR adsr;
     juce::ADSR::Parameters params;
-    float currentLevel;
+    float currentLevel = 0.0f;
+    float sampleRate = 44100.0f;
+    bool released = false;
+    juce::int64 samplesInStage = 0;
 };
\ No newline at end of file
@@ -52,7 +52,8 @@ public:
 
     void setCutoff(float cutoffHz) override
     {
-        filter.setCutoffFrequency(cutoffHz);
+        // modulation can push the cutoff past Nyquist, which the TPT filter doesn't allow
+        filter.setCutoffFrequency(juce::jlimit(1.0f, static_cast<float>(sampleRate * 0.49), cutoffHz));
     }
 
     void setResonance(float q) override
@@ -86,6 +87,17 @@ public:
         return filter.processSample(0, sample);
     }
 
+    // filter a mono block in place
+    void processBlock(float* samples, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            samples[i] = filter.processSample(0, samples[i]);
+
+        // with silence going in, the state decays towards denormals, which is slow
+        // when flush-to-zero isn't on. Once per block is enough to keep it out of them
+        filter.snapToZero();
+    }
+
 private:
 
     void updateFilterType()
@@ -28,11 +28,24 @@ public:
         resetPhase();
     }
 
+    // tempo sync: run at the rate TempoSync worked out, from the phase it says the song is at.
+    // unlike prepareLFO(), the phase isn't reset, so notes started at different times stay in step
+    void setSynced(double tableDelta, PhaseAccumulator::Phase phase)
+    {
+        setBaseTableDelta(tableDelta);
+        setPhase(phase);
+    }
+
     void setModDepth(float newDepthValue)
     {
         modDepth = juce::jlimit(0.0f, 1.0f, newDepthValue);
     }
 
+    float getModDepth() const
+    {
+        return modDepth;
+    }
+
     float getNextLFOSample()
     {
         return getNextSample() * modDepth;
@@ -8,20 +8,85 @@
     Key differences:
         Allows for morphing of two waveforms
         Supports detuning of each waveform
+        Scans through the frames of a multi-frame (user) wavetable
+
+    The oscillator has two layers, A and B, each with its own (detuned) phase.
+
+    With the factory table, layer A plays Wavetype A, layer B plays Wavetype B, and the
+    morph value crossfades between them (as it always has).
+
+    With a user wavetable, the morph value is the wavetable position instead: 0 is the first
+    frame, 1 the last one, and positions in between crossfade the two nearest frames.
+    Both layers play that position and are mixed equally, so detune thickens the sound.
+
+    Either way, the position can be modulated per sample (see renderBlock()).
+
+    The phases are 32-bit fixed point (see PhaseAccumulator.h), so they wrap without a branch
+    and render identically on every platform.
+
+    How samples are read between table points is selectable (see WavetableInterpolation.h).
+    The choice is made once per block, so the per-sample loop has no branch for it.
+
+    A block is rendered in two passes over chunks of up to maxChunkSize samples: first the
+    phases of both layers are written to phase buffers, then the tables are read at those
+    phases. Another oscillator can modulate this one through the phase pass alone (see
+    Modulation): phase modulation adds an offset to every read phase, and hard sync restarts
+    the phases wherever the other oscillator's phase wrapped. The read pass stays the same
+    straight loop either way.
 */
 
 #pragma once
 #include <juce_audio_basics/juce_audio_basics.h>
 #include "Cynthia_DSP/WaveformGenerator.h"
+#include "Cynthia_DSP/WavetableCache.h"
+#include "Cynthia_DSP/WavetableInterpolation.h"
 
 class MorphingOscillator
 {
 public:
 
     MorphingOscillator()
+        : factoryWavetable(&getFactoryWavetable())
+    {}
+
+    static constexpr int tableSize = Wavetable::tableSize; // number of samples per waveform
+    static constexpr int numFactoryWaveforms = 4;
+    static constexpr int maxChunkSize = 32; // samples per phase pass
+
+    // what another oscillator does to this one while rendering a block (see renderBlock())
+    struct Modulation
+    {
+        // per-sample phase offset in cycles (phase modulation, i.e. "FM"), or nullptr
+        const float* phaseOffset = nullptr;
+
+        // hard sync: restart the cycle wherever this oscillator's phase wraps, or nullptr.
+        // it must have rendered the same samples just before, in a block of at most maxChunkSize
+        const MorphingOscillator* syncSource = nullptr;
+    };
+
+    // the generated sine, saw, triangle and square as a 4 frame wavetable. Made the first time
+    // an oscillator is created and shared by every oscillator after that. Its mipmaps come
+    // from the wavetable cache, so they're only ever built once per machine
+    static const Wavetable& getFactoryWavetable()
     {
-        // initialize oscillator wavetable to be populated and ready to go with waveforms
-        generateWaveforms();
+        static const Wavetable::Ptr factoryTable = generateWaveforms();
+        return *factoryTable;
+    }
+
+    // set the sample rate ahead of playback
+    void prepare(float newSampleRate)
+    {
+        sampleRate = newSampleRate;
+    }
+
+    // set the pitch directly as a phase increment (wavetable samples per output sample).
+    // lets the caller precompute increments for a sample rate instead of dividing per note
+    void setBaseTableDelta(double newBaseTableDelta)
+    {
+        baseTableDelta = newBaseTableDelta;
+        baseFrequency = static_cast<float>(newBaseTableDelta * sampleRate / tableSize);
+
+        updateDetuneFactors();
     }
 
     // prepare wavetable based on a given frequency and sample rate.
@@ -37,24 +102,24 @@ public:
     // reset oscillator phase back to beginning of wavetable
     void reset()
     {
-        currentIndexA = 0.0;
-        currentIndexB = 0.0;
+        phaseA = 0;
+        phaseB = 0;
     }
 
-    // set the two waveforms to morph between
+    // set the two factory waveforms to morph between
     void setWaveformIndices(int newWaveformIndexA, int newWaveformIndexB)
     {
-        // waveformIndexA and waveformIndexB correspond to the channels of AudioBuffer
-        // being used as the wavetable. Each waveform gets its own channel.
-        // 0-3 maps to sine, saw, square, and triangle respectively
-        waveformIndexA = juce::jlimit(0, 3, newWaveformIndexA);
-        waveformIndexB = juce::jlimit(0, 3, newWaveformIndexB);
+        // the factory waveforms are frames of the factory wavetable.
+        // 0-3 maps to sine, saw, triangle, and square respectively
+        waveformIndexA = juce::jlimit(0, numFactoryWaveforms - 1, newWaveformIndexA);
+        waveformIndexB = juce::jlimit(0, numFactoryWaveforms - 1, newWaveformIndexB);
     }
     
     void setMorphValue(float newMorphValue)
     {
         // waveformA and waveformB share a single morph value.
-        // 0.0 means we hear only waveformA, 1.0 means we hear only waveformB
+        // 0.0 means we hear only waveformA, 1.0 means we hear only waveformB.
+        // with a user wavetable, this is the position across its frames
         morphValue = juce::jlimit(0.0f, 1.0f, newMorphValue);
     }
 
@@ -65,47 +130,209 @@ public:
         updateDetuneFactors();
     }
 
+    // bend the pitch relative to the frequency given to prepareWavetable().
+    // a ratio of 1.0 plays the prepared frequency (used for MPE pitch bend)
+    void setPitchRatio(float newPitchRatio)
+    {
+        pitchRatio = newPitchRatio;
+        updateDetuneFactors();
+    }
+
+    using Interpolation = WavetableInterpolation::Mode;
+
+    void setInterpolation(Interpolation newInterpolation)
+    {
+        interpolation = newInterpolation;
+    }
+
+    // play an imported wavetable instead of the generated waveforms. The table is owned elsewhere
+    // (see AudioThreadHandoff) and must stay alive while the oscillator points at it
+    void setUserWavetable(const Wavetable* newUserWavetable)
+    {
+        userWavetable = newUserWavetable;
+    }
+
+    // true plays the user wavetable (if one is loaded), false the generated waveforms
+    void setUseUserWavetable(bool shouldUseUserWavetable)
+    {
+        useUserWavetable = shouldUseUserWavetable;
+    }
+
+    // jump both layers to a phase (tempo sync, see TempoSync)
+    void setPhase(PhaseAccumulator::Phase newPhase)
+    {
+        phaseA = newPhase;
+        phaseB = newPhase;
+    }
+
+    // where layer A is in its cycle, 0 to 1. For displays
+    float getPhase() const
+    {
+        return static_cast<float>(phaseA * (1.0 / 4294967296.0));
+    }
+
     // generate next output sample from the oscillator
     // this function handles morphing between two waveforms and wraps the phase increment
     float getNextSample()
     {
-        float sampleA = getSampleFromWavetable(waveformIndexA, currentIndexA);
-        float sampleB = getSampleFromWavetable(waveformIndexB, currentIndexB);
+        float output = 0.0f;
+        renderBlock(&output, 1);
+        return output;
+    }
 
-        // take a sample from waveformA, and waveformB and morph them together
-        // if morphValue = 0.0, we only hear waveformA
-        // if morphValue = 1.0, we only hear waveformB
-        float output = ((1.0f-morphValue) * sampleA) + (morphValue * sampleB);
+    // fill a block with the next numSamples output samples.
+    // positionModulation (optional) holds a per-sample offset added to the morph value / position,
+    // modulation what another oscillator does to this one
+    void renderBlock(float* output, int numSamples, const float* positionModulation = nullptr,
+                     const Modulation& modulation = {})
+    {
+        // sync compares against the source's phase buffer, which only holds its last chunk
+        jassert(modulation.syncSource == nullptr || numSamples <= maxChunkSize);
+
+        for (int start = 0; start < numSamples; start += maxChunkSize)
+        {
+            int chunkSize = juce::jmin(maxChunkSize, numSamples - start);
+            const float* chunkPosition = positionModulation != nullptr ? positionModulation + start : nullptr;
+            const float* chunkOffset = modulation.phaseOffset != nullptr ? modulation.phaseOffset + start : nullptr;
 
-        // increment phase idices and wrap around table size
-        if ((currentIndexA += tableDeltaA) >= (float) tableSize)
-            currentIndexA -= (float) tableSize;
+            fillPhases(chunkSize, modulation.syncSource);
+            addPhaseOffsets(chunkSize, chunkOffset);
 
-        if ((currentIndexB += tableDeltaB) >= (float) tableSize)
-            currentIndexB -= (float) tableSize;
-        
-        return output;
+            switch (interpolation)
+            {
+                case Interpolation::Linear:  readPhases<Interpolation::Linear>(output + start, chunkSize, chunkPosition); break;
+                case Interpolation::Hermite: readPhases<Interpolation::Hermite>(output + start, chunkSize, chunkPosition); break;
+                case Interpolation::Sinc:    readPhases<Interpolation::Sinc>(output + start, chunkSize, chunkPosition); break;
+            }
+        }
     }
 
 protected:
 
-    // generate default waveforms and populate wavetable
+    // phase pass: where each layer is for every sample of the chunk, then step past the chunk
+    void fillPhases(int numSamples, const MorphingOscillator* syncSource)
+    {
+        if (syncSource == nullptr)
+        {
+            // no dependency between samples, so this vectorises
+            for (int i = 0; i < numSamples; ++i)
+            {
+                phasesA[static_cast<size_t>(i)] = phaseA + static_cast<PhaseAccumulator::Phase>(i) * phaseIncrementA;
+                phasesB[static_cast<size_t>(i)] = phaseB + static_cast<PhaseAccumulator::Phase>(i) * phaseIncrementB;
+            }
+
+            phaseA += static_cast<PhaseAccumulator::Phase>(numSamples) * phaseIncrementA;
+            phaseB += static_cast<PhaseAccumulator::Phase>(numSamples) * phaseIncrementB;
+            return;
+        }
+
+        // the source wrapped between the previous sample and this one when its phase is below
+        // its increment. Its phase is then how far into the new cycle it is, which scaled by the
+        // ratio of the increments is how far into our new cycle we should be
+        PhaseAccumulator::Phase sourceIncrement = juce::jmax<PhaseAccumulator::Phase>(1, syncSource->phaseIncrementA);
+        double ratioA = static_cast<double>(phaseIncrementA) / sourceIncrement;
+        double ratioB = static_cast<double>(phaseIncrementB) / sourceIncrement;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            PhaseAccumulator::Phase sourcePhase = syncSource->phasesA[static_cast<size_t>(i)];
+
+            if (sourcePhase < sourceIncrement)
+            {
+                phaseA = static_cast<PhaseAccumulator::Phase>(sourcePhase * ratioA);
+                phaseB = static_cast<PhaseAccumulator::Phase>(sourcePhase * ratioB);
+            }
+
+            phasesA[static_cast<size_t>(i)] = phaseA;
+            phasesB[static_cast<size_t>(i)] = phaseB;
+            phaseA += phaseIncrementA;
+            phaseB += phaseIncrementB;
+        }
+    }
+
+    // phase modulation only moves where the tables are read, so the cycle (and sync) keeps its
+    // own pitch. readPhasesA/B are what the read pass uses
+    void addPhaseOffsets(int numSamples, const float* phaseOffset)
+    {
+        if (phaseOffset == nullptr)
+        {
+            std::copy(phasesA.begin(), phasesA.begin() + numSamples, readPhasesA.begin());
+            std::copy(phasesB.begin(), phasesB.begin() + numSamples, readPhasesB.begin());
+            return;
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            PhaseAccumulator::Phase offset = PhaseAccumulator::fromCycles(phaseOffset[i]);
+            readPhasesA[static_cast<size_t>(i)] = phasesA[static_cast<size_t>(i)] + offset;
+            readPhasesB[static_cast<size_t>(i)] = phasesB[static_cast<size_t>(i)] + offset;
+        }
+    }
+
+    // read pass: the table lookups at the phases worked out above
+    template <Interpolation mode>
+    void readPhases(float* output, int numSamples, const float* positionModulation)
+    {
+        if (isScanningUserWavetable())
+        {
+            for (int i = 0; i < numSamples; ++i)
+                output[i] = getScannedSample<mode>(*userWavetable, getPosition(positionModulation, i), i);
+        }
+        else if (positionModulation == nullptr && morphValue == 0.0f)
+        {
+            // only Wavetype A can be heard, so layer B isn't read at all
+            const float* table = factoryWavetable->getTable(waveformIndexA, mipLevelA);
+
+            for (int i = 0; i < numSamples; ++i)
+                output[i] = WavetableInterpolation::read<mode>(table, readPhasesA[static_cast<size_t>(i)]);
+        }
+        else
+        {
+            for (int i = 0; i < numSamples; ++i)
+                output[i] = getMorphedSample<mode>(getPosition(positionModulation, i), i);
+        }
+    }
+
+    float getPosition(const float* positionModulation, int sample) const
+    {
+        if (positionModulation == nullptr)
+            return morphValue;
+
+        return juce::jlimit(0.0f, 1.0f, morphValue + positionModulation[sample]);
+    }
+
+    bool isScanningUserWavetable() const
+    {
+        return useUserWavetable && userWavetable != nullptr;
+    }
+
+    // generate default waveforms, and return them as one band-limited wavetable
     // uses WaveformGenerator interface for each waveform type
-    void generateWaveforms()
+    static Wavetable::Ptr generateWaveforms()
     {
+        juce::AudioBuffer<float> waveforms(numFactoryWaveforms, tableSize);
+
         // using unique_ptr to automatically manage memory allocated for generators
-        // each generator fills one channel of the wavetable
-        std::unique_ptr<WaveformGenerator> waveformGenerators[4] = {
+        // each generator fills one channel of the buffer
+        std::unique_ptr<WaveformGenerator> waveformGenerators[numFactoryWaveforms] = {
             std::make_unique<SineGenerator>(),
             std::make_unique<SawtoothGenerator>(),
             std::make_unique<TriangleGenerator>(),
             std::make_unique<SquareGenerator>()
         };
 
-        for(int waveGenIndex = 0; waveGenIndex < 4; ++waveGenIndex)
+        // Wavetable::build() wants the frames one after another
+        std::vector<float> frames(numFactoryWaveforms * tableSize);
+
+        for(int waveGenIndex = 0; waveGenIndex < numFactoryWaveforms; ++waveGenIndex)
         {
-            waveformGenerators[waveGenIndex]->fillWavetable(wavetable, waveGenIndex);
+            waveformGenerators[waveGenIndex]->fillWavetable(waveforms, waveGenIndex);
+            std::copy(waveforms.getReadPointer(waveGenIndex),
+                      waveforms.getReadPointer(waveGenIndex) + tableSize,
+                      frames.begin() + waveGenIndex * tableSize);
         }
+
+        return WavetableCache::getOrBuild(frames.data(), numFactoryWaveforms, "Factory");
     }
 
     // update phase increments for detuning between waveformA and B.
@@ -128,43 +355,78 @@ protected:
         float detuneFactorB = std::pow(2.0f, detuneB/1200.0f);
 
         // now apply the detuned frequency ratios to the base phase increment for each wavetable
-        tableDeltaA = baseTableDelta * detuneFactorA;
-        tableDeltaB = baseTableDelta * detuneFactorB;
+        double tableDeltaA = baseTableDelta * pitchRatio * detuneFactorA;
+        double tableDeltaB = baseTableDelta * pitchRatio * detuneFactorB;
+
+        phaseIncrementA = PhaseAccumulator::fromTableDelta(tableDeltaA);
+        phaseIncrementB = PhaseAccumulator::fromTableDelta(tableDeltaB);
+
+        // the mipmap that keeps each phase below Nyquist
+        mipLevelA = Wavetable::getMipLevel(tableDeltaA);
+        mipLevelB = Wavetable::getMipLevel(tableDeltaB);
+    }
+
+    // factory table: crossfade Wavetype A (layer A) into Wavetype B (layer B)
+    template <Interpolation mode>
+    float getMorphedSample(float morph, int sample) const
+    {
+        float sampleA = WavetableInterpolation::read<mode>(factoryWavetable->getTable(waveformIndexA, mipLevelA), readPhasesA[static_cast<size_t>(sample)]);
+        float sampleB = WavetableInterpolation::read<mode>(factoryWavetable->getTable(waveformIndexB, mipLevelB), readPhasesB[static_cast<size_t>(sample)]);
+
+        // take a sample from waveformA, and waveformB and morph them together
+        // if morphValue = 0.0, we only hear waveformA
+        // if morphValue = 1.0, we only hear waveformB
+        return ((1.0f - morph) * sampleA) + (morph * sampleB);
     }
 
-    // returns a single sample from the specified wavetable using linear interpolation
-    float getSampleFromWavetable(int wavetableIndex, int currentIndex)
+    // user table: both layers play the two frames around the position, crossfaded
+    template <Interpolation mode>
+    float getScannedSample(const Wavetable& table, float position, int sample) const
     {
-        auto *table = wavetable.getReadPointer(wavetableIndex);
+        PhaseAccumulator::Phase phaseA = readPhasesA[static_cast<size_t>(sample)];
+        PhaseAccumulator::Phase phaseB = readPhasesB[static_cast<size_t>(sample)];
 
-        int index0 = static_cast<int>(currentIndex);
-        // correctly wraps the wavetable 
-        int index1 = (index0+1) % tableSize;
+        int lastFrame = table.getNumFrames() - 1;
+        float framePosition = position * static_cast<float>(lastFrame);
 
-        float frac = static_cast<float>(currentIndex - (float) index0);
+        int frame = juce::jmin(static_cast<int>(framePosition), juce::jmax(0, lastFrame - 1));
+        int nextFrame = juce::jmin(frame + 1, lastFrame);
+        float frameFrac = framePosition - static_cast<float>(frame);
 
-        auto value0 = table[index0];
-        auto value1 = table[index1];
+        float sampleA = WavetableInterpolation::read<mode>(table.getTable(frame, mipLevelA), phaseA);
+        float nextSampleA = WavetableInterpolation::read<mode>(table.getTable(nextFrame, mipLevelA), phaseA);
+        float sampleB = WavetableInterpolation::read<mode>(table.getTable(frame, mipLevelB), phaseB);
+        float nextSampleB = WavetableInterpolation::read<mode>(table.getTable(nextFrame, mipLevelB), phaseB);
 
-        // linear interpolation
-        auto currentSample = value0 + frac * (value1 - value0);
+        float layerA = sampleA + frameFrac * (nextSampleA - sampleA);
+        float layerB = sampleB + frameFrac * (nextSampleB - sampleB);
 
-        return currentSample;
+        return 0.5f * (layerA + layerB);
     }
 
-    static constexpr int tableSize = 2048; // number of samples per waveform
-    juce::AudioBuffer<float> wavetable {4, tableSize}; // can hold 4 waveforms
+    const Wavetable* factoryWavetable;
+    const Wavetable* userWavetable = nullptr;
+    bool useUserWavetable = false;
+    Interpolation interpolation = Interpolation::Linear;
+
+    PhaseAccumulator::Phase phaseA = 0; // fixed-point phase waveformA
+    PhaseAccumulator::Phase phaseB = 0; // fixed-point phase waveformB
+    PhaseAccumulator::Phase phaseIncrementA = 0; // phase increment waveformA
+    PhaseAccumulator::Phase phaseIncrementB = 0; // phase increment waveformB
 
-    double currentIndexA = 0.0; // phase index waveformA
-    double currentIndexB = 0.0; // phase index waveformB
-    double tableDeltaA = 0.0; // phase increment waveformA
-    double tableDeltaB = 0.0; // phase increment waveformB
+    // the current chunk, from the phase pass. phasesA/B are the accumulator (what sync follows),
+    // readPhasesA/B the same with any phase modulation added
+    std::array<PhaseAccumulator::Phase, maxChunkSize> phasesA {}, phasesB {};
+    std::array<PhaseAccumulator::Phase, maxChunkSize> readPhasesA {}, readPhasesB {};
     double baseTableDelta = 0.0;
     float baseFrequency = 440.0f; // based on A = 440 Hz (standard concert tuning)
     float sampleRate = 44100.0f;
 
-    int waveformIndexA = 0; // use to specify which wavetable channel we're on (default: sine)
-    int waveformIndexB = 1;  // use to specify which wavetable channel we're on (default: sawtooth)
+    int waveformIndexA = 0; // use to specify which factory frame we're on (default: sine)
+    int waveformIndexB = 1;  // use to specify which factory frame we're on (default: sawtooth)
+    int mipLevelA = 0;
+    int mipLevelB = 0;
     float morphValue = 0.0f;
     float detuneCents = 0.0f;   
+    float pitchRatio = 1.0f;
 };
@@ -1,34 +1,187 @@
 /*
     NoiseGenerator.h
 
-    Currently not used anywhere in this project.
+    A per-voice noise source, mixed in with the oscillator before the filter.
 
-    Source: "Creating Synthesizer Plug-ins with C++ and JUCE" by Matthijs Hollemans
+    Three colours:
+        White     flat spectrum
+        Pink      -3 dB per octave (Paul Kellett's economy filter over the white noise)
+        Filtered  a resonant band-pass around the note's pitch, for breathy or pitched noise
+
+    The random numbers come from numLanes independent xorshift32 generators that step
+    together, so a block is generated numLanes samples at a time with no dependency between
+    the lanes. The lane loop is plain integer shifts and xors over an array, which compilers
+    turn into SIMD. Compare the old LCG, where every sample waited on the previous one.
+
+    Samples left over from a lane step are kept for the next call, so the output is the same
+    stream however the caller splits its blocks.
 */
 
 #pragma once
 
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <juce_core/juce_core.h>
+
 class NoiseGenerator
 {
     public:
 
+        enum class Type
+        {
+            White,
+            Pink,
+            Filtered
+        };
+
+        static constexpr int numLanes = 8;
+
+        NoiseGenerator()
+        {
+            setSeed(0);
+        }
+
+        // voices use different seeds, so their noise isn't correlated
+        void setSeed(uint32_t newSeed)
+        {
+            seed = newSeed;
+            reset();
+        }
+
+        // back to the start of the seed's sequence, with the colour filters cleared
         void reset()
         {
-            noiseSeed = 22222;
+            // splitmix32 spreads one seed over the lanes. xorshift must never start at 0
+            uint32_t state = seed * 0x9E3779B9u + 0x7F4A7C15u;
+
+            for (auto &lane : lanes)
+            {
+                state += 0x9E3779B9u;
+                uint32_t z = state;
+                z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+                z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+                z ^= z >> 16;
+                lane = z != 0 ? z : 0x6D2B79F5u;
+            }
+
+            numCarried = 0;
+            pink0 = pink1 = pink2 = 0.0f;
+            band = low = 0.0f;
         }
 
-        float nextValue()
+        void setType(Type newType)
         {
-            // Generate the next integer pseudorandom number
-            noiseSeed = noiseSeed * 196314165 + 907633515;
+            type = newType;
+        }
 
-            // Convert to a signed value
-            int temp = int(noiseSeed >> 7) - 16777216;
+        // centre of the Filtered band-pass
+        void setFrequency(float frequency, float sampleRate)
+        {
+            float limited = juce::jlimit(20.0f, 0.45f * sampleRate, frequency);
+            bandCoefficient = std::tan(juce::MathConstants<float>::pi * limited / sampleRate);
+        }
 
-            // Convert to a floating-point number between -1.0 and 1.0
-            return float(temp) / 16777216.0f;
+        // fill output with the next numSamples samples, roughly -1 to 1
+        void renderBlock(float *output, int numSamples)
+        {
+            renderWhite(output, numSamples);
+
+            switch (type)
+            {
+                case Type::White:    break;
+                case Type::Pink:     colourPink(output, numSamples); break;
+                case Type::Filtered: colourFiltered(output, numSamples); break;
+            }
         }
 
     private:
-        unsigned int noiseSeed;
-};
\ No newline at end of file
+
+        // one step of every lane: numLanes new samples
+        void stepLanes(float *destination)
+        {
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                uint32_t state = lanes[static_cast<size_t>(lane)];
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                lanes[static_cast<size_t>(lane)] = state;
+
+                // reinterpret as signed and scale to -1..1
+                destination[lane] = static_cast<float>(static_cast<int32_t>(state)) * (1.0f / 2147483648.0f);
+            }
+        }
+
+        void renderWhite(float *output, int numSamples)
+        {
+            int sample = 0;
+
+            // what's left of the previous step comes first
+            while (sample < numSamples && numCarried > 0)
+                output[sample++] = carried[static_cast<size_t>(numLanes - numCarried--)];
+
+            while (numSamples - sample >= numLanes)
+            {
+                stepLanes(output + sample);
+                sample += numLanes;
+            }
+
+            if (sample < numSamples)
+            {
+                stepLanes(carried.data());
+                numCarried = numLanes;
+
+                while (sample < numSamples)
+                    output[sample++] = carried[static_cast<size_t>(numLanes - numCarried--)];
+            }
+        }
+
+        void colourPink(float *buffer, int numSamples)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                float white = buffer[i];
+                pink0 = 0.99765f * pink0 + white * 0.0990460f;
+                pink1 = 0.96300f * pink1 + white * 0.2965164f;
+                pink2 = 0.57000f * pink2 + white * 1.0526913f;
+
+                // roughly the same loudness as the white noise
+                buffer[i] = 0.25f * (pink0 + pink1 + pink2 + white * 0.1848f);
+            }
+        }
+
+        // state variable band-pass (Q = 4), with makeup gain for the energy it removes
+        void colourFiltered(float *buffer, int numSamples)
+        {
+            constexpr float damping = 0.25f; // 1 / Q
+            constexpr float makeupGain = 4.0f;
+
+            float g = bandCoefficient;
+            float a1 = 1.0f / (1.0f + g * (g + damping));
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                float high = (buffer[i] - (damping + g) * band - low) * a1;
+                float bandOut = g * high + band;
+                float lowOut = g * bandOut + low;
+
+                band = g * high + bandOut;
+                low = g * bandOut + lowOut;
+
+                buffer[i] = makeupGain * damping * bandOut;
+            }
+        }
+
+        uint32_t seed = 0;
+        std::array<uint32_t, numLanes> lanes {};
+        std::array<float, numLanes> carried {};
+        int numCarried = 0;
+
+        Type type = Type::White;
+
+        float pink0 = 0.0f, pink1 = 0.0f, pink2 = 0.0f;
+
+        float bandCoefficient = 0.1f;
+        float band = 0.0f, low = 0.0f;
+};
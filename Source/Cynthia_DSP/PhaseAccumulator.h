@@ -0,0 +1,62 @@
+/*
+    PhaseAccumulator.h
+
+    32-bit fixed-point phase for wavetable oscillators.
+
+    One full cycle of the table is 2^32, so the phase wraps by plain unsigned overflow:
+    no compare and subtract, and no branch. The top 11 bits are the table index and the
+    low 21 bits the fraction between two table points.
+
+    The increment is rounded to an integer once, when the pitch changes. After that every
+    step is integer addition, so a note renders bit for bit the same on every platform and
+    compiler, however long it plays.
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include "Cynthia_DSP/Wavetable.h"
+
+namespace PhaseAccumulator
+{
+    using Phase = uint32_t;
+
+    constexpr int indexBits = 11;
+    constexpr int fractionBits = 32 - indexBits;
+    constexpr Phase fractionMask = (Phase(1) << fractionBits) - 1;
+    constexpr double phasePerTableSample = static_cast<double>(Phase(1) << fractionBits);
+
+    static_assert((1 << indexBits) == Wavetable::tableSize, "the index bits must address exactly one table");
+
+    // convert an increment in table samples per output sample to a fixed-point increment.
+    // anything at or above a whole table per sample is held just below it
+    inline Phase fromTableDelta(double tableDelta) noexcept
+    {
+        double increment = std::round(tableDelta * phasePerTableSample);
+        return static_cast<Phase>(juce::jlimit(0.0, 4294967295.0, increment));
+    }
+
+    // a phase offset given in cycles, e.g. for phase modulation. Any number of cycles,
+    // negative too, wraps to the right place
+    inline Phase fromCycles(float cycles) noexcept
+    {
+        return static_cast<Phase>(static_cast<int64_t>(cycles * 4294967296.0f));
+    }
+
+    inline Phase fromCycles(double cycles) noexcept
+    {
+        return static_cast<Phase>(static_cast<int64_t>(cycles * 4294967296.0));
+    }
+
+    inline int getIndex(Phase phase) noexcept
+    {
+        return static_cast<int>(phase >> fractionBits);
+    }
+
+    // exact: 21 bits fit in a float's mantissa
+    inline float getFraction(Phase phase) noexcept
+    {
+        return static_cast<float>(phase & fractionMask) * static_cast<float>(1.0 / phasePerTableSample);
+    }
+}
@@ -9,16 +9,51 @@
 Synth::Synth()
 {
     sampleRate = 44100.0f;
+    numVoices = DEFAULT_VOICES;
+    channelTimbres.fill(0.5f);
+    selectedRPNs.fill(NULL_RPN);
+    setMPEZone(0);
 }
 
-void Synth::allocateResources(double sampleRate, int /*samplesPerBlock*/)
+void Synth::allocateResources(double sampleRate, int samplesPerBlock, int voicePoolSize)
 {
     this->sampleRate = static_cast<float>(sampleRate);
+
+    // the voices are mixed into this before being copied to the output channels.
+    // render() never asks for more than this many samples at once.
+    mixBuffer.setSize(1, juce::jmax(1, samplesPerBlock));
+
+    // the effects' delay lines are allocated here too, for the longest delay they allow
+    effectsBuffer.setSize(2, juce::jmax(1, samplesPerBlock));
+    effects.prepare(this->sampleRate);
+    tempoSync.prepare(sampleRate);
+
+    // phase increment of every MIDI note at this sample rate, so note on is a table lookup
+    for (int note = 0; note < 128; ++note)
+    {
+        double frequency = juce::MidiMessage::getMidiNoteInHertz(note);
+        noteTableDeltas[note] = frequency * MorphingOscillator::tableSize / sampleRate;
+    }
+
+    // expression glides towards its target with a ~10 ms time constant
+    constexpr float expressionSmoothingTime = 0.01f;
+    expressionSmoothing = 1.0f - std::exp(-CONTROL_RATE_INTERVAL / (expressionSmoothingTime * this->sampleRate));
+
+    // prepare every voice for the sample rate up front instead of at note on
+    resizeVoicePool(voicePoolSize);
+    for (Voice &voice : voices)
+        voice.prepare(this->sampleRate);
 }
 
 void Synth::deallocateResources()
 {
-    // need to implement
+    mixBuffer.setSize(0, 0);
+    effectsBuffer.setSize(0, 0);
+    effects.release();
+
+    // the voices own no memory, but whatever they were playing is dropped with the buffers
+    for (Voice &voice : voices)
+        voice.reset();
 }
 
 // reset the synth's voices back to a "cleared" state
@@ -26,37 +61,87 @@ void Synth::reset()
 {
     for (Voice &voice : voices)
         voice.reset();
+
+    effects.reset();
+    tempoSync.reset();
+
+    channelPitchBends.fill(0.0f);
+    channelPressures.fill(0.0f);
+    channelTimbres.fill(0.5f);
+    samplesUntilControlUpdate = 0;
+
+    for (auto &channelControllers : controllerValues)
+        channelControllers.fill(0);
+    selectedRPNs.fill(NULL_RPN);
+    for (auto &heldNotes : sustainedNoteOffs)
+        heldNotes.reset();
+    sustainPedalDown.fill(false);
+    modWheels.fill(0.0f);
+    pendingProgramChange = -1;
+    numStolenVoices = 0;
 }
 
 void Synth::render(juce::AudioBuffer<float> &outputBuffers, int sampleCount, int bufferOffset)
 {
-    for (int sample = 0; sample < sampleCount; ++sample)
+    // allocateResources() hasn't been called (or deallocateResources() has)
+    int maxBlockSize = mixBuffer.getNumSamples();
+    if (maxBlockSize == 0)
+        return;
+
+    float *mix = mixBuffer.getWritePointer(0);
+
+    // synced LFOs of notes started after this segment need to know how far the song has moved
+    tempoSync.advance(sampleCount);
+
+    // some hosts send bigger blocks than they announced in prepareToPlay(),
+    // so render in pieces that fit the mix buffer
+    while (sampleCount > 0)
     {
-        float output = 0.0f;
+        int blockSize = juce::jmin(sampleCount, maxBlockSize);
 
-        // variable to increment num active voices
-        for (Voice &voice : voices)
+        renderVoices(mix, blockSize);
+
+        // need to normalize this by number of active voices
+        // apply some sort of limiter, or scale by 1/MAX_VOICES
+        // this is a polyphony gain staging problem
+        juce::FloatVectorOperations::clip(mix, mix, -1.0f, 1.0f, blockSize);
+
+        if (effects.isOn())
         {
-            if (voice.env.isActive())
+            float *left = effectsBuffer.getWritePointer(0);
+            float *right = effectsBuffer.getWritePointer(1);
+            juce::FloatVectorOperations::copy(left, mix, blockSize);
+            juce::FloatVectorOperations::copy(right, mix, blockSize);
+
             {
-                // increment that variable
+                CYNTHIA_PROFILE_SCOPE(Effects);
+                effects.process(left, right, blockSize);
+            }
 
-                // need to normalize this by number of active voices
-                // apply some sort of limiter, or scale by 1/MAX_VOICES
-                // this is a polyphony gain staging problem
-                output += voice.render();
+            if (outputBuffers.getNumChannels() == 1)
+            {
+                // mono output gets both sides
+                outputBuffers.addFrom(0, bufferOffset, left, blockSize, 0.5f);
+                outputBuffers.addFrom(0, bufferOffset, right, blockSize, 0.5f);
+            }
+            else
+            {
+                for (int channel = 0; channel < outputBuffers.getNumChannels(); ++channel)
+                    outputBuffers.addFrom(channel, bufferOffset, (channel % 2 == 0) ? left : right, blockSize);
             }
-                
         }
-
-        output = juce::jlimit(-1.0f, 1.0f, output);
-
-        // scale the output by the number of active voices
-
-        for (int channel = 0; channel < outputBuffers.getNumChannels(); ++channel)
+        else
         {
-            outputBuffers.addSample(channel, sample + bufferOffset, output);
+            effects.skip();
+
+            for (int channel = 0; channel < outputBuffers.getNumChannels(); ++channel)
+            {
+                outputBuffers.addFrom(channel, bufferOffset, mix, blockSize);
+            }
         }
+
+        sampleCount -= blockSize;
+        bufferOffset += blockSize;
     }
 
     for (Voice &voice : voices)
@@ -66,22 +151,53 @@ void Synth::render(juce::AudioBuffer<float> &outputBuffers, int sampleCount, int
     }
 }
 
+// sums every active voice into mix. The block is cut at control rate boundaries
+// so expression updates happen between chunks and never inside a voice's render loop
+void Synth::renderVoices(float *mix, int sampleCount)
+{
+    juce::FloatVectorOperations::clear(mix, sampleCount);
+
+    int sample = 0;
+    while (sample < sampleCount)
+    {
+        if (samplesUntilControlUpdate == 0)
+        {
+            updateControlRate();
+            samplesUntilControlUpdate = CONTROL_RATE_INTERVAL;
+        }
+
+        int chunkSize = juce::jmin(sampleCount - sample, samplesUntilControlUpdate);
+
+        for (Voice &voice : voices)
+        {
+            if (voice.env.isActive())
+                voice.render(mix + sample, chunkSize, voiceScratch);
+        }
+
+        sample += chunkSize;
+        samplesUntilControlUpdate -= chunkSize;
+    }
+}
+
 void Synth::midiMessage(uint8_t data0, uint8_t data1, uint8_t data2)
 {
     /*
         The first byte of a MIDI msg is the status byte which consists of two parts: the command(four highest bits), and the channel number(four lowest bits).
         By doing (data0 & 0xF0), we are only looking at the status byte's command.
 
-        If we wanted to find the channel this message applies to, we'd do the following: uint8_t channel = data0 & 0x0F
+        The lowest four bits are the channel. We need it for MPE, where every note gets its own
+        channel so that pitch bend, pressure, and CC74 can be applied per note.
 
         The bitwise-AND operations are a defensive programming strategy to ensure that the values
         we send to noteOff and noteOn are within the range of vald MIDI numbers (0 to 127)
     */
+    int channel = data0 & 0x0F;
+
     switch (data0 & 0xF0)
     {
     // Note off
     case 0x80:
-        noteOff(data1 & 0x7F);
+        noteOff(data1 & 0x7F, channel);
         break;
 
     // Note on
@@ -96,16 +212,124 @@ void Synth::midiMessage(uint8_t data0, uint8_t data1, uint8_t data2)
         */
         if (velocity > 0)
         {
-            noteOn(note, velocity);
+            noteOn(note, velocity, channel);
         }
         else
         {
-            noteOff(note);
+            noteOff(note, channel);
         }
 
         break;
     }
+
+    // Polyphonic aftertouch
+    case 0xA0:
+        polyPressure(data1 & 0x7F, channel, (data2 & 0x7F) / 127.0f);
+        break;
+
+    // Control change
+    case 0xB0:
+        controlChange(channel, data1 & 0x7F, data2 & 0x7F);
+        break;
+
+    // Program change. Loading a program isn't real-time safe, so it's only recorded here
+    // and the processor hands it to the message thread
+    case 0xC0:
+        pendingProgramChange = data1 & 0x7F;
+        break;
+
+    // Channel pressure
+    case 0xD0:
+        channelPressure(channel, (data1 & 0x7F) / 127.0f);
+        break;
+
+    // Pitch bend. The 14-bit value is sent LSB first, 8192 is the centre
+    case 0xE0:
+        pitchBend(channel, (data1 & 0x7F) | ((data2 & 0x7F) << 7));
+        break;
+    }
+}
+
+int Synth::takeProgramChange()
+{
+    int program = pendingProgramChange;
+    pendingProgramChange = -1;
+    return program;
+}
+
+int Synth::getNumActiveVoices() const
+{
+    int numActive = 0;
+
+    for (const Voice &voice : voices)
+    {
+        if (voice.env.isActive())
+            ++numActive;
+    }
+
+    return numActive;
+}
+
+int Synth::takeNumStolenVoices()
+{
+    int numStolen = numStolenVoices;
+    numStolenVoices = 0;
+    return numStolen;
+}
+
+void Synth::publishPlayheads(VoicePlayheads &playheads) const
+{
+    int numPublished = juce::jmin(getVoicePoolSize(), VoicePlayheads::maxVoices);
+
+    for (int voiceIndex = 0; voiceIndex < numPublished; ++voiceIndex)
+    {
+        const Voice &voice = voices[voiceIndex];
+        VoicePlayheads::Playhead playhead;
+
+        if (voice.env.isActive())
+        {
+            playhead.state = voice.env.isReleased() ? VoicePlayheads::State::Released : VoicePlayheads::State::Held;
+            playhead.envelopeLevel = voice.env.getCurrentLevel();
+            playhead.envelopeSeconds = voice.env.getSecondsInStage();
+            playhead.lfoPhase = voice.lfo.getPhase();
+        }
+
+        playheads.publish(voiceIndex, playhead);
+    }
+
+    playheads.setNumVoices(numPublished);
+}
+
+// the pool is a vector so that a patch only pays for the voices it asks for.
+// resizing may allocate (and Voice's constructor builds its wavetables), which is why
+// this happens in allocateResources() or on the message thread while processing is suspended.
+void Synth::resizeVoicePool(int newPoolSize)
+{
+    newPoolSize = juce::jlimit(1, MAX_VOICES, newPoolSize);
+    int oldPoolSize = getVoicePoolSize();
+
+    voices.resize(static_cast<size_t>(newPoolSize));
+    voices.shrink_to_fit();
+
+    // new voices are prepared here rather than at note on
+    for (int voiceIndex = oldPoolSize; voiceIndex < newPoolSize; ++voiceIndex)
+    {
+        voices[voiceIndex].prepare(sampleRate);
+        voices[voiceIndex].setUserWavetableOsc(userWavetable);
+        voices[voiceIndex].setNoiseSeed(static_cast<uint32_t>(voiceIndex));
     }
+
+    numVoices = juce::jmin(numVoices, newPoolSize);
+}
+
+int Synth::getVoicePoolSize() const
+{
+    return static_cast<int>(voices.size());
+}
+
+void Synth::setDeterministic(bool shouldBeDeterministic)
+{
+    deterministic = shouldBeDeterministic;
 }
 
 // based on Matthijs Hollemans' voice-stealing logic
@@ -115,7 +339,7 @@ int Synth::findFreeVoice() const
     int freeVoiceIndex = 0;
     float refLevel = 1.0f; // louder than any envelope
 
-    for (int voiceIndex = 0; voiceIndex < MAX_VOICES; ++voiceIndex)
+    for (int voiceIndex = 0; voiceIndex < numVoices; ++voiceIndex)
     {
         const auto& voice = voices[voiceIndex];
         float level = voice.env.getCurrentLevel();
@@ -136,55 +360,110 @@ int Synth::findFreeVoice() const
 }
 
 // starts a single voice by choosing a voice at the given index
-// initializes the dsp modules
-void Synth::startVoice(int voiceIndex, int note, int velocity)
+// the dsp modules were already prepared for the sample rate in allocateResources(),
+// so only the per-note settings happen here
+void Synth::startVoice(int voiceIndex, int note, int velocity, int channel)
 {
     Voice &voice = voices[voiceIndex];
 
+    // free running oscillators and noise carry on from the voice's last note, so the sound
+    // depends on the history. Deterministic mode takes that out
+    if (deterministic)
+    {
+        voice.resetOscillators();
+        voice.setNoiseSeed(static_cast<uint32_t>((voiceIndex * 128 + note) * 16 + channel));
+    }
+
     voice.note = note;
+    voice.channel = channel;
     voice.amplitude = (velocity / 127.0f) * outputGain;
-    float frequency = static_cast<float>(juce::MidiMessage::getMidiNoteInHertz(note));
     
-    voice.prepareWavetable(frequency, sampleRate);
+    // oscillator 2's tuning has to be in place before the pitch is set
+    voice.setSemitonesOsc2(semitonesOsc2);
+    voice.setTableDeltaOsc(noteTableDeltas[note]);
     voice.setWaveformIndicesOsc(waveformIndexAOsc, waveformIndexBOsc);
     voice.setMorphValueOsc(morphValueOsc);
     voice.setDetuneCentsOsc(detuneCentsOsc);
-
-    voice.prepareLFO(modFreqLFO, sampleRate);
+    voice.setUseUserWavetableOsc(useUserWavetable);
+    voice.setInterpolationOsc(interpolationOsc);
+
+    voice.setWaveformIndexOsc2(waveformIndexOsc2);
+    voice.osc2Level = levelOsc2;
+    voice.osc2FMAmount = fmAmountOsc2;
+    voice.osc2RingMod = ringModOsc2;
+    voice.osc2Sync = syncOsc2;
+
+    voice.noiseLevel = noiseLevel;
+    voice.setNoiseType(noiseType);
+    voice.setNoiseFrequency(static_cast<float>(juce::MidiMessage::getMidiNoteInHertz(note)), sampleRate);
+
+    // a synced LFO joins in where the song is. A free one starts its cycle with the note
+    if (syncLFO)
+        voice.lfo.setSynced(tempoSync.getTableDelta(), tempoSync.getPhase());
+    else
+        voice.prepareLFO(modFreqLFO, sampleRate);
     voice.setWaveformIndicesLFO(waveformIndexALFO, waveformIndexBLFO);
     voice.setMorphValueLFO(morphValueLFO);
     voice.setDetuneCentsLFO(detuneCentsLFO);
-    voice.setModDepthLFO(modDepthLFO);
+    voice.setModDepthLFO(getLFOModDepthWithModWheel(channel));
+    voice.lfoPositionDepth = positionModLFO;
 
-    voice.prepareFilter(sampleRate);
+    voice.resetFilter();
     voice.setFilterCutoff(filterCutoff);
     voice.setFilterResonance(filterResonance);
     voice.setFilterType(filterType);
 
-    voice.prepareEnvelope(sampleRate);
     voice.setEnvelopeParameters(envAttack, envDecay, envSustain, envRelease);
     voice.startEnvelope();
+
+    // MPE controllers send the channel's initial expression before the note on,
+    // so the new note starts from that state instead of gliding to it
+    voice.baseCutoff = filterCutoff;
+    voice.baseMorph = morphValueOsc;
+    setVoiceExpressionTargets(voice);
+    voice.snapExpression();
 }
 
 // dispatched from midiMessage()
-void Synth::noteOn(int note, int velocity)
+void Synth::noteOn(int note, int velocity, int channel)
 {
+    // the key went down again, so a note off deferred by the sustain pedal no longer applies
+    sustainedNoteOffs[channel].reset(note);
+
     int freeVoiceIndex = 0; // voice index 0 = mono voice
 
     if (numVoices > 1) // polyphony activated
     {
         freeVoiceIndex = findFreeVoice();
+
+        // every voice was busy, so the quietest one gets cut off
+        if (voices[freeVoiceIndex].env.isActive())
+            ++numStolenVoices;
     }
 
-    startVoice(freeVoiceIndex, note, velocity);
+    startVoice(freeVoiceIndex, note, velocity, channel);
 }
 
 // dispatched from midiMessage()
-void Synth::noteOff(int note)
+void Synth::noteOff(int note, int channel)
+{
+    // while the pedal is down the note keeps sounding. The note off is remembered
+    // and carried out when the pedal comes back up (see sustainPedal())
+    if (isSustained(channel))
+    {
+        sustainedNoteOffs[channel].set(note);
+        return;
+    }
+
+    releaseNote(note, channel);
+}
+
+void Synth::releaseNote(int note, int channel)
 {
     for (Voice &voice : voices)
     {
-        if (voice.note == note)
+        // with MPE the same note can be held on two channels at once
+        if (voice.note == note && voice.channel == channel)
         {
             voice.stopEnvelope();
             voice.note = 0;
@@ -192,6 +471,277 @@ void Synth::noteOff(int note)
     }
 }
 
+// dispatched from midiMessage()
+void Synth::controlChange(int channel, int controller, int value)
+{
+    controllerValues[channel][controller] = static_cast<uint8_t>(value);
+
+    switch (controller)
+    {
+    // Mod wheel
+    case 1:
+        modWheels[channel] = value / 127.0f;
+        updateModWheel(channel);
+        break;
+
+    // Sustain pedal. Values of 64 and above mean the pedal is down
+    case 64:
+        sustainPedal(channel, value >= 64);
+        break;
+
+    // Data entry, coarse and fine, for the registered parameter selected with CC 101 and 100
+    case 6:
+        dataEntry(channel, value, true);
+        break;
+
+    case 38:
+        dataEntry(channel, value, false);
+        break;
+
+    case 100:
+        selectedRPNs[channel] = (selectedRPNs[channel] & 0x3F80) | value;
+        break;
+
+    case 101:
+        selectedRPNs[channel] = (value << 7) | (selectedRPNs[channel] & 0x7F);
+        break;
+
+    // MPE "timbre" dimension
+    case 74:
+        timbre(channel, value / 127.0f);
+        break;
+
+    // All sound off: silence immediately, without release tails
+    case 120:
+        allSoundOff(channel);
+        break;
+
+    // Reset all controllers
+    case 121:
+        resetControllers(channel);
+        break;
+
+    // All notes off: a note off for every note, so the pedal still holds the ones it's holding
+    case 123:
+        allNotesOff(channel);
+        break;
+    }
+}
+
+// channel mode messages, and the master channel of an MPE zone, reach every note in their scope
+bool Synth::reachesChannel(int messageChannel, int voiceChannel) const
+{
+    return voiceChannel == messageChannel || (isMPEMasterChannel(messageChannel) && isMPEMemberChannel(voiceChannel));
+}
+
+void Synth::allSoundOff(int channel)
+{
+    for (Voice &voice : voices)
+    {
+        if (reachesChannel(channel, voice.channel))
+            voice.reset();
+    }
+
+    for (int other = 0; other < 16; ++other)
+    {
+        if (reachesChannel(channel, other))
+            sustainedNoteOffs[other].reset();
+    }
+}
+
+void Synth::allNotesOff(int channel)
+{
+    for (Voice &voice : voices)
+    {
+        if (voice.env.isActive() && ! voice.env.isReleased() && reachesChannel(channel, voice.channel))
+            noteOff(voice.note, voice.channel);
+    }
+}
+
+// a note on a member channel is also held by the pedal on the zone's master channel
+bool Synth::isSustained(int channel) const
+{
+    return sustainPedalDown[channel] || (isMPEMemberChannel(channel) && sustainPedalDown[0]);
+}
+
+void Synth::sustainPedal(int channel, bool isDown)
+{
+    sustainPedalDown[channel] = isDown;
+
+    if (isDown)
+        return;
+
+    // pedal up: carry out the note offs that were deferred while it was held, on every channel
+    // it reaches, unless the other pedal (master or member) is still holding them
+    for (int other = 0; other < 16; ++other)
+    {
+        if (! reachesChannel(channel, other) || isSustained(other))
+            continue;
+
+        auto &heldNotes = sustainedNoteOffs[other];
+        for (int note = 0; note < 128; ++note)
+        {
+            if (heldNotes.test(note))
+                releaseNote(note, other);
+        }
+        heldNotes.reset();
+    }
+}
+
+void Synth::resetControllers(int channel)
+{
+    controllerValues[channel].fill(0);
+    sustainPedal(channel, false);
+
+    channelPitchBends[channel] = 0.0f;
+    channelPressures[channel] = 0.0f;
+    channelTimbres[channel] = 0.5f;
+    updateChannelExpression(channel);
+
+    selectedRPNs[channel] = NULL_RPN;
+    modWheels[channel] = 0.0f;
+    updateModWheel(channel);
+}
+
+// the mod wheel adds to the LFO depth of the voices on its channel (or in its MPE zone)
+void Synth::updateModWheel(int channel)
+{
+    for (Voice &voice : voices)
+    {
+        if (reachesChannel(channel, voice.channel))
+            voice.setModDepthLFO(getLFOModDepthWithModWheel(voice.channel));
+    }
+}
+
+float Synth::getLFOModDepthWithModWheel(int channel) const
+{
+    float modWheel = modWheels[channel] + (isMPEMemberChannel(channel) ? modWheels[0] : 0.0f);
+    return juce::jmin(1.0f, modDepthLFO + modWheel);
+}
+
+float Synth::getControllerValue(int channel, int controller) const
+{
+    return controllerValues[channel & 0x0F][controller & 0x7F] / 127.0f;
+}
+
+// dispatched from midiMessage()
+void Synth::polyPressure(int note, int channel, float pressure)
+{
+    // polyphonic aftertouch drives the same per-note pressure as MPE channel pressure
+    for (Voice &voice : voices)
+    {
+        if (voice.note == note && voice.channel == channel)
+            voice.pressureTarget = pressure;
+    }
+}
+
+void Synth::dataEntry(int channel, int value, bool isCoarse)
+{
+    switch (selectedRPNs[channel])
+    {
+    // Pitch bend range: coarse is semitones, fine is cents. In an MPE zone, setting it on any
+    // member channel sets it for all of them
+    case 0:
+    {
+        float range = isCoarse ? static_cast<float>(value) : std::floor(pitchBendRanges[channel]) + juce::jmin(value, 99) / 100.0f;
+
+        for (int other = 0; other < 16; ++other)
+        {
+            if (other == channel || (isMPEMemberChannel(channel) && isMPEMemberChannel(other)))
+                pitchBendRanges[other] = range;
+        }
+        break;
+    }
+
+    // MPE Configuration Message. Only the lower zone (master channel 1) is supported
+    case 6:
+        if (isCoarse && channel == 0)
+            setMPEZone(value);
+        break;
+    }
+}
+
+void Synth::setMPEZone(int numMemberChannels)
+{
+    numMPEMemberChannels = juce::jlimit(0, 15, numMemberChannels);
+
+    for (int channel = 0; channel < 16; ++channel)
+        pitchBendRanges[channel] = isMPEMemberChannel(channel) ? MEMBER_PITCH_BEND_RANGE : MASTER_PITCH_BEND_RANGE;
+}
+
+int Synth::getNumMPEMemberChannels() const
+{
+    return numMPEMemberChannels;
+}
+
+bool Synth::isMPEMasterChannel(int channel) const
+{
+    return numMPEMemberChannels > 0 && channel == 0;
+}
+
+bool Synth::isMPEMemberChannel(int channel) const
+{
+    return channel >= 1 && channel <= numMPEMemberChannels;
+}
+
+float Synth::getChannelPitchBend(int channel) const
+{
+    return channelPitchBends[channel & 0x0F];
+}
+
+// dispatched from midiMessage()
+void Synth::pitchBend(int channel, int value)
+{
+    float bend = (value - 8192) / 8192.0f;
+
+    channelPitchBends[channel] = bend * pitchBendRanges[channel];
+    updateChannelExpression(channel);
+}
+
+// dispatched from midiMessage()
+void Synth::channelPressure(int channel, float pressure)
+{
+    channelPressures[channel] = pressure;
+    updateChannelExpression(channel);
+}
+
+// dispatched from midiMessage()
+void Synth::timbre(int channel, float timbre)
+{
+    channelTimbres[channel] = timbre;
+    updateChannelExpression(channel);
+}
+
+// only the targets are set here. The voices glide towards them in updateControlRate(),
+// so no per-sample work is done for expression messages
+void Synth::updateChannelExpression(int channel)
+{
+    for (Voice &voice : voices)
+    {
+        // the MPE master channel bends every note in the zone
+        if (reachesChannel(channel, voice.channel))
+            setVoiceExpressionTargets(voice);
+    }
+}
+
+void Synth::setVoiceExpressionTargets(Voice &voice) const
+{
+    float masterBend = isMPEMemberChannel(voice.channel) ? channelPitchBends[0] : 0.0f;
+
+    voice.pitchBendTarget = channelPitchBends[voice.channel] + masterBend;
+    voice.pressureTarget = channelPressures[voice.channel];
+    voice.timbreTarget = channelTimbres[voice.channel];
+}
+
+void Synth::updateControlRate()
+{
+    for (Voice &voice : voices)
+    {
+        if (voice.env.isActive())
+            voice.updateExpression(expressionSmoothing);
+    }
+}
+
 void Synth::setOscMorphValue(float newMorphValue)
 {
     morphValueOsc = juce::jlimit(0.0f, 1.0f, newMorphValue);
@@ -208,6 +758,96 @@ void Synth::setOscWaveformIndices(int newWaveformIndexA, int newWaveformIndexB)
     waveformIndexBOsc = juce::jlimit(0, 3, newWaveformIndexB);
 }
 
+void Synth::setOscInterpolation(int newInterpolation)
+{
+    interpolationOsc = juce::jlimit(0, 2, newInterpolation);
+}
+
+void Synth::setOscTableSource(int newTableSource)
+{
+    useUserWavetable = newTableSource == 1;
+}
+
+// every voice switches at once, including the ones that are sounding. The previous
+// table is released by its owner once this has happened, so no voice may keep pointing at it
+void Synth::setUserWavetable(const Wavetable* newUserWavetable)
+{
+    userWavetable = newUserWavetable;
+
+    for (Voice &voice : voices)
+        voice.setUserWavetableOsc(userWavetable);
+}
+
+void Synth::setNoiseLevel(float newNoiseLevel)
+{
+    noiseLevel = juce::jlimit(0.0f, 1.0f, newNoiseLevel);
+}
+
+void Synth::setNoiseType(int newNoiseType)
+{
+    noiseType = juce::jlimit(0, 2, newNoiseType);
+}
+
+void Synth::setOsc2Level(float newLevel)
+{
+    levelOsc2 = juce::jlimit(0.0f, 1.0f, newLevel);
+}
+
+void Synth::setOsc2WaveformIndex(int newWaveformIndex)
+{
+    waveformIndexOsc2 = juce::jlimit(0, 3, newWaveformIndex);
+}
+
+void Synth::setOsc2Semitones(int newSemitones)
+{
+    semitonesOsc2 = juce::jlimit(-24, 24, newSemitones);
+}
+
+void Synth::setOsc2FMAmount(float newFMAmount)
+{
+    fmAmountOsc2 = juce::jlimit(0.0f, 1.0f, newFMAmount);
+}
+
+void Synth::setOsc2RingMod(float newRingMod)
+{
+    ringModOsc2 = juce::jlimit(0.0f, 1.0f, newRingMod);
+}
+
+void Synth::setOsc2Sync(bool shouldSync)
+{
+    syncOsc2 = shouldSync;
+}
+
+void Synth::setChorus(float mix, float rate, float depth)
+{
+    effects.chorus.setParameters(juce::jlimit(0.0f, 1.0f, mix), juce::jlimit(0.01f, 10.0f, rate), juce::jlimit(0.0f, 1.0f, depth));
+}
+
+void Synth::setDelay(float mix, float feedback, int noteValueIndex)
+{
+    effects.delay.setParameters(juce::jlimit(0.0f, 1.0f, mix), juce::jlimit(0.0f, 0.95f, feedback), noteValueIndex);
+}
+
+void Synth::setReverb(float mix, float size, float damping)
+{
+    effects.reverb.setParameters(juce::jlimit(0.0f, 1.0f, mix), juce::jlimit(0.0f, 1.0f, size), juce::jlimit(0.0f, 1.0f, damping));
+}
+
+void Synth::setTransport(const TempoSync::Transport &transport, int numSamples)
+{
+    effects.delay.setTempo(transport.bpm);
+
+    // the tempo changed or the song jumped, so sounding voices catch up straight away
+    if (tempoSync.update(transport, numSamples) && syncLFO)
+    {
+        for (Voice &voice : voices)
+        {
+            if (voice.env.isActive())
+                voice.lfo.setSynced(tempoSync.getTableDelta(), tempoSync.getPhase());
+        }
+    }
+}
+
 void Synth::setFilterType(int newType)
 {
     filterType = newType;
@@ -267,4 +907,23 @@ void Synth::setLFOModDepthValue(float newModDepth)
 void Synth::setLFOModFreqValue(float frequency) 
 {
     modFreqLFO = juce::jlimit(1.0f, 500.0f,frequency);
+}
+
+void Synth::setLFOPositionModValue(float newPositionMod)
+{
+    positionModLFO = juce::jlimit(0.0f, 1.0f, newPositionMod);
+}
+
+void Synth::setLFOSyncRate(int newSyncRate)
+{
+    bool shouldSync = newSyncRate > 0;
+
+    if (shouldSync)
+        tempoSync.setNoteValue(newSyncRate - 1);
+
+    // switching sync on locks to the song at the next block
+    if (shouldSync && ! syncLFO)
+        tempoSync.requestRelock();
+
+    syncLFO = shouldSync;
 }
\ No newline at end of file
@@ -11,16 +11,21 @@
 
 #pragma once
 
+#include <bitset>
 #include "Cynthia_DSP/Voice.h"
+#include "Cynthia_DSP/Effects.h"
+#include "Cynthia_DSP/TempoSync.h"
 #include "Cynthia_DSP/NoiseGenerator.h"
 #include "Cynthia_Utilities/Utils.h"
+#include "Cynthia_Utilities/VoicePlayheads.h"
 
 class Synth
 {
     public:
         Synth();
         // called right before the host starts playing audio (analogous to prepareToPlay())
-        void allocateResources(double sampleRate, int samplesPerBlock);
+        // this is also where the voice pool gets allocated, so the audio thread never has to
+        void allocateResources(double sampleRate, int samplesPerBlock, int voicePoolSize = DEFAULT_VOICES);
         // called right after the host has finished playing audio (analogous to releaseResources())
         void deallocateResources();
         // reset the state of the synth
@@ -30,10 +35,72 @@ class Synth
         // handle any midi messages
         void midiMessage(uint8_t data0, uint8_t data1, uint8_t data2);
 
+        // the last program change received since the previous call, or -1 if there was none
+        int takeProgramChange();
+
+        // voices currently sounding (including releasing ones)
+        int getNumActiveVoices() const;
+        // voices stolen from a sounding note since the previous call
+        int takeNumStolenVoices();
+
+        // write every voice's envelope and LFO position for the displays (see VoicePlayheads)
+        void publishPlayheads(VoicePlayheads& playheads) const;
+
+        // the last value (0 to 1) received for a MIDI controller, so CCs can be used as modulation sources
+        float getControllerValue(int channel, int controller) const;
+
+        // MPE lower zone: channel 1 (index 0) is the master channel and the next numMemberChannels
+        // channels carry one note each, with their own pitch bend, pressure and CC74. 0 means no
+        // zone, so every channel is an ordinary channel. An MPE controller sets this itself with
+        // its MPE Configuration Message, which also resets the pitch bend ranges to MPE's defaults
+        void setMPEZone(int numMemberChannels);
+        int getNumMPEMemberChannels() const;
+
+        // the channel's pitch bend, in semitones, as set by its pitch bend range (RPN 0)
+        float getChannelPitchBend(int channel) const;
+
+        // in deterministic mode every note starts from the same state, whatever the voice played
+        // before: the oscillators start their cycles at 0 and the noise is seeded from the voice,
+        // note and channel. A bounce then renders the same as realtime playback, and the same
+        // MIDI renders bit for bit the same output on every run and at every block size
+        void setDeterministic(bool shouldBeDeterministic);
+
+        // grow or shrink the voice pool. This allocates, so never call it from the audio thread.
+        void resizeVoicePool(int newPoolSize);
+        int getVoicePoolSize() const;
+
         // Oscillator object param setters
         void setOscMorphValue(float newMorphValue);
         void setOscWaveformIndices(int newWaveformIndexA, int newWaveformIndexB);
         void setOscDetuneCentsValue(float newDetuneCents);
+        // 0 linear, 1 Hermite, 2 windowed sinc
+        void setOscInterpolation(int newInterpolation);
+        // 0 plays the generated waveforms, 1 the user wavetable
+        void setOscTableSource(int newTableSource);
+        // swap the user wavetable on every voice. Audio thread, the table is owned by the caller
+        void setUserWavetable(const Wavetable* newUserWavetable);
+
+        // Noise param setters
+        void setNoiseLevel(float newNoiseLevel);
+        // 0 white, 1 pink, 2 filtered
+        void setNoiseType(int newNoiseType);
+
+        // Oscillator 2 param setters
+        void setOsc2Level(float newLevel);
+        void setOsc2WaveformIndex(int newWaveformIndex);
+        void setOsc2Semitones(int newSemitones);
+        void setOsc2FMAmount(float newFMAmount);
+        void setOsc2RingMod(float newRingMod);
+        void setOsc2Sync(bool shouldSync);
+
+        // Effects param setters. A mix of 0 turns the effect off
+        void setChorus(float mix, float rate, float depth);
+        // noteValueIndex picks from DelayEffect::noteValueBeats
+        void setDelay(float mix, float feedback, int noteValueIndex);
+        void setReverb(float mix, float size, float damping);
+        // the host's tempo and song position at the start of the block about to be rendered.
+        // the delay time and synced LFOs follow it
+        void setTransport(const TempoSync::Transport& transport, int numSamples);
 
         // Filter object param setters
         void setFilterType(int newType);
@@ -52,6 +119,9 @@ class Synth
         void setLFODetuneCentsValue(float newDetuneCents);
         void setLFOModDepthValue(float newModDepth);
         void setLFOModFreqValue(float frequency);
+        void setLFOPositionModValue(float newPositionMod);
+        // 0 runs the LFO at its Mod Freq, anything else is a note value (see TempoSync::noteValueBeats)
+        void setLFOSyncRate(int newSyncRate);
 
         float outputGain;
 
@@ -64,13 +134,31 @@ class Synth
         float filterCutoff;
         float filterResonance;
 
-        static constexpr int MAX_VOICES = 16;
+        // MAX_VOICES is the upper bound of the voiceCount parameter. The pool itself only
+        // holds as many voices as the patch asks for, so memory scales with the voice count.
+        static constexpr int MAX_VOICES = 128;
+        static constexpr int DEFAULT_VOICES = 16;
+
+        // number of voices the voice stealing logic may use (always <= getVoicePoolSize())
         int numVoices;
 
         int waveformIndexAOsc = 0;
         int waveformIndexBOsc = 1;
         float morphValueOsc = 0.0f;
         float detuneCentsOsc = 0.0f;
+        bool useUserWavetable = false;
+        int interpolationOsc = 0;
+        const Wavetable* userWavetable = nullptr;
+
+        float noiseLevel = 0.0f;
+        int noiseType = 0;
+
+        float levelOsc2 = 0.0f;
+        int waveformIndexOsc2 = 0;
+        int semitonesOsc2 = 0;
+        float fmAmountOsc2 = 0.0f;
+        float ringModOsc2 = 0.0f;
+        bool syncOsc2 = false;
 
         int waveformIndexALFO = 0;
         int waveformIndexBLFO = 1;
@@ -78,23 +166,123 @@ class Synth
         float detuneCentsLFO = 0.0f;
         float modDepthLFO = 0.0f;
         float modFreqLFO = 0.0f;
+        float positionModLFO = 0.0f;
+        bool syncLFO = false;
+
+        // the song position synced LFOs lock to
+        TempoSync tempoSync;
+
+        // per-note expression (pitch, cutoff, morph) is smoothed and applied once every
+        // CONTROL_RATE_INTERVAL samples instead of every sample
+        static constexpr int CONTROL_RATE_INTERVAL = 32;
+        static_assert(CONTROL_RATE_INTERVAL <= VoiceScratch::size, "voices render one control period at a time");
+
+        // default pitch bend ranges, in semitones: 2 for ordinary and MPE master channels, and
+        // MPE's 48 for member channels. RPN 0 changes them per channel
+        static constexpr float MASTER_PITCH_BEND_RANGE = 2.0f;
+        static constexpr float MEMBER_PITCH_BEND_RANGE = 48.0f;
 
     private:
 
         // handle the triggering of a voice
-        void startVoice(int voiceIndex, int note, int velocity);
+        void startVoice(int voiceIndex, int note, int velocity, int channel);
 
         // part of the voice stealing logic
         int findFreeVoice() const;
 
+        int pendingProgramChange = -1;
+        int numStolenVoices = 0;
+        bool deterministic = false;
+
         // handle a Note on event
-        void noteOn(int note, int velocity);
+        void noteOn(int note, int velocity, int channel);
         // handle a Note off event
-        void noteOff(int note);
+        void noteOff(int note, int channel);
+        // put every voice playing this note into its release stage
+        void releaseNote(int note, int channel);
+
+        // handle control change messages (mod wheel, sustain, CC74, channel mode messages)
+        void controlChange(int channel, int controller, int value);
+        void sustainPedal(int channel, bool isDown);
+        bool isSustained(int channel) const;
+        void allSoundOff(int channel);
+        void allNotesOff(int channel);
+        void resetControllers(int channel);
+        void updateModWheel(int channel);
+        float getLFOModDepthWithModWheel(int channel) const;
+
+        // whether a message on one channel applies to notes on another: the same channel, or
+        // any member channel when the message came on the MPE master channel
+        bool reachesChannel(int messageChannel, int voiceChannel) const;
+
+        // registered parameters (CC 101/100 select, CC 6/38 set): pitch bend range and MPE configuration
+        void dataEntry(int channel, int value, bool isCoarse);
+
+        // whether a channel is the master channel or a member channel of the MPE zone
+        bool isMPEMasterChannel(int channel) const;
+        bool isMPEMemberChannel(int channel) const;
+
+        // handle per-channel expression (pitch bend, channel pressure, CC74)
+        void pitchBend(int channel, int value);
+        void channelPressure(int channel, float pressure);
+        void polyPressure(int note, int channel, float pressure);
+        void timbre(int channel, float timbre);
+
+        // push the channel's expression state to the voices playing on it
+        void updateChannelExpression(int channel);
+        void setVoiceExpressionTargets(Voice& voice) const;
+
+        // smooth and apply per-note expression on every active voice
+        void updateControlRate();
+
+        // sum all active voices into mix
+        void renderVoices(float* mix, int sampleCount);
 
         float sampleRate;
 
-        // this allocates room for all 16 voices. In monophonic mode, the synth
-        // will only use the first object: voices[0]
-        std::array<Voice, MAX_VOICES> voices;
+        // mono voice mix, sized to the maximum block size in allocateResources()
+        juce::AudioBuffer<float> mixBuffer;
+
+        // chorus, delay and reverb over the voice mix, and the stereo buffer they run in
+        // (sized like mixBuffer). Neither is touched while every effect is off
+        EffectsChain effects;
+        juce::AudioBuffer<float> effectsBuffer;
+
+        // stage buffers the voices render through, shared since voices render one after another
+        VoiceScratch voiceScratch;
+
+        // oscillator phase increment for every MIDI note at the current sample rate
+        std::array<double, 128> noteTableDeltas {};
+
+        // MPE member channels after the master channel, 0 when there's no zone
+        int numMPEMemberChannels = 0;
+
+        // the registered parameter selected on each channel, and each channel's pitch bend range
+        static constexpr int NULL_RPN = 0x3FFF;
+        std::array<int, 16> selectedRPNs {};
+        std::array<float, 16> pitchBendRanges {};     // in semitones
+
+        // per-channel expression state, indexed by MIDI channel (0-15)
+        std::array<float, 16> channelPitchBends {};   // in semitones
+        std::array<float, 16> channelPressures {};    // 0 to 1
+        std::array<float, 16> channelTimbres {};      // 0 to 1, 0.5 = centre
+
+        // last value of every controller on every channel. Fixed size, so storing a CC never allocates
+        std::array<std::array<uint8_t, 128>, 16> controllerValues {};
+        std::array<float, 16> modWheels {};
+
+        // sustain pedal state, and the note offs deferred while it is down (one bit per note)
+        std::array<bool, 16> sustainPedalDown {};
+        std::array<std::bitset<128>, 16> sustainedNoteOffs;
+
+        // one-pole smoothing coefficient for expression, applied once per control period
+        float expressionSmoothing = 1.0f;
+
+        // counts down to the next control rate update. kept across render calls so that
+        // control updates land on the same samples regardless of how the block was split.
+        int samplesUntilControlUpdate = 0;
+
+        // the voice pool, sized in allocateResources() / resizeVoicePool(). In monophonic mode,
+        // the synth will only use the first object: voices[0]
+        std::vector<Voice> voices;
 };
\ No newline at end of file
@@ -0,0 +1,147 @@
+/*
+    TempoSync.h
+
+    Keeps tempo-synced LFOs in step with the host's song position.
+
+    The processor reads the host's transport once per block (Transport) and hands it to
+    Synth, which passes it to update() before rendering. From the tempo and the chosen note
+    value, TempoSync works out a fixed-point phase increment, and from the song position
+    the phase the LFO should be at.
+
+    The LFO is only re-locked to the song position when something actually moved it: the
+    tempo or note value changed, playback started, or the host jumped (a loop, or the user
+    moving the playhead). Between those, the phase advances by whole increments, sample by
+    sample. So the phase at any sample doesn't depend on where the blocks started, and a
+    bounce renders the same as realtime playback whatever block size the host uses.
+
+    While the transport is stopped there's no song position to follow, so the LFO keeps
+    running at the tempo from wherever it was.
+*/
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include "Cynthia_DSP/PhaseAccumulator.h"
+
+class TempoSync
+{
+public:
+
+    // the host's transport at the start of a block
+    struct Transport
+    {
+        double bpm = 120.0;
+        double ppqPosition = 0.0;   // song position in quarter notes
+        bool isPlaying = false;
+        bool hasPosition = false;   // false when there's no host (or it doesn't say)
+    };
+
+    // the note value choices of the LFO rate parameter, in beats per cycle. Index 0 is
+    // "Free" (the LFO runs at its own rate in Hz) and isn't in this table
+    static constexpr std::array<double, 10> noteValueBeats { 16.0, 8.0, 4.0, 2.0, 1.0, 0.5, 0.25, 1.0 / 3.0, 1.0 / 6.0, 0.75 };
+
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        needsRelock = true;
+    }
+
+    // back to the start of the song, e.g. before rendering it again
+    void reset()
+    {
+        anchorPhase = 0;
+        samplesSinceAnchor = 0;
+        wasFollowing = false;
+        needsRelock = true;
+    }
+
+    // index into noteValueBeats
+    void setNoteValue(int newNoteValueIndex)
+    {
+        newNoteValueIndex = juce::jlimit(0, static_cast<int>(noteValueBeats.size()) - 1, newNoteValueIndex);
+
+        if (newNoteValueIndex != noteValueIndex)
+        {
+            noteValueIndex = newNoteValueIndex;
+            needsRelock = true;
+        }
+    }
+
+    // lock to the song position again at the next update(), e.g. when sync was just switched on
+    void requestRelock()
+    {
+        needsRelock = true;
+    }
+
+    // once per block, before rendering it. Returns true when the LFOs must jump to getPhase()
+    bool update(const Transport& transport, int numSamples)
+    {
+        double bpm = transport.bpm > 0.0 ? transport.bpm : 120.0;
+        double beatsPerSample = bpm / (60.0 * sampleRate);
+
+        bool following = transport.isPlaying && transport.hasPosition;
+        bool relock = needsRelock || bpm != lastBpm;
+
+        // started playing, or the song position isn't where this block's predecessor said it would be
+        if (following && (! wasFollowing || std::abs(transport.ppqPosition - expectedPpqPosition) > 0.5 * beatsPerSample))
+            relock = true;
+
+        if (relock)
+        {
+            // carry on from where the LFO is, unless there's a song position to lock to
+            PhaseAccumulator::Phase anchor = getPhase();
+
+            if (following)
+            {
+                double cycles = transport.ppqPosition / noteValueBeats[static_cast<size_t>(noteValueIndex)];
+                anchor = PhaseAccumulator::fromCycles(cycles - std::floor(cycles));
+            }
+
+            tableDelta = beatsPerSample / noteValueBeats[static_cast<size_t>(noteValueIndex)] * Wavetable::tableSize;
+            increment = PhaseAccumulator::fromTableDelta(tableDelta);
+            anchorPhase = anchor;
+            samplesSinceAnchor = 0;
+        }
+
+        lastBpm = bpm;
+        wasFollowing = following;
+        needsRelock = false;
+        expectedPpqPosition = transport.ppqPosition + numSamples * beatsPerSample;
+
+        return relock;
+    }
+
+    // called by Synth as it renders, so getPhase() knows where within the block it is
+    void advance(int numSamples)
+    {
+        samplesSinceAnchor += static_cast<uint64_t>(numSamples);
+    }
+
+    // where a synced LFO is right now. Integer arithmetic, so a voice started mid-block lands
+    // on exactly the phase the running voices' accumulators have reached
+    PhaseAccumulator::Phase getPhase() const
+    {
+        return anchorPhase + static_cast<PhaseAccumulator::Phase>(samplesSinceAnchor) * increment;
+    }
+
+    // the LFO's pitch, in table samples per output sample
+    double getTableDelta() const
+    {
+        return tableDelta;
+    }
+
+private:
+    double sampleRate = 44100.0;
+    int noteValueIndex = 4; // a quarter note
+    bool needsRelock = true;
+
+    double lastBpm = 0.0;
+    bool wasFollowing = false;
+    double expectedPpqPosition = 0.0;
+
+    double tableDelta = 0.0;
+    PhaseAccumulator::Phase increment = 0;
+    PhaseAccumulator::Phase anchorPhase = 0;
+    uint64_t samplesSinceAnchor = 0;
+};
@@ -21,15 +21,69 @@
 #include "Cynthia_DSP/MorphingLFO.h"
 #include "Cynthia_DSP/Envelope.h"
 #include "Cynthia_DSP/Filter.h"
+#include "Cynthia_DSP/NoiseGenerator.h"
+#include "Cynthia_Utilities/Profiler.h"
+
+// buffers a voice renders each of its stages into. Synth owns a single instance and lends it
+// to every voice in turn, and voices render at most one control period (size samples) at a time.
+struct VoiceScratch
+{
+    static constexpr int size = 32;
+
+    std::array<float, size> osc;
+    std::array<float, size> env;
+    std::array<float, size> lfo;
+    std::array<float, size> position;
+    std::array<float, size> noise;
+    std::array<float, size> osc2;
+    std::array<float, size> modulation;
+};
 
 struct Voice
 {
-    int note;
+    int note = 0;
     MorphingOscillator osc;
+    MorphingOscillator osc2;
     MorphingLFO lfo;
     Envelope env;
     SVFFilter filter;
-    float amplitude;
+    NoiseGenerator noise;
+    float amplitude = 0.0f;
+
+    // how much noise is mixed in with the oscillator. At 0 the noise isn't generated at all
+    float noiseLevel = 0.0f;
+
+    // oscillator 2: how loud it is, and how much it modulates oscillator 1
+    float osc2Level = 0.0f;
+    float osc2FMAmount = 0.0f;
+    float osc2RingMod = 0.0f;
+    bool osc2Sync = false;
+    float osc2PitchRatio = 1.0f; // from its semitone offset
+
+    // MPE: the channel this note arrived on, so per-channel expression reaches the right voice
+    int channel = 0;
+
+    // per-note expression. Synth sets the targets when MIDI arrives,
+    // and the voice glides towards them at control rate in updateExpression()
+    float pitchBendTarget = 0.0f;   // semitones
+    float pressureTarget = 0.0f;    // 0 to 1
+    float timbreTarget = 0.5f;      // 0 to 1, 0.5 = no change
+    float pitchBend = 0.0f;
+    float pressure = 0.0f;
+    float timbre = 0.5f;
+
+    // the parameter values at note on, which expression is applied on top of
+    float baseCutoff = 10000.0f;
+    float baseMorph = 0.0f;
+
+    // how far the LFO moves the wavetable position (or the morph between Wavetype A and B)
+    float lfoPositionDepth = 0.0f;
+
+    // phase deviation (in cycles) at full FM amount
+    static constexpr float MAX_FM_CYCLES = 1.0f;
+
+    // how many octaves full pressure opens the filter
+    static constexpr float PRESSURE_CUTOFF_OCTAVES = 3.0f;
 
     Voice() 
     {}
@@ -38,39 +92,185 @@ struct Voice
     void reset()
     {
         note = 0;
+        channel = 0;
         osc.reset();
+        osc2.reset();
         env.reset();
         filter.reset();
+        noise.reset();
         lfo.resetPhase();
     }
 
-    float render()
+    // prepare every dsp module for the sample rate. Called from Synth::allocateResources(),
+    // so nothing has to be set up at note on
+    void prepare(float sampleRate)
     {
-        float sample = osc.getNextSample();
-        float envelope = env.getNextSample();   
-        float filtered_sample = filter.processSample(sample);
+        osc.prepare(sampleRate);
+        osc2.prepare(sampleRate);
+        lfo.prepare(sampleRate);
+        filter.prepare(sampleRate);
+        env.prepare(sampleRate);
+    }
 
-        float lfoAmount = lfo.getNextLFOSample();
-        float amplitudeModulator = 1.0f + lfoAmount;
-        amplitudeModulator = juce::jlimit(-1.0f, 1.0f, amplitudeModulator);
+    // render numSamples (at most VoiceScratch::size) and add them to output.
+    // each stage runs over the whole chunk before the next one starts.
+    void render(float* output, int numSamples, VoiceScratch& scratch)
+    {
+        float* sample = scratch.osc.data();
+        float* envelope = scratch.env.data();
+        float* lfoValue = scratch.lfo.data();
+        float* positionOffset = scratch.position.data();
+        float* noiseSample = scratch.noise.data();
+        float* osc2Sample = scratch.osc2.data();
+        float* modulationBuffer = scratch.modulation.data();
+
+        // the raw LFO (-1 to 1) drives both the amplitude and the wavetable position
+        {
+            CYNTHIA_PROFILE_SCOPE(VoiceLFO);
+            lfo.renderBlock(lfoValue, numSamples);
+        }
+
+        const float* positionModulation = nullptr;
+        if (lfoPositionDepth != 0.0f)
+        {
+            juce::FloatVectorOperations::multiply(positionOffset, lfoValue, lfoPositionDepth, numSamples);
+            positionModulation = positionOffset;
+        }
+
+        // oscillator 2 renders first, since oscillator 1 may follow it. When it's neither heard
+        // nor modulating anything, it isn't rendered at all
+        bool usesOsc2 = osc2Level > 0.0f || osc2FMAmount > 0.0f || osc2RingMod > 0.0f || osc2Sync;
+        MorphingOscillator::Modulation modulation;
+
+        if (usesOsc2)
+        {
+            CYNTHIA_PROFILE_SCOPE(VoiceOscillator2);
+            osc2.renderBlock(osc2Sample, numSamples);
+
+            if (osc2FMAmount > 0.0f)
+            {
+                juce::FloatVectorOperations::multiply(modulationBuffer, osc2Sample, osc2FMAmount * MAX_FM_CYCLES, numSamples);
+                modulation.phaseOffset = modulationBuffer;
+            }
+
+            if (osc2Sync)
+                modulation.syncSource = &osc2;
+        }
+
+        {
+            CYNTHIA_PROFILE_SCOPE(VoiceOscillator);
+            osc.renderBlock(sample, numSamples, positionModulation, modulation);
+        }
+
+        if (usesOsc2)
+        {
+            CYNTHIA_PROFILE_SCOPE(VoiceOscillator2);
+
+            // ring mod crossfades oscillator 1 into oscillator 1 times oscillator 2.
+            // the phase offsets have been used by now, so their buffer holds the gain
+            if (osc2RingMod > 0.0f)
+            {
+                juce::FloatVectorOperations::multiply(modulationBuffer, osc2Sample, osc2RingMod, numSamples);
+                juce::FloatVectorOperations::add(modulationBuffer, 1.0f - osc2RingMod, numSamples);
+                juce::FloatVectorOperations::multiply(sample, modulationBuffer, numSamples);
+            }
+
+            if (osc2Level > 0.0f)
+                juce::FloatVectorOperations::addWithMultiply(sample, osc2Sample, osc2Level, numSamples);
+        }
+
+        // the noise goes through the filter along with the oscillator
+        if (noiseLevel > 0.0f)
+        {
+            CYNTHIA_PROFILE_SCOPE(VoiceNoise);
+            noise.renderBlock(noiseSample, numSamples);
+            juce::FloatVectorOperations::addWithMultiply(sample, noiseSample, noiseLevel, numSamples);
+        }
+
+        {
+            CYNTHIA_PROFILE_SCOPE(VoiceEnvelope);
+            env.renderBlock(envelope, numSamples);
+        }
+
+        {
+            CYNTHIA_PROFILE_SCOPE(VoiceFilter);
+            filter.processBlock(sample, numSamples);
+        }
+
+        CYNTHIA_PROFILE_SCOPE(VoiceOutput);
+        float amplitudeDepth = lfo.getModDepth();
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float amplitudeModulator = 1.0f + lfoValue[i] * amplitudeDepth;
+            amplitudeModulator = juce::jlimit(-1.0f, 1.0f, amplitudeModulator);
+
+            // our signal chain
+            output[i] += sample[i] * envelope[i] * amplitude * amplitudeModulator;
+        }
 
-        // our signal chain
-        return filtered_sample * envelope * amplitude * amplitudeModulator;
-        
         /*
             little trick for debugging the envelope or lfo: 
 
-                return envelope;
-                return lfoAmount;
+                copy envelope or lfoValue into output instead
 
             this will let us view output through oscilloscope
         */
-        
     }
 
-    void prepareWavetable(float frequency, float sampleRate)
+    // jump straight to the expression targets, used at note on so a new note doesn't glide
+    void snapExpression()
+    {
+        pitchBend = pitchBendTarget;
+        pressure = pressureTarget;
+        timbre = timbreTarget;
+        applyExpression();
+    }
+
+    // called by Synth once per control period. The smoothed values are only
+    // pushed into the oscillator and filter while they are still moving.
+    void updateExpression(float smoothing)
+    {
+        constexpr float settled = 1.0e-4f;
+
+        if (std::abs(pitchBendTarget - pitchBend) < settled
+            && std::abs(pressureTarget - pressure) < settled
+            && std::abs(timbreTarget - timbre) < settled)
+            return;
+
+        pitchBend += smoothing * (pitchBendTarget - pitchBend);
+        pressure += smoothing * (pressureTarget - pressure);
+        timbre += smoothing * (timbreTarget - timbre);
+        applyExpression();
+    }
+
+    // pitch bend -> pitch, pressure -> filter cutoff, timbre (CC74) -> morph
+    void applyExpression()
+    {
+        float bendRatio = std::exp2(pitchBend / 12.0f);
+        osc.setPitchRatio(bendRatio);
+        osc2.setPitchRatio(bendRatio);
+        filter.setCutoff(baseCutoff * std::exp2(pressure * PRESSURE_CUTOFF_OCTAVES));
+        osc.setMorphValue(baseMorph + (timbre - 0.5f) * 2.0f);
+    }
+
+    // set the pitch as a phase increment, looked up from Synth's note table
+    void setTableDeltaOsc(double newTableDelta)
+    {
+        osc.setBaseTableDelta(newTableDelta);
+        osc2.setBaseTableDelta(newTableDelta * osc2PitchRatio);
+    }
+
+    // oscillator 2 plays one factory waveform, so both its layers get the same one
+    void setWaveformIndexOsc2(int newWaveformIndex)
+    {
+        osc2.setWaveformIndices(newWaveformIndex, newWaveformIndex);
+    }
+
+    // takes effect at the next setTableDeltaOsc()
+    void setSemitonesOsc2(int semitones)
     {
-        osc.prepareWavetable(frequency, sampleRate);
+        osc2PitchRatio = std::exp2(static_cast<float>(semitones) / 12.0f);
     }
 
     void setWaveformIndicesOsc(int newWaveformIndexA, int newWaveformIndexB)
@@ -78,6 +278,22 @@ struct Voice
         osc.setWaveformIndices(newWaveformIndexA, newWaveformIndexB);
     }
 
+    void setUserWavetableOsc(const Wavetable* newUserWavetable)
+    {
+        osc.setUserWavetable(newUserWavetable);
+    }
+
+    void setInterpolationOsc(int newInterpolation)
+    {
+        osc.setInterpolation(static_cast<MorphingOscillator::Interpolation>(newInterpolation));
+        osc2.setInterpolation(static_cast<MorphingOscillator::Interpolation>(newInterpolation));
+    }
+
+    void setUseUserWavetableOsc(bool shouldUseUserWavetable)
+    {
+        osc.setUseUserWavetable(shouldUseUserWavetable);
+    }
+
     void setMorphValueOsc(float newMorphValue)
     {
         osc.setMorphValue(newMorphValue);
@@ -88,9 +304,33 @@ struct Voice
         osc.setDetuneCents(newDetuneCents);
     }
 
-    void prepareFilter(float sampleRate)
+    // start the oscillators' cycles from 0, for deterministic rendering (see Synth::setDeterministic())
+    void resetOscillators()
     {
-        filter.prepare(sampleRate);
+        osc.reset();
+        osc2.reset();
+    }
+
+    // each voice gets its own seed, so the noise of a chord isn't the same signal several times over
+    void setNoiseSeed(uint32_t seed)
+    {
+        noise.setSeed(seed);
+    }
+
+    void setNoiseType(int newType)
+    {
+        noise.setType(static_cast<NoiseGenerator::Type>(newType));
+    }
+
+    // the Filtered noise is centred on the note
+    void setNoiseFrequency(float frequency, float sampleRate)
+    {
+        noise.setFrequency(frequency, sampleRate);
+    }
+
+    void resetFilter()
+    {
+        filter.reset();
     }
 
     void setFilterType(int newType)
@@ -108,11 +348,6 @@ struct Voice
         filter.setResonance(newResonance);
     }
 
-    void prepareEnvelope(float sampleRate)
-    {
-        env.prepare(sampleRate);
-    }
-
     void setEnvelopeParameters(float attack, float decay, float sustain, float release)
     {
         env.setParameters(attack, decay, sustain, release);
@@ -0,0 +1,150 @@
+#include "Cynthia_DSP/Wavetable.h"
+#include <cstring>
+#include <juce_dsp/juce_dsp.h>
+
+namespace
+{
+    /*
+        File layout (native byte order, checked through the magic number):
+            uint32  magic ("CYNW")
+            int32   format version
+            int32   table size, mip levels, guard samples (so a layout change is caught too)
+            int32   number of frames
+            uint64  content hash
+            padding up to headerSize
+            float   samples, exactly as they're laid out in memory
+    */
+    constexpr juce::uint32 fileMagic = 0x574e5943; // "CYNW" read as a little endian uint32
+    constexpr int headerSize = 64;
+
+    struct FileHeader
+    {
+        juce::uint32 magic;
+        juce::int32 version;
+        juce::int32 tableSize;
+        juce::int32 numMipLevels;
+        juce::int32 guardSamples;
+        juce::int32 numFrames;
+        juce::uint64 contentHash;
+    };
+
+    static_assert(sizeof(FileHeader) <= headerSize, "the header must fit in front of the samples");
+}
+
+Wavetable::Wavetable(int numFramesToUse, const juce::String& nameToUse)
+    : numFrames(numFramesToUse),
+      name(nameToUse),
+      ownedSamples(getTotalNumSamples(numFramesToUse), 0.0f),
+      samples(ownedSamples.data())
+{
+}
+
+Wavetable::Wavetable(std::unique_ptr<juce::MemoryMappedFile> mappedFileToUse, const float* mappedSamples, int numFramesToUse, const juce::String& nameToUse)
+    : numFrames(numFramesToUse),
+      name(nameToUse),
+      mappedFile(std::move(mappedFileToUse)),
+      samples(mappedSamples)
+{
+}
+
+bool Wavetable::writeToFile(const juce::File& file, juce::uint64 contentHash) const
+{
+    FileHeader header { fileMagic, formatVersion, tableSize, numMipLevels, guardSamples, numFrames, contentHash };
+    char paddedHeader[headerSize] = {};
+    std::memcpy(paddedHeader, &header, sizeof(header));
+
+    // another instance may map the file at any moment, so it only appears once it's complete
+    juce::TemporaryFile temporaryFile(file);
+
+    {
+        juce::FileOutputStream stream(temporaryFile.getFile());
+
+        if (! stream.openedOk()
+            || ! stream.write(paddedHeader, headerSize)
+            || ! stream.write(samples, getTotalNumSamples(numFrames) * sizeof(float)))
+            return false;
+    }
+
+    return temporaryFile.overwriteTargetFileWithTemporary();
+}
+
+Wavetable::Ptr Wavetable::loadFromFile(const juce::File& file, juce::uint64 expectedContentHash, const juce::String& name)
+{
+    if (! file.existsAsFile())
+        return nullptr;
+
+    auto mapped = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly, false);
+
+    if (mapped->getData() == nullptr || mapped->getSize() < static_cast<size_t>(headerSize))
+        return nullptr;
+
+    FileHeader header;
+    std::memcpy(&header, mapped->getData(), sizeof(header));
+
+    if (header.magic != fileMagic
+        || header.version != formatVersion
+        || header.tableSize != tableSize
+        || header.numMipLevels != numMipLevels
+        || header.guardSamples != guardSamples
+        || header.numFrames < 1 || header.numFrames > maxFrames
+        || header.contentHash != expectedContentHash
+        || mapped->getSize() != headerSize + getTotalNumSamples(header.numFrames) * sizeof(float))
+        return nullptr;
+
+    auto* mappedSamples = reinterpret_cast<const float*>(static_cast<const char*>(mapped->getData()) + headerSize);
+    return new Wavetable(std::move(mapped), mappedSamples, header.numFrames, name);
+}
+
+/*
+    Every frame is transformed once. Each mip level is then the inverse transform of that
+    spectrum with the harmonics above the level's limit removed. The DC offset and the
+    Nyquist bin are removed from every level.
+*/
+Wavetable::Ptr Wavetable::build(const float* frames, int numFrames, const juce::String& name)
+{
+    jassert(frames != nullptr && numFrames > 0);
+
+    numFrames = juce::jlimit(1, maxFrames, numFrames);
+    Ptr wavetable = new Wavetable(numFrames, name);
+
+    constexpr int fftOrder = 11;
+    static_assert((1 << fftOrder) == tableSize, "the FFT size must match the table size");
+    constexpr int numHarmonics = tableSize / 2;
+
+    juce::dsp::FFT fft(fftOrder);
+    std::vector<float> spectrum(2 * tableSize);
+    std::vector<float> levelData(2 * tableSize);
+
+    for (int frame = 0; frame < numFrames; ++frame)
+    {
+        std::fill(spectrum.begin(), spectrum.end(), 0.0f);
+        std::copy(frames + frame * tableSize, frames + (frame + 1) * tableSize, spectrum.begin());
+
+        fft.performRealOnlyForwardTransform(spectrum.data(), true);
+
+        // bins are interleaved real/imaginary pairs, bin h is harmonic h
+        spectrum[0] = spectrum[1] = 0.0f;
+        spectrum[2 * numHarmonics] = spectrum[2 * numHarmonics + 1] = 0.0f;
+
+        for (int level = 0; level < numMipLevels; ++level)
+        {
+            int maxHarmonic = numHarmonics >> level;
+
+            std::copy(spectrum.begin(), spectrum.end(), levelData.begin());
+            std::fill(levelData.begin() + 2 * (maxHarmonic + 1), levelData.end(), 0.0f);
+
+            fft.performRealOnlyInverseTransform(levelData.data());
+
+            auto* table = wavetable->getWritableTable(frame, level);
+            std::copy(levelData.begin(), levelData.begin() + tableSize, table);
+
+            for (int guard = 1; guard <= guardSamples; ++guard)
+            {
+                table[-guard] = table[tableSize - guard];
+                table[tableSize + guard - 1] = table[guard - 1];
+            }
+        }
+    }
+
+    return wavetable;
+}
@@ -0,0 +1,95 @@
+/*
+    Wavetable.h
+
+    An immutable, band-limited wavetable: one or more single-cycle frames, each stored as a
+    set of mipmaps (one per octave) so high notes don't alias.
+
+    All the samples live in one contiguous block. For every mip level, the frames sit next to
+    each other, so neighbouring frames at the pitch a voice is playing share cache lines.
+    Every table has a few guard samples copied from the other end on both sides, so
+    interpolation can read past either end without wrapping the index.
+
+    Building a Wavetable runs FFTs and allocates, so it happens off the audio thread.
+    Once built it never changes, which is what makes handing it to the audio thread safe.
+
+    A built table can be written to a file and later memory-mapped back read-only
+    (see WavetableCache), which skips building altogether.
+*/
+
+#pragma once
+
+#include <vector>
+#include <juce_core/juce_core.h>
+
+class Wavetable : public juce::ReferenceCountedObject
+{
+public:
+
+    using Ptr = juce::ReferenceCountedObjectPtr<Wavetable>;
+
+    static constexpr int tableSize = 2048;      // samples per frame
+    static constexpr int maxFrames = 256;
+    static constexpr int numMipLevels = 11;     // level k keeps the lowest (tableSize / 2) >> k harmonics
+    static constexpr int guardSamples = 4;      // on either side of every table
+    static constexpr int stride = tableSize + 2 * guardSamples;
+
+    // bump this whenever build() or the layout changes, so stale cache files are rebuilt
+    static constexpr int formatVersion = 1;
+
+    // band-limit numFrames frames of tableSize samples each (stored one after another).
+    // slow and allocating, so never call it from the audio thread
+    static Ptr build(const float* frames, int numFrames, const juce::String& name = {});
+
+    // write the mipmaps to a file that loadFromFile() can map. Returns false on failure
+    bool writeToFile(const juce::File& file, juce::uint64 contentHash) const;
+
+    // memory-map a file written by writeToFile(). Returns nullptr if it's missing, was written
+    // by another format version or for other content
+    static Ptr loadFromFile(const juce::File& file, juce::uint64 expectedContentHash, const juce::String& name = {});
+
+    bool isMemoryMapped() const noexcept { return mappedFile != nullptr; }
+
+    int getNumFrames() const noexcept { return numFrames; }
+    const juce::String& getName() const noexcept { return name; }
+
+    // sample 0 of a frame at a mip level. Indices -guardSamples to tableSize + guardSamples - 1 are valid
+    const float* getTable(int frame, int mipLevel) const noexcept
+    {
+        return samples + static_cast<size_t>(mipLevel * numFrames + frame) * stride + guardSamples;
+    }
+
+    // the mip level that won't alias when reading tableDelta table samples per output sample.
+    // this depends only on the phase increment, so the same tables work at every sample rate
+    static int getMipLevel(double tableDelta) noexcept
+    {
+        if (tableDelta <= 1.0)
+            return 0;
+
+        return juce::jmin(numMipLevels - 1, static_cast<int>(std::ceil(std::log2(tableDelta))));
+    }
+
+private:
+
+    Wavetable(int numFrames, const juce::String& name);
+    Wavetable(std::unique_ptr<juce::MemoryMappedFile> mappedFile, const float* mappedSamples, int numFrames, const juce::String& name);
+
+    static size_t getTotalNumSamples(int numFrames) noexcept
+    {
+        return static_cast<size_t>(numMipLevels * numFrames * stride);
+    }
+
+    float* getWritableTable(int frame, int mipLevel) noexcept
+    {
+        return ownedSamples.data() + static_cast<size_t>(mipLevel * numFrames + frame) * stride + guardSamples;
+    }
+
+    int numFrames;
+    juce::String name;
+
+    // the samples are either owned (built here) or live in a read-only mapped file
+    std::vector<float> ownedSamples;
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    const float* samples = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Wavetable)
+};
@@ -0,0 +1,197 @@
+#include "Cynthia_DSP/WavetableCache.h"
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace
+{
+    const juce::String fileExtension = ".cyntable";
+
+    struct CacheState
+    {
+        juce::CriticalSection lock;
+        juce::File directory = WavetableCache::getDefaultDirectory();
+        juce::int64 maximumSize = WavetableCache::defaultMaximumSize;
+        std::map<juce::uint64, Wavetable::Ptr> sharedTables;
+    };
+
+    CacheState& getState()
+    {
+        static CacheState state;
+        return state;
+    }
+
+    // drop the tables nobody but the cache refers to any more
+    void removeUnusedTables(std::map<juce::uint64, Wavetable::Ptr>& tables)
+    {
+        for (auto entry = tables.begin(); entry != tables.end();)
+        {
+            if (entry->second->getReferenceCount() == 1)
+                entry = tables.erase(entry);
+            else
+                ++entry;
+        }
+    }
+
+    // e.g. "-v1.cyntable"
+    juce::String getVersionSuffix()
+    {
+        return "-v" + juce::String(Wavetable::formatVersion) + fileExtension;
+    }
+
+    /*
+        Deletes the files of other format versions (nothing can ever load them again), then the
+        least recently used tables until the rest fits. The table just written is always kept.
+        A file another process still has mapped may refuse to go; it's simply tried again next time.
+    */
+    void trimDirectory(const juce::File& directory, juce::int64 maximumSize, const juce::File& newestFile)
+    {
+        struct CachedFile
+        {
+            juce::File file;
+            juce::int64 size;
+            juce::Time lastUsed;
+        };
+
+        std::vector<CachedFile> cachedFiles;
+        juce::int64 totalSize = 0;
+
+        for (const auto& entry : juce::RangedDirectoryIterator(directory, false, "*" + fileExtension, juce::File::findFiles))
+        {
+            auto file = entry.getFile();
+            auto hash = file.getFileNameWithoutExtension().upToFirstOccurrenceOf("-v", false, false);
+
+            // not a table, e.g. a temporary file still being written
+            if (hash.isEmpty() || ! hash.containsOnly("0123456789abcdef"))
+                continue;
+
+            if (! file.getFileName().endsWith(getVersionSuffix()))
+            {
+                file.deleteFile();
+                continue;
+            }
+
+            cachedFiles.push_back({ file, entry.getFileSize(), file.getLastAccessTime() });
+            totalSize += entry.getFileSize();
+        }
+
+        std::sort(cachedFiles.begin(), cachedFiles.end(), [](const CachedFile& a, const CachedFile& b)
+        {
+            return a.lastUsed < b.lastUsed;
+        });
+
+        for (const auto& cachedFile : cachedFiles)
+        {
+            if (totalSize <= maximumSize)
+                break;
+
+            if (cachedFile.file != newestFile && cachedFile.file.deleteFile())
+                totalSize -= cachedFile.size;
+        }
+    }
+}
+
+juce::uint64 WavetableCache::computeContentHash(const float* frames, int numFrames)
+{
+    // 64-bit FNV-1a over the raw sample bytes, seeded with the format version
+    juce::uint64 hash = 0xcbf29ce484222325ULL ^ static_cast<juce::uint64>(Wavetable::formatVersion);
+
+    auto* bytes = reinterpret_cast<const juce::uint8*>(frames);
+    auto numBytes = static_cast<size_t>(numFrames) * Wavetable::tableSize * sizeof(float);
+
+    for (size_t index = 0; index < numBytes; ++index)
+    {
+        hash ^= bytes[index];
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+juce::File WavetableCache::getDefaultDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("Cynthia")
+        .getChildFile("WavetableCache");
+}
+
+void WavetableCache::setDirectory(const juce::File& newDirectory)
+{
+    auto& state = getState();
+    const juce::ScopedLock scopedLock(state.lock);
+    state.directory = newDirectory;
+}
+
+juce::File WavetableCache::getDirectory()
+{
+    auto& state = getState();
+    const juce::ScopedLock scopedLock(state.lock);
+    return state.directory;
+}
+
+juce::File WavetableCache::getFile(juce::uint64 contentHash)
+{
+    return getDirectory().getChildFile(juce::String::toHexString(static_cast<juce::int64>(contentHash)) + getVersionSuffix());
+}
+
+void WavetableCache::setMaximumSize(juce::int64 numBytes)
+{
+    auto& state = getState();
+    const juce::ScopedLock scopedLock(state.lock);
+    state.maximumSize = numBytes;
+}
+
+juce::int64 WavetableCache::getMaximumSize()
+{
+    auto& state = getState();
+    const juce::ScopedLock scopedLock(state.lock);
+    return state.maximumSize;
+}
+
+void WavetableCache::clearSharedTables()
+{
+    auto& state = getState();
+    const juce::ScopedLock scopedLock(state.lock);
+    state.sharedTables.clear();
+}
+
+/*
+    The lock is held while building, so two instances asking for the same new table at once
+    build it once between them. Building only happens on the message thread or a background
+    thread, so nothing real-time ever waits for it.
+*/
+Wavetable::Ptr WavetableCache::getOrBuild(const float* frames, int numFrames, const juce::String& name)
+{
+    numFrames = juce::jlimit(1, Wavetable::maxFrames, numFrames);
+    auto contentHash = computeContentHash(frames, numFrames);
+
+    auto& state = getState();
+    const juce::ScopedLock scopedLock(state.lock);
+
+    removeUnusedTables(state.sharedTables);
+
+    auto shared = state.sharedTables.find(contentHash);
+    if (shared != state.sharedTables.end())
+        return shared->second;
+
+    auto file = getFile(contentHash);
+
+    Wavetable::Ptr wavetable = Wavetable::loadFromFile(file, contentHash, name);
+
+    if (wavetable != nullptr)
+    {
+        // what trimming goes by, whether or not the file system keeps access times itself
+        file.setLastAccessTime(juce::Time::getCurrentTime());
+    }
+    else
+    {
+        wavetable = Wavetable::build(frames, numFrames, name);
+
+        // a read-only or full disk only costs the next startup a rebuild
+        if (state.directory.createDirectory() && wavetable->writeToFile(file, contentHash))
+            trimDirectory(state.directory, state.maximumSize, file);
+    }
+
+    state.sharedTables[contentHash] = wavetable;
+    return wavetable;
+}
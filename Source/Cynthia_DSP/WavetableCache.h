@@ -0,0 +1,50 @@
+/*
+    WavetableCache.h
+
+    Builds each distinct wavetable once, ever.
+
+    Tables are keyed by a hash of their source frames. The first time a table is needed it is
+    built and written to the cache folder; after that (in this or any later process) the file is
+    memory-mapped read-only, so loading is just mapping pages the OS most likely already has.
+    Within a process, every instance asking for the same content gets the same Wavetable object.
+
+    The mipmaps are chosen by phase increment rather than frequency, so one set of tables
+    serves every sample rate and the sample rate isn't part of the key.
+
+    File names carry the format version. Whenever a new table is written, files from other
+    versions are deleted, and then the least recently used tables until the folder fits the
+    maximum size again.
+*/
+
+#pragma once
+
+#include "Cynthia_DSP/Wavetable.h"
+
+namespace WavetableCache
+{
+    // the shared table for these frames (tableSize samples each, one after another),
+    // mapped from the cache if possible and built (then cached) if not.
+    // may build, so never call it from the audio thread
+    Wavetable::Ptr getOrBuild(const float* frames, int numFrames, const juce::String& name = {});
+
+    // the hash getOrBuild() uses as the key
+    juce::uint64 computeContentHash(const float* frames, int numFrames);
+
+    juce::File getDefaultDirectory();
+
+    // where the cache files live. Mostly for tests
+    void setDirectory(const juce::File& newDirectory);
+    juce::File getDirectory();
+
+    // the file a table with this content hash is cached in
+    juce::File getFile(juce::uint64 contentHash);
+
+    // how many bytes of tables the folder may hold
+    static constexpr juce::int64 defaultMaximumSize = 256 * 1024 * 1024;
+    void setMaximumSize(juce::int64 numBytes);
+    juce::int64 getMaximumSize();
+
+    // forget the tables shared within this process (the files stay), so the next request maps
+    // its file again. Tables still in use are unaffected
+    void clearSharedTables();
+}
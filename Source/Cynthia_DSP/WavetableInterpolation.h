@@ -0,0 +1,142 @@
+/*
+    WavetableInterpolation.h
+
+    The ways an oscillator can read between wavetable samples, from cheapest to cleanest:
+
+        Linear   2 points. Cheap, but its droop and images are audible on bright tables
+        Hermite  4 points (Catmull-Rom). Most of the quality for little extra cost
+        Sinc     8 point windowed sinc, polyphase. The cleanest, for patches that need it
+
+    Every kernel takes the table, the integer index and the fraction, and may read up to
+    3 samples before and 4 after the index, which the wavetable's guard samples allow.
+    The sinc kernel is a fixed length dot product over contiguous samples and precomputed
+    coefficients, which compilers vectorise.
+*/
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <juce_core/juce_core.h>
+#include "Cynthia_DSP/PhaseAccumulator.h"
+#include "Cynthia_DSP/Wavetable.h"
+
+namespace WavetableInterpolation
+{
+    enum class Mode
+    {
+        Linear,
+        Hermite,
+        Sinc
+    };
+
+    static_assert(Wavetable::guardSamples >= 4, "the 8 point kernel reads 3 samples before and 4 after the index");
+
+    inline float linear(const float* table, int index, float frac) noexcept
+    {
+        float value0 = table[index];
+        float value1 = table[index + 1];
+
+        return value0 + frac * (value1 - value0);
+    }
+
+    inline float hermite(const float* table, int index, float frac) noexcept
+    {
+        float y0 = table[index - 1];
+        float y1 = table[index];
+        float y2 = table[index + 1];
+        float y3 = table[index + 2];
+
+        float c1 = 0.5f * (y2 - y0);
+        float c2 = y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3;
+        float c3 = 0.5f * (y3 - y0) + 1.5f * (y1 - y2);
+
+        return ((c3 * frac + c2) * frac + c1) * frac + y1;
+    }
+
+    // Blackman-Harris windowed sinc coefficients for numPhases fractions (plus one extra, so the
+    // last phase can be interpolated towards), every phase normalised to unity gain
+    struct SincKernel
+    {
+        static constexpr int numTaps = 8;
+        static constexpr int numPhases = 256;
+
+        alignas(32) std::array<std::array<float, numTaps>, numPhases + 1> coefficients;
+
+        SincKernel()
+        {
+            constexpr double pi = juce::MathConstants<double>::pi;
+            constexpr double halfWidth = numTaps / 2;
+
+            for (int phase = 0; phase <= numPhases; ++phase)
+            {
+                double frac = static_cast<double>(phase) / numPhases;
+                double sum = 0.0;
+
+                for (int tap = 0; tap < numTaps; ++tap)
+                {
+                    // tap 0 is the sample 3 before the index
+                    double x = (tap - 3) - frac;
+                    double sinc = std::abs(x) < 1.0e-9 ? 1.0 : std::sin(pi * x) / (pi * x);
+
+                    double w = (x + halfWidth) / (2.0 * halfWidth);
+                    double window = 0.35875
+                                  - 0.48829 * std::cos(2.0 * pi * w)
+                                  + 0.14128 * std::cos(4.0 * pi * w)
+                                  - 0.01168 * std::cos(6.0 * pi * w);
+
+                    coefficients[static_cast<size_t>(phase)][static_cast<size_t>(tap)] = static_cast<float>(sinc * window);
+                    sum += sinc * window;
+                }
+
+                for (auto& coefficient : coefficients[static_cast<size_t>(phase)])
+                    coefficient = static_cast<float>(coefficient / sum);
+            }
+        }
+    };
+
+    // built when the plugin is loaded, with the other globals. A function-local static would be
+    // built the first time a voice plays sinc, on the audio thread and behind a lock
+    inline const SincKernel sincKernel;
+
+    inline const SincKernel& getSincKernel() noexcept
+    {
+        return sincKernel;
+    }
+
+    inline float sinc(const float* table, int index, float frac) noexcept
+    {
+        const auto& kernel = getSincKernel();
+
+        // frac can round up to exactly 1, which still needs a next phase to interpolate towards
+        float phasePosition = frac * SincKernel::numPhases;
+        int phase = juce::jmin(static_cast<int>(phasePosition), SincKernel::numPhases - 1);
+        float phaseFrac = phasePosition - static_cast<float>(phase);
+
+        const float* coefficients0 = kernel.coefficients[static_cast<size_t>(phase)].data();
+        const float* coefficients1 = kernel.coefficients[static_cast<size_t>(phase + 1)].data();
+        const float* samples = table + index - 3;
+
+        float sum = 0.0f;
+
+        for (int tap = 0; tap < SincKernel::numTaps; ++tap)
+            sum += samples[tap] * (coefficients0[tap] + phaseFrac * (coefficients1[tap] - coefficients0[tap]));
+
+        return sum;
+    }
+
+    // read the table at a fixed-point phase (see PhaseAccumulator.h)
+    template <Mode mode>
+    inline float read(const float* table, PhaseAccumulator::Phase phase) noexcept
+    {
+        int index = PhaseAccumulator::getIndex(phase);
+        float frac = PhaseAccumulator::getFraction(phase);
+
+        if constexpr (mode == Mode::Linear)
+            return linear(table, index, frac);
+        else if constexpr (mode == Mode::Hermite)
+            return hermite(table, index, frac);
+        else
+            return sinc(table, index, frac);
+    }
+}
@@ -1,10 +1,16 @@
 #include "Cynthia_UI/ADSRComponent.h"
 
-ADSRComponent::ADSRComponent(APVTS &apvts) :    attackLevelAttachment(apvts, ParameterID::envAttack.getParamID(), attackLevelKnob),
+ADSRComponent::ADSRComponent(APVTS &apvts, VoicePlayheads &playheads, RepaintCoalescer &coalescer) : attackLevelAttachment(apvts, ParameterID::envAttack.getParamID(), attackLevelKnob),
                                                 decayLevelAttachment(apvts, ParameterID::envDecay.getParamID(), decayLevelKnob),
                                                 sustainLevelAttachment(apvts, ParameterID::envSustain.getParamID(), sustainLevelKnob),
-                                                releaseLevelAttachment(apvts, ParameterID::envRelease.getParamID(), releaseLevelKnob)
+                                                releaseLevelAttachment(apvts, ParameterID::envRelease.getParamID(), releaseLevelKnob),
+                                                envelopeDisplay(apvts, playheads, coalescer)
 {
+    // paint() fills the whole module, so nothing behind it ever needs repainting
+    setOpaque(true);
+
+    addAndMakeVisible(envelopeDisplay);
+
     configureKnob(attackLevelKnob);
     configureKnob(decayLevelKnob);
     configureKnob(sustainLevelKnob);
@@ -31,6 +37,10 @@ void ADSRComponent::paint(juce::Graphics &g)
 void ADSRComponent::resized()
 {
     auto bounds = getLocalBounds().reduced(10);
+
+    // the curve preview sits under the header, the controls share the rest
+    envelopeDisplay.setBounds(bounds.removeFromTop(bounds.getHeight()/3).withTrimmedTop(10));
+
     auto adsrModuleArea = bounds;
     int knobSize = std::min(adsrModuleArea.getWidth()/numComponents, adsrModuleArea.getHeight()-30);
 
@@ -1,13 +1,14 @@
 #pragma once
 
 #include "Cynthia_UI/SynthUIModule.h"
+#include "Cynthia_UI/EnvelopeDisplay.h"
 
 
 class ADSRComponent : public SynthUIModule
 {
 public:
 
-    ADSRComponent(APVTS& apvts);
+    ADSRComponent(APVTS& apvts, VoicePlayheads &playheads, RepaintCoalescer &coalescer);
     
 private:
 
@@ -40,5 +41,8 @@ private:
     SliderAttachment sustainLevelAttachment;
     SliderAttachment releaseLevelAttachment;
 
+    // previews the parameters above, with a dot per sounding voice
+    EnvelopeDisplay envelopeDisplay;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ADSRComponent)
 };
\ No newline at end of file
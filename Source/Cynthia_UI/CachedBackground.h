@@ -0,0 +1,45 @@
+/*
+    CachedBackground.h
+
+    Keeps the static part of a component's painting in an image, so paint() only blits it and
+    draws what actually moves on top. The image is made at the display's pixel density, and
+    redrawn after invalidate() or when the size (or density) changes.
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+class CachedBackground
+{
+public:
+    // the next draw() paints the background again
+    void invalidate()
+    {
+        image = {};
+    }
+
+    // paintBackground(juce::Graphics&) draws into the cache, in component coordinates
+    template <typename PaintFunction>
+    void draw(juce::Graphics &g, juce::Rectangle<int> bounds, PaintFunction &&paintBackground)
+    {
+        float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        int width = juce::jmax(1, juce::roundToInt(static_cast<float>(bounds.getWidth()) * scale));
+        int height = juce::jmax(1, juce::roundToInt(static_cast<float>(bounds.getHeight()) * scale));
+
+        if (image.isNull() || image.getWidth() != width || image.getHeight() != height)
+        {
+            image = juce::Image(juce::Image::ARGB, width, height, true);
+
+            juce::Graphics imageGraphics(image);
+            imageGraphics.addTransform(juce::AffineTransform::translation(static_cast<float>(-bounds.getX()), static_cast<float>(-bounds.getY()))
+                                           .scaled(scale));
+            paintBackground(imageGraphics);
+        }
+
+        g.drawImage(image, bounds.toFloat());
+    }
+
+private:
+    juce::Image image;
+};
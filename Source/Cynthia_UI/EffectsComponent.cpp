@@ -0,0 +1,110 @@
+#include "Cynthia_UI/EffectsComponent.h"
+
+EffectsComponent::EffectsComponent(APVTS &apvts) : chorusMixAttachment(apvts, ParameterID::chorusMix.getParamID(), chorusMixKnob),
+                                                   chorusRateAttachment(apvts, ParameterID::chorusRate.getParamID(), chorusRateKnob),
+                                                   chorusDepthAttachment(apvts, ParameterID::chorusDepth.getParamID(), chorusDepthKnob),
+                                                   delayMixAttachment(apvts, ParameterID::delayMix.getParamID(), delayMixKnob),
+                                                   delayTimeAttachment(apvts, ParameterID::delayTime.getParamID(), delayTimeComboBox),
+                                                   delayFeedbackAttachment(apvts, ParameterID::delayFeedback.getParamID(), delayFeedbackKnob),
+                                                   reverbMixAttachment(apvts, ParameterID::reverbMix.getParamID(), reverbMixKnob),
+                                                   reverbSizeAttachment(apvts, ParameterID::reverbSize.getParamID(), reverbSizeKnob),
+                                                   reverbDampingAttachment(apvts, ParameterID::reverbDamping.getParamID(), reverbDampingKnob)
+{
+    // paint() fills the whole module, so nothing behind it ever needs repainting
+    setOpaque(true);
+
+    configureKnob(chorusMixKnob);
+    configureKnob(chorusRateKnob);
+    configureKnob(chorusDepthKnob);
+    configureKnob(delayMixKnob);
+    configureComboBox(delayTimeComboBox, juce::StringArray{"1/16", "1/8", "1/8 D", "1/4", "1/4 D", "1/2", "1/1"});
+    configureKnob(delayFeedbackKnob);
+    configureKnob(reverbMixKnob);
+    configureKnob(reverbSizeKnob);
+    configureKnob(reverbDampingKnob);
+
+    configureComponentLabel(chorusMixLabel, juce::String("Chorus"));
+    configureComponentLabel(chorusRateLabel, juce::String("Rate"));
+    configureComponentLabel(chorusDepthLabel, juce::String("Depth"));
+    configureComponentLabel(delayMixLabel, juce::String("Delay"));
+    configureComponentLabel(delayTimeLabel, juce::String("Time"));
+    configureComponentLabel(delayFeedbackLabel, juce::String("Feedback"));
+    configureComponentLabel(reverbMixLabel, juce::String("Reverb"));
+    configureComponentLabel(reverbSizeLabel, juce::String("Size"));
+    configureComponentLabel(reverbDampingLabel, juce::String("Damping"));
+}
+
+void EffectsComponent::paint(juce::Graphics &g)
+{
+    g.fillAll(juce::Colours::black);
+    g.setColour(juce::Colours::red);
+    g.drawRect(getLocalBounds(), 1);
+    g.drawText(
+        moduleHeader,
+        getLocalBounds()
+            .removeFromTop(20),
+        juce::Justification::centred);
+}
+
+void EffectsComponent::resized()
+{
+    auto bounds = getLocalBounds().reduced(10);
+    auto effectsModuleArea = bounds;
+    int knobSize = std::min(effectsModuleArea.getWidth()/numComponents, effectsModuleArea.getHeight()-30);
+    int comboBoxSize = knobSize;
+
+    juce::FlexBox row;
+    row.flexDirection = juce::FlexBox::Direction::row;
+    row.justifyContent = juce::FlexBox::JustifyContent::spaceAround;
+    row.alignItems = juce::FlexBox::AlignItems::center;
+
+    auto chorusMixColumn = makeComponentWithLabel(chorusMixKnob, chorusMixLabel, knobSize/4, knobSize, knobSize, knobSize);
+    auto chorusRateColumn = makeComponentWithLabel(chorusRateKnob, chorusRateLabel, knobSize/4, knobSize, knobSize, knobSize);
+    auto chorusDepthColumn = makeComponentWithLabel(chorusDepthKnob, chorusDepthLabel, knobSize/4, knobSize, knobSize, knobSize);
+    auto delayMixColumn = makeComponentWithLabel(delayMixKnob, delayMixLabel, knobSize/4, knobSize, knobSize, knobSize);
+    auto delayTimeColumn = makeComponentWithLabel(delayTimeComboBox, delayTimeLabel, comboBoxSize/3, comboBoxSize, comboBoxSize/3, comboBoxSize);
+    auto delayFeedbackColumn = makeComponentWithLabel(delayFeedbackKnob, delayFeedbackLabel, knobSize/4, knobSize, knobSize, knobSize);
+    auto reverbMixColumn = makeComponentWithLabel(reverbMixKnob, reverbMixLabel, knobSize/4, knobSize, knobSize, knobSize);
+    auto reverbSizeColumn = makeComponentWithLabel(reverbSizeKnob, reverbSizeLabel, knobSize/4, knobSize, knobSize, knobSize);
+    auto reverbDampingColumn = makeComponentWithLabel(reverbDampingKnob, reverbDampingLabel, knobSize/4, knobSize, knobSize, knobSize);
+
+    for (auto *column : { &chorusMixColumn, &chorusRateColumn, &chorusDepthColumn,
+                          &delayMixColumn, &delayTimeColumn, &delayFeedbackColumn,
+                          &reverbMixColumn, &reverbSizeColumn, &reverbDampingColumn })
+        row.items.add(juce::FlexItem(*column).withFlex(1.0f).withMargin({5, 5, 5, 5}));
+
+    row.performLayout(effectsModuleArea);
+
+    auto columnWidth = effectsModuleArea.getWidth()/numComponents;
+
+    for (auto *column : { &chorusMixColumn, &chorusRateColumn, &chorusDepthColumn,
+                          &delayMixColumn, &delayTimeColumn, &delayFeedbackColumn,
+                          &reverbMixColumn, &reverbSizeColumn, &reverbDampingColumn })
+        column->performLayout(effectsModuleArea.removeFromLeft(columnWidth).reduced(5));
+}
+
+void EffectsComponent::configureKnob(juce::Slider &knob)
+{
+    knob.setSliderStyle(juce::Slider::SliderStyle::Rotary);
+    knob.setTextBoxStyle(
+        juce::Slider::TextEntryBoxPosition::TextBoxBelow,
+        false,
+        50,
+        15);
+
+    addAndMakeVisible(knob);
+}
+
+void EffectsComponent::configureComboBox(juce::ComboBox &comboBox, const juce::StringArray &items)
+{
+    comboBox.addItemList(items, 1);
+    addAndMakeVisible(comboBox);
+}
+
+void EffectsComponent::configureComponentLabel(juce::Label &componentLabel, const juce::String &componentLabelText)
+{
+    componentLabel.setText(componentLabelText, juce::dontSendNotification);
+    componentLabel.setJustificationType(juce::Justification::centred);
+    componentLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+    addAndMakeVisible(componentLabel);
+}
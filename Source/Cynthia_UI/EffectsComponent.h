@@ -0,0 +1,53 @@
+#pragma once
+#include "Cynthia_UI/SynthUIModule.h"
+
+// chorus, delay and reverb, in the order the sound goes through them
+class EffectsComponent : public SynthUIModule
+{
+public:
+    EffectsComponent(APVTS &apvts);
+
+private:
+    void paint(juce::Graphics &g) override;
+    void resized() override;
+
+    void configureKnob(juce::Slider &knob) override;
+    void configureComboBox(juce::ComboBox &comboBox, const juce::StringArray &items) override;
+    void configureComponentLabel(juce::Label &componentLabel, const juce::String &componentLabelText) override;
+
+    const juce::String moduleHeader = "Effects";
+    const int numComponents = 9;
+
+    juce::Slider chorusMixKnob;
+    juce::Slider chorusRateKnob;
+    juce::Slider chorusDepthKnob;
+    juce::Slider delayMixKnob;
+    juce::ComboBox delayTimeComboBox;
+    juce::Slider delayFeedbackKnob;
+    juce::Slider reverbMixKnob;
+    juce::Slider reverbSizeKnob;
+    juce::Slider reverbDampingKnob;
+
+    juce::Label chorusMixLabel;
+    juce::Label chorusRateLabel;
+    juce::Label chorusDepthLabel;
+    juce::Label delayMixLabel;
+    juce::Label delayTimeLabel;
+    juce::Label delayFeedbackLabel;
+    juce::Label reverbMixLabel;
+    juce::Label reverbSizeLabel;
+    juce::Label reverbDampingLabel;
+
+    // declared after the controls, so they're destroyed first
+    SliderAttachment chorusMixAttachment;
+    SliderAttachment chorusRateAttachment;
+    SliderAttachment chorusDepthAttachment;
+    SliderAttachment delayMixAttachment;
+    ComboBoxAttachment delayTimeAttachment;
+    SliderAttachment delayFeedbackAttachment;
+    SliderAttachment reverbMixAttachment;
+    SliderAttachment reverbSizeAttachment;
+    SliderAttachment reverbDampingAttachment;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EffectsComponent)
+};
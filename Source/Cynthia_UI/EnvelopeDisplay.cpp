@@ -0,0 +1,139 @@
+#include "Cynthia_UI/EnvelopeDisplay.h"
+#include "Cynthia_Utilities/Utils.h"
+
+namespace
+{
+    const juce::String envelopeParameterIDs[] = {
+        ParameterID::envAttack.getParamID(),
+        ParameterID::envDecay.getParamID(),
+        ParameterID::envSustain.getParamID(),
+        ParameterID::envRelease.getParamID()
+    };
+}
+
+EnvelopeDisplay::EnvelopeDisplay(juce::AudioProcessorValueTreeState &apvts, VoicePlayheads &playheads, RepaintCoalescer &coalescer)
+    : apvts(apvts), playheads(playheads), coalescer(coalescer)
+{
+    setOpaque(true);
+
+    for (const auto &parameterID : envelopeParameterIDs)
+        apvts.addParameterListener(parameterID, this);
+
+    playheads.addReader();
+    coalescer.addClient(*this, *this, frameRate);
+}
+
+EnvelopeDisplay::~EnvelopeDisplay()
+{
+    coalescer.removeClient(*this);
+    playheads.removeReader();
+
+    for (const auto &parameterID : envelopeParameterIDs)
+        apvts.removeParameterListener(parameterID, this);
+}
+
+void EnvelopeDisplay::parameterChanged(const juce::String &, float)
+{
+    curveNeedsRebuild.store(true);
+}
+
+bool EnvelopeDisplay::updateFrame()
+{
+    if (curveNeedsRebuild.exchange(false))
+    {
+        rebuildCurve();
+        return true;
+    }
+
+    // only redraw while there are dots to move, plus once more to clear the last ones
+    bool hasPlayheads = false;
+    for (int voice = 0; voice < playheads.getNumVoices() && ! hasPlayheads; ++voice)
+        hasPlayheads = playheads.get(voice).state != VoicePlayheads::State::Idle;
+
+    bool needsRepaint = hasPlayheads || showedPlayheads;
+    showedPlayheads = hasPlayheads;
+    return needsRepaint;
+}
+
+void EnvelopeDisplay::rebuildCurve()
+{
+    attack = apvts.getRawParameterValue(ParameterID::envAttack.getParamID())->load();
+    decay = apvts.getRawParameterValue(ParameterID::envDecay.getParamID())->load();
+    sustain = apvts.getRawParameterValue(ParameterID::envSustain.getParamID())->load();
+    release = apvts.getRawParameterValue(ParameterID::envRelease.getParamID())->load();
+
+    float totalSeconds = juce::jmax(1.0e-3f, attack + decay + release);
+    secondsToWidth = (1.0f - sustainProportion) * plotArea.getWidth() / totalSeconds;
+
+    attackEnd = plotArea.getX() + attack * secondsToWidth;
+    decayEnd = attackEnd + decay * secondsToWidth;
+    sustainEnd = decayEnd + sustainProportion * plotArea.getWidth();
+    float releaseEnd = sustainEnd + release * secondsToWidth;
+
+    curve.clear();
+    curve.startNewSubPath(plotArea.getX(), getY(0.0f));
+    curve.lineTo(attackEnd, getY(1.0f));
+    curve.lineTo(decayEnd, getY(sustain));
+    curve.lineTo(sustainEnd, getY(sustain));
+    curve.lineTo(releaseEnd, getY(0.0f));
+
+    background.invalidate();
+}
+
+float EnvelopeDisplay::getY(float level) const
+{
+    return juce::jmap(juce::jlimit(0.0f, 1.0f, level), plotArea.getBottom(), plotArea.getY());
+}
+
+juce::Point<float> EnvelopeDisplay::getPlayheadPosition(const VoicePlayheads::Playhead &playhead) const
+{
+    float seconds = playhead.envelopeSeconds;
+    float x;
+
+    if (playhead.state == VoicePlayheads::State::Released)
+        x = sustainEnd + juce::jmin(seconds, release) * secondsToWidth;
+    else if (seconds < attack)
+        x = plotArea.getX() + seconds * secondsToWidth;
+    else if (seconds < attack + decay)
+        x = attackEnd + (seconds - attack) * secondsToWidth;
+    else
+        x = 0.5f * (decayEnd + sustainEnd); // holding
+
+    return { x, getY(playhead.envelopeLevel) };
+}
+
+void EnvelopeDisplay::paint(juce::Graphics &g)
+{
+    RepaintCoalescer::ScopedPaintTimer paintTimer(coalescer);
+
+    background.draw(g, getLocalBounds(), [this](juce::Graphics &backgroundGraphics) { paintBackground(backgroundGraphics); });
+
+    constexpr float dotSize = 6.0f;
+    g.setColour(juce::Colours::red);
+
+    for (int voice = 0; voice < playheads.getNumVoices(); ++voice)
+    {
+        auto playhead = playheads.get(voice);
+        if (playhead.state == VoicePlayheads::State::Idle)
+            continue;
+
+        auto position = getPlayheadPosition(playhead);
+        g.fillEllipse(juce::Rectangle<float>(dotSize, dotSize).withCentre(position));
+    }
+}
+
+void EnvelopeDisplay::paintBackground(juce::Graphics &g) const
+{
+    g.fillAll(juce::Colours::black);
+    g.setColour(juce::Colours::darkgrey);
+    g.drawRect(getLocalBounds(), 1);
+
+    g.setColour(juce::Colours::white);
+    g.strokePath(curve, juce::PathStrokeType(1.5f));
+}
+
+void EnvelopeDisplay::resized()
+{
+    plotArea = getLocalBounds().toFloat().reduced(6.0f);
+    rebuildCurve();
+}
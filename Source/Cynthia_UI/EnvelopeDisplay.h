@@ -0,0 +1,67 @@
+/*
+    EnvelopeDisplay.h
+
+    Draws the ADSR curve from the envelope parameters, with a dot for every sounding voice.
+
+    The curve is worked out here on the message thread and cached, along with the frame, as a
+    background image. It's only rebuilt when an envelope parameter changes (or the component is
+    resized). The dots come from
+    VoicePlayheads, which the audio thread fills in once per block.
+
+    The attack, decay and release segments are drawn to scale with each other. The sustain
+    segment has a fixed width, since it lasts as long as the key is held.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "Cynthia_UI/CachedBackground.h"
+#include "Cynthia_UI/RepaintCoalescer.h"
+#include "Cynthia_Utilities/VoicePlayheads.h"
+
+class EnvelopeDisplay : public juce::Component,
+                        private juce::AudioProcessorValueTreeState::Listener,
+                        private RepaintCoalescer::Client
+{
+public:
+    EnvelopeDisplay(juce::AudioProcessorValueTreeState &apvts, VoicePlayheads &playheads, RepaintCoalescer &coalescer);
+    ~EnvelopeDisplay() override;
+
+private:
+    void paint(juce::Graphics &g) override;
+    void resized() override;
+    bool updateFrame() override;
+
+    // everything but the dots
+    void paintBackground(juce::Graphics &g) const;
+
+    // may be called on the audio thread (host automation), so it only raises a flag
+    void parameterChanged(const juce::String &parameterID, float newValue) override;
+
+    void rebuildCurve();
+    juce::Point<float> getPlayheadPosition(const VoicePlayheads::Playhead &playhead) const;
+    float getY(float level) const;
+
+    static constexpr int frameRate = 30;
+    static constexpr float sustainProportion = 0.25f; // of the width
+
+    juce::AudioProcessorValueTreeState &apvts;
+    VoicePlayheads &playheads;
+    RepaintCoalescer &coalescer;
+    CachedBackground background;
+    std::atomic<bool> curveNeedsRebuild { true };
+
+    // the parameter values the curve was built from
+    float attack = 0.0f, decay = 0.0f, sustain = 0.0f, release = 0.0f;
+
+    juce::Rectangle<float> plotArea;
+    float secondsToWidth = 0.0f;
+    float attackEnd = 0.0f, decayEnd = 0.0f, sustainEnd = 0.0f;
+    juce::Path curve;
+
+    bool showedPlayheads = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EnvelopeDisplay)
+};
@@ -4,6 +4,9 @@ FilterComponent::FilterComponent(APVTS &apvts) :    cutoffFrequencyAttachment(ap
                                                     resonanceLevelAttachment(apvts, ParameterID::filterResonance.getParamID(), resonanceLevelKnob),
                                                     filterTypeAttachment(apvts, ParameterID::filterType.getParamID(), filterTypeComboBox)
 {
+    // paint() fills the whole module, so nothing behind it ever needs repainting
+    setOpaque(true);
+
     configureKnob(cutoffFrequencyKnob);
     configureKnob(resonanceLevelKnob);
 
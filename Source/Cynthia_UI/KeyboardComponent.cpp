@@ -0,0 +1,35 @@
+#include "Cynthia_UI/KeyboardComponent.h"
+
+KeyboardComponent::KeyboardComponent(LiveMidiQueue &queue) : queue(queue)
+{
+    keyboardState.addListener(this);
+
+    // C2 to C7, with the computer keyboard starting at C3
+    keyboard.setAvailableRange(36, 96);
+    keyboard.setKeyPressBaseOctave(4);
+    keyboard.setWantsKeyboardFocus(true);
+    addAndMakeVisible(keyboard);
+}
+
+KeyboardComponent::~KeyboardComponent()
+{
+    // closing the editor mustn't leave notes hanging
+    keyboardState.allNotesOff(0);
+    keyboardState.removeListener(this);
+}
+
+void KeyboardComponent::resized()
+{
+    keyboard.setBounds(getLocalBounds());
+}
+
+// MidiKeyboardState calls these on the message thread, the producer side of the queue
+void KeyboardComponent::handleNoteOn(juce::MidiKeyboardState *, int midiChannel, int midiNoteNumber, float velocity)
+{
+    queue.push(juce::MidiMessage::noteOn(midiChannel, midiNoteNumber, velocity));
+}
+
+void KeyboardComponent::handleNoteOff(juce::MidiKeyboardState *, int midiChannel, int midiNoteNumber, float velocity)
+{
+    queue.push(juce::MidiMessage::noteOff(midiChannel, midiNoteNumber, velocity));
+}
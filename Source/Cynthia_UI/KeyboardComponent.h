@@ -0,0 +1,34 @@
+/*
+    KeyboardComponent.h
+
+    An on-screen keyboard for playing the synth without a MIDI controller, mostly for the
+    standalone app.
+
+    The notes go to the audio thread through the processor's LiveMidiQueue rather than the
+    usual MidiKeyboardState::processNextMidiBuffer(), which locks on the audio thread.
+*/
+
+#pragma once
+
+#include <juce_audio_utils/juce_audio_utils.h>
+#include "Cynthia_Utilities/LiveMidiQueue.h"
+
+class KeyboardComponent : public juce::Component, private juce::MidiKeyboardState::Listener
+{
+public:
+    explicit KeyboardComponent(LiveMidiQueue &queue);
+    ~KeyboardComponent() override;
+
+private:
+    void resized() override;
+
+    void handleNoteOn(juce::MidiKeyboardState *, int midiChannel, int midiNoteNumber, float velocity) override;
+    void handleNoteOff(juce::MidiKeyboardState *, int midiChannel, int midiNoteNumber, float velocity) override;
+
+    LiveMidiQueue &queue;
+
+    juce::MidiKeyboardState keyboardState;
+    juce::MidiKeyboardComponent keyboard { keyboardState, juce::MidiKeyboardComponent::horizontalKeyboard };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(KeyboardComponent)
+};
@@ -1,25 +1,37 @@
 #include "Cynthia_UI/LFOComponent.h"
 
-LFOComponent::LFOComponent(APVTS &apvts) :  morphValueKnobAttachment(apvts, ParameterID::morphValueLFO.getParamID(), morphValueKnob),
+LFOComponent::LFOComponent(APVTS &apvts, VoicePlayheads &playheads, RepaintCoalescer &coalescer) : morphValueKnobAttachment(apvts, ParameterID::morphValueLFO.getParamID(), morphValueKnob),
                                             detuneDentsKnobAttachment(apvts, ParameterID::detuneCentsLFO.getParamID(), detuneCentsKnob),
                                             modDepthKnobAttachment(apvts, ParameterID::modDepthLFO.getParamID(), modDepthKnob),
                                             modFreqKnobAttachment(apvts, ParameterID::modFreqLFO.getParamID(), modFreqKnob),
+                                            positionModKnobAttachment(apvts, ParameterID::positionModLFO.getParamID(), positionModKnob),
                                             wavetypeAComboBoxAttachment(apvts, ParameterID::wavetypeALFO.getParamID(), wavetypeAComboBox),
-                                            wavetypeBComboBoxAttachment(apvts, ParameterID::wavetypeBLFO.getParamID(), wavetypeBComboBox)
+                                            wavetypeBComboBoxAttachment(apvts, ParameterID::wavetypeBLFO.getParamID(), wavetypeBComboBox),
+                                            syncRateComboBoxAttachment(apvts, ParameterID::syncRateLFO.getParamID(), syncRateComboBox),
+                                            lfoDisplay(apvts, playheads, coalescer)
 {
+    // paint() fills the whole module, so nothing behind it ever needs repainting
+    setOpaque(true);
+
+    addAndMakeVisible(lfoDisplay);
+
     configureKnob(morphValueKnob);
     configureKnob(detuneCentsKnob);
     configureKnob(modDepthKnob);
     configureKnob(modFreqKnob);
+    configureKnob(positionModKnob);
     configureComboBox(wavetypeAComboBox, juce::StringArray{"Sine", "Saw", "Triangle", "Square"});
     configureComboBox(wavetypeBComboBox, juce::StringArray{"Sine", "Saw", "Triangle", "Square"});
+    configureComboBox(syncRateComboBox, juce::StringArray{"Free", "4 Bars", "2 Bars", "1/1", "1/2", "1/4", "1/8", "1/16", "1/8 T", "1/16 T", "1/8 D"});
 
     configureComponentLabel(morphValueLabel, juce::String("Morph"));
     configureComponentLabel(detuneCentsLabel, juce::String("Detune"));
     configureComponentLabel(modDepthLabel, juce::String("Mod Depth"));
     configureComponentLabel(modFreqLabel, juce::String("Mod Freq"));
+    configureComponentLabel(positionModLabel, juce::String("Position"));
     configureComponentLabel(wavetypeALabel, juce::String("Wavetype A"));
     configureComponentLabel(wavetypeBLabel, juce::String("Wavetype B"));
+    configureComponentLabel(syncRateLabel, juce::String("Sync"));
 }
 
 void LFOComponent::paint(juce::Graphics &g)
@@ -37,6 +49,10 @@ void LFOComponent::paint(juce::Graphics &g)
 void LFOComponent::resized()
 {
     auto bounds = getLocalBounds().reduced(10);
+
+    // the curve preview sits under the header, the controls share the rest
+    lfoDisplay.setBounds(bounds.removeFromTop(bounds.getHeight()/3).withTrimmedTop(10));
+
     auto lfoModuleArea = bounds;
     int knobSize = std::min(lfoModuleArea.getWidth()/numComponents, lfoModuleArea.getHeight()-30);
     int comboBoxSize = knobSize; // changed
@@ -50,15 +66,19 @@ void LFOComponent::resized()
     auto detuneColumn = makeComponentWithLabel(detuneCentsKnob, detuneCentsLabel, knobSize/4, knobSize, knobSize, knobSize);
     auto modDepthColumn = makeComponentWithLabel(modDepthKnob, modDepthLabel, knobSize/4, knobSize, knobSize, knobSize);
     auto modFreqColumn = makeComponentWithLabel(modFreqKnob, modFreqLabel, knobSize/4, knobSize, knobSize, knobSize);
+    auto positionModColumn = makeComponentWithLabel(positionModKnob, positionModLabel, knobSize/4, knobSize, knobSize, knobSize);
     auto wavetypeAColumn = makeComponentWithLabel(wavetypeAComboBox, wavetypeALabel, comboBoxSize/3, comboBoxSize, comboBoxSize/3, comboBoxSize);
     auto wavetypeBColumn = makeComponentWithLabel(wavetypeBComboBox, wavetypeBLabel, comboBoxSize/3, comboBoxSize, comboBoxSize/3, comboBoxSize);
+    auto syncRateColumn = makeComponentWithLabel(syncRateComboBox, syncRateLabel, comboBoxSize/3, comboBoxSize, comboBoxSize/3, comboBoxSize);
 
     row.items.add(juce::FlexItem(morphColumn).withFlex(1.0f).withMargin({5, 5, 5, 5}));
     row.items.add(juce::FlexItem(detuneColumn).withFlex(1.0f).withMargin({5, 5, 5, 5}));
     row.items.add(juce::FlexItem(modDepthColumn).withFlex(1.0f).withMargin({5, 5, 5, 5}));
     row.items.add(juce::FlexItem(modFreqColumn).withFlex(1.0f).withMargin({5, 5, 5, 5}));
+    row.items.add(juce::FlexItem(positionModColumn).withFlex(1.0f).withMargin({5, 5, 5, 5}));
     row.items.add(juce::FlexItem(wavetypeAColumn).withFlex(1.0f).withMargin({5, 5, 5, 5}));
     row.items.add(juce::FlexItem(wavetypeBColumn).withFlex(1.0f).withMargin({5, 5, 5, 5}));
+    row.items.add(juce::FlexItem(syncRateColumn).withFlex(1.0f).withMargin({5, 5, 5, 5}));
 
     row.performLayout(lfoModuleArea);
 
@@ -69,8 +89,10 @@ void LFOComponent::resized()
     detuneColumn.performLayout(lfoModuleArea.removeFromLeft(columnWidth).reduced(5));
     modDepthColumn.performLayout(lfoModuleArea.removeFromLeft(columnWidth).reduced(5));
     modFreqColumn.performLayout(lfoModuleArea.removeFromLeft(columnWidth).reduced(5));
+    positionModColumn.performLayout(lfoModuleArea.removeFromLeft(columnWidth).reduced(5));
     wavetypeAColumn.performLayout(lfoModuleArea.removeFromLeft(columnWidth).reduced(5));
     wavetypeBColumn.performLayout(lfoModuleArea.removeFromLeft(columnWidth).reduced(5));
+    syncRateColumn.performLayout(lfoModuleArea.removeFromLeft(columnWidth).reduced(5));
 }
 
 void LFOComponent::configureKnob(juce::Slider &knob)
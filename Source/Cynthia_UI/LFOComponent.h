@@ -1,10 +1,11 @@
 #pragma once
 #include "Cynthia_UI/SynthUIModule.h"
+#include "Cynthia_UI/LFODisplay.h"
 
 class LFOComponent : public SynthUIModule
 {
 public:
-    LFOComponent(APVTS &apvts);
+    LFOComponent(APVTS &apvts, VoicePlayheads &playheads, RepaintCoalescer &coalescer);
 
 private:
     void paint(juce::Graphics &g);
@@ -15,28 +16,37 @@ private:
     void configureComponentLabel(juce::Label &componentLabel, const juce::String &componentLabelText) override;
 
     const juce::String moduleHeader = "LFO";
-    const int numComponents = 6;
+    const int numComponents = 8;
 
     juce::Slider morphValueKnob;
     juce::Slider detuneCentsKnob;
     juce::Slider modDepthKnob;
     juce::Slider modFreqKnob;
+    juce::Slider positionModKnob;
     juce::ComboBox wavetypeAComboBox;
     juce::ComboBox wavetypeBComboBox;
+    juce::ComboBox syncRateComboBox;
 
     juce::Label morphValueLabel;
     juce::Label detuneCentsLabel;
     juce::Label modDepthLabel;
     juce::Label modFreqLabel;
+    juce::Label positionModLabel;
     juce::Label wavetypeALabel;
     juce::Label wavetypeBLabel;
+    juce::Label syncRateLabel;
 
     SliderAttachment morphValueKnobAttachment;
     SliderAttachment detuneDentsKnobAttachment;
     SliderAttachment modDepthKnobAttachment;
     SliderAttachment modFreqKnobAttachment;
+    SliderAttachment positionModKnobAttachment;
     ComboBoxAttachment wavetypeAComboBoxAttachment;
     ComboBoxAttachment wavetypeBComboBoxAttachment;
+    ComboBoxAttachment syncRateComboBoxAttachment;
+
+    // previews the parameters above, with a dot per sounding voice
+    LFODisplay lfoDisplay;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LFOComponent)
 };
\ No newline at end of file
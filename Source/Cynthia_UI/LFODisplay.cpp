@@ -0,0 +1,157 @@
+#include "Cynthia_UI/LFODisplay.h"
+#include "Cynthia_DSP/MorphingOscillator.h"
+#include "Cynthia_Utilities/Utils.h"
+
+namespace
+{
+    const juce::String lfoParameterIDs[] = {
+        ParameterID::wavetypeALFO.getParamID(),
+        ParameterID::wavetypeBLFO.getParamID(),
+        ParameterID::morphValueLFO.getParamID(),
+        ParameterID::modDepthLFO.getParamID()
+    };
+}
+
+LFODisplay::LFODisplay(juce::AudioProcessorValueTreeState &apvts, VoicePlayheads &playheads, RepaintCoalescer &coalescer)
+    : apvts(apvts), playheads(playheads), coalescer(coalescer)
+{
+    setOpaque(true);
+
+    for (const auto &parameterID : lfoParameterIDs)
+        apvts.addParameterListener(parameterID, this);
+
+    playheads.addReader();
+    coalescer.addClient(*this, *this, frameRate);
+}
+
+LFODisplay::~LFODisplay()
+{
+    coalescer.removeClient(*this);
+    playheads.removeReader();
+
+    for (const auto &parameterID : lfoParameterIDs)
+        apvts.removeParameterListener(parameterID, this);
+}
+
+void LFODisplay::parameterChanged(const juce::String &, float)
+{
+    shapeNeedsRebuild.store(true);
+}
+
+bool LFODisplay::updateFrame()
+{
+    if (shapeNeedsRebuild.exchange(false))
+    {
+        rebuildShape();
+        return true;
+    }
+
+    // only redraw while there are dots to move, plus once more to clear the last ones
+    bool hasPlayheads = false;
+    for (int voice = 0; voice < playheads.getNumVoices() && ! hasPlayheads; ++voice)
+        hasPlayheads = playheads.get(voice).state != VoicePlayheads::State::Idle;
+
+    bool needsRepaint = hasPlayheads || showedPlayheads;
+    showedPlayheads = hasPlayheads;
+    return needsRepaint;
+}
+
+void LFODisplay::rebuildShape()
+{
+    auto getIndex = [this](const juce::ParameterID &id)
+    {
+        return juce::roundToInt(apvts.getRawParameterValue(id.getParamID())->load());
+    };
+
+    int waveformA = juce::jlimit(0, MorphingOscillator::numFactoryWaveforms - 1, getIndex(ParameterID::wavetypeALFO));
+    int waveformB = juce::jlimit(0, MorphingOscillator::numFactoryWaveforms - 1, getIndex(ParameterID::wavetypeBLFO));
+    float morph = apvts.getRawParameterValue(ParameterID::morphValueLFO.getParamID())->load();
+    depth = apvts.getRawParameterValue(ParameterID::modDepthLFO.getParamID())->load();
+
+    // the full bandwidth tables, the same crossfade as MorphingOscillator::getMorphedSample()
+    const auto &wavetable = MorphingOscillator::getFactoryWavetable();
+    const float *tableA = wavetable.getTable(waveformA, 0);
+    const float *tableB = wavetable.getTable(waveformB, 0);
+
+    for (int point = 0; point <= numPoints; ++point)
+    {
+        int index = (point * Wavetable::tableSize / numPoints) % Wavetable::tableSize;
+        shape[static_cast<size_t>(point)] = (1.0f - morph) * tableA[index] + morph * tableB[index];
+    }
+
+    shapePath.clear();
+    scaledPath.clear();
+
+    for (int point = 0; point <= numPoints; ++point)
+    {
+        float phase = static_cast<float>(point) / numPoints;
+        float value = shape[static_cast<size_t>(point)];
+
+        if (point == 0)
+        {
+            shapePath.startNewSubPath(getPoint(phase, value));
+            scaledPath.startNewSubPath(getPoint(phase, value * depth));
+        }
+        else
+        {
+            shapePath.lineTo(getPoint(phase, value));
+            scaledPath.lineTo(getPoint(phase, value * depth));
+        }
+    }
+
+    background.invalidate();
+}
+
+float LFODisplay::getShapeValue(float phase) const
+{
+    float position = juce::jlimit(0.0f, 1.0f, phase) * numPoints;
+    int point = juce::jmin(static_cast<int>(position), numPoints - 1);
+    float frac = position - static_cast<float>(point);
+
+    return shape[static_cast<size_t>(point)] + frac * (shape[static_cast<size_t>(point + 1)] - shape[static_cast<size_t>(point)]);
+}
+
+juce::Point<float> LFODisplay::getPoint(float phase, float value) const
+{
+    return { plotArea.getX() + phase * plotArea.getWidth(),
+             juce::jmap(juce::jlimit(-1.0f, 1.0f, value), -1.0f, 1.0f, plotArea.getBottom(), plotArea.getY()) };
+}
+
+void LFODisplay::paint(juce::Graphics &g)
+{
+    RepaintCoalescer::ScopedPaintTimer paintTimer(coalescer);
+
+    background.draw(g, getLocalBounds(), [this](juce::Graphics &backgroundGraphics) { paintBackground(backgroundGraphics); });
+
+    constexpr float dotSize = 6.0f;
+    g.setColour(juce::Colours::red);
+
+    for (int voice = 0; voice < playheads.getNumVoices(); ++voice)
+    {
+        auto playhead = playheads.get(voice);
+        if (playhead.state == VoicePlayheads::State::Idle)
+            continue;
+
+        auto position = getPoint(playhead.lfoPhase, getShapeValue(playhead.lfoPhase) * depth);
+        g.fillEllipse(juce::Rectangle<float>(dotSize, dotSize).withCentre(position));
+    }
+}
+
+void LFODisplay::paintBackground(juce::Graphics &g) const
+{
+    g.fillAll(juce::Colours::black);
+    g.setColour(juce::Colours::darkgrey);
+    g.drawRect(getLocalBounds(), 1);
+    g.drawHorizontalLine(juce::roundToInt(plotArea.getCentreY()), plotArea.getX(), plotArea.getRight());
+
+    g.strokePath(shapePath, juce::PathStrokeType(1.0f));
+
+    g.setColour(juce::Colours::white);
+    g.strokePath(scaledPath, juce::PathStrokeType(1.5f));
+}
+
+void LFODisplay::resized()
+{
+    plotArea = getLocalBounds().toFloat().reduced(6.0f);
+    rebuildShape();
+}
@@ -0,0 +1,64 @@
+/*
+    LFODisplay.h
+
+    Draws one cycle of the LFO's morphed waveform, with a dot for every sounding voice.
+
+    The shape is read from the same factory wavetable the LFO plays, on the message thread,
+    and cached as a background image that's only redrawn when a waveform, morph or depth
+    parameter changes.
+    The dim trace is the shape itself, the bright one the shape scaled by Mod Depth, which is
+    what the voices actually get. The dots come from VoicePlayheads.
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "Cynthia_UI/CachedBackground.h"
+#include "Cynthia_UI/RepaintCoalescer.h"
+#include "Cynthia_Utilities/VoicePlayheads.h"
+
+class LFODisplay : public juce::Component,
+                   private juce::AudioProcessorValueTreeState::Listener,
+                   private RepaintCoalescer::Client
+{
+public:
+    LFODisplay(juce::AudioProcessorValueTreeState &apvts, VoicePlayheads &playheads, RepaintCoalescer &coalescer);
+    ~LFODisplay() override;
+
+private:
+    void paint(juce::Graphics &g) override;
+    void resized() override;
+    bool updateFrame() override;
+
+    // everything but the dots
+    void paintBackground(juce::Graphics &g) const;
+
+    // may be called on the audio thread (host automation), so it only raises a flag
+    void parameterChanged(const juce::String &parameterID, float newValue) override;
+
+    void rebuildShape();
+    float getShapeValue(float phase) const;
+    juce::Point<float> getPoint(float phase, float value) const;
+
+    static constexpr int frameRate = 30;
+    static constexpr int numPoints = 256;
+
+    juce::AudioProcessorValueTreeState &apvts;
+    VoicePlayheads &playheads;
+    RepaintCoalescer &coalescer;
+    CachedBackground background;
+    std::atomic<bool> shapeNeedsRebuild { true };
+
+    std::array<float, numPoints + 1> shape {}; // one cycle, last point repeats the first
+    float depth = 0.0f;
+
+    juce::Rectangle<float> plotArea;
+    juce::Path shapePath, scaledPath;
+
+    bool showedPlayheads = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LFODisplay)
+};
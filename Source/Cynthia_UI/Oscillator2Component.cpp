@@ -0,0 +1,102 @@
+#include "Cynthia_UI/Oscillator2Component.h"
+
+Oscillator2Component::Oscillator2Component(APVTS &apvts) : levelKnobAttachment(apvts, ParameterID::levelOsc2.getParamID(), levelKnob),
+                                                           semitonesKnobAttachment(apvts, ParameterID::semitonesOsc2.getParamID(), semitonesKnob),
+                                                           fmAmountKnobAttachment(apvts, ParameterID::fmAmountOsc2.getParamID(), fmAmountKnob),
+                                                           ringModKnobAttachment(apvts, ParameterID::ringModOsc2.getParamID(), ringModKnob),
+                                                           wavetypeComboBoxAttachment(apvts, ParameterID::wavetypeOsc2.getParamID(), wavetypeComboBox),
+                                                           syncComboBoxAttachment(apvts, ParameterID::syncOsc2.getParamID(), syncComboBox)
+{
+    // paint() fills the whole module, so nothing behind it ever needs repainting
+    setOpaque(true);
+
+    configureKnob(levelKnob);
+    configureKnob(semitonesKnob);
+    configureKnob(fmAmountKnob);
+    configureKnob(ringModKnob);
+    configureComboBox(wavetypeComboBox, juce::StringArray{"Sine", "Saw", "Triangle", "Square"});
+    configureComboBox(syncComboBox, juce::StringArray{"Off", "On"});
+
+    configureComponentLabel(levelLabel, juce::String("Level"));
+    configureComponentLabel(semitonesLabel, juce::String("Semitones"));
+    configureComponentLabel(fmAmountLabel, juce::String("FM"));
+    configureComponentLabel(ringModLabel, juce::String("Ring Mod"));
+    configureComponentLabel(wavetypeLabel, juce::String("Wavetype"));
+    configureComponentLabel(syncLabel, juce::String("Sync"));
+}
+
+void Oscillator2Component::paint(juce::Graphics &g)
+{
+    g.fillAll(juce::Colours::black);
+    g.setColour(juce::Colours::red);
+    g.drawRect(getLocalBounds(), 1);
+    g.drawText(
+        moduleHeader,
+        getLocalBounds()
+            .removeFromTop(20),
+        juce::Justification::centred);
+}
+
+void Oscillator2Component::resized()
+{
+    auto bounds = getLocalBounds().reduced(10);
+    auto oscModuleArea = bounds;
+    int knobSize = std::min(oscModuleArea.getWidth()/numComponents, oscModuleArea.getHeight()-30);
+    int comboBoxSize = knobSize;
+
+    juce::FlexBox row;
+    row.flexDirection = juce::FlexBox::Direction::row;
+    row.justifyContent = juce::FlexBox::JustifyContent::spaceAround;
+    row.alignItems = juce::FlexBox::AlignItems::center;
+
+    auto levelColumn = makeComponentWithLabel(levelKnob, levelLabel, knobSize/4, knobSize, knobSize, knobSize);
+    auto semitonesColumn = makeComponentWithLabel(semitonesKnob, semitonesLabel, knobSize/4, knobSize, knobSize, knobSize);
+    auto fmAmountColumn = makeComponentWithLabel(fmAmountKnob, fmAmountLabel, knobSize/4, knobSize, knobSize, knobSize);
+    auto ringModColumn = makeComponentWithLabel(ringModKnob, ringModLabel, knobSize/4, knobSize, knobSize, knobSize);
+    auto wavetypeColumn = makeComponentWithLabel(wavetypeComboBox, wavetypeLabel, comboBoxSize/3, comboBoxSize, comboBoxSize/3, comboBoxSize);
+    auto syncColumn = makeComponentWithLabel(syncComboBox, syncLabel, comboBoxSize/3, comboBoxSize, comboBoxSize/3, comboBoxSize);
+
+    row.items.add(juce::FlexItem(levelColumn).withFlex(1.0f).withMargin({5, 5, 5, 5}));
+    row.items.add(juce::FlexItem(semitonesColumn).withFlex(1.0f).withMargin({5, 5, 5, 5}));
+    row.items.add(juce::FlexItem(fmAmountColumn).withFlex(1.0f).withMargin({5, 5, 5, 5}));
+    row.items.add(juce::FlexItem(ringModColumn).withFlex(1.0f).withMargin({5, 5, 5, 5}));
+    row.items.add(juce::FlexItem(wavetypeColumn).withFlex(1.0f).withMargin({5, 5, 5, 5}));
+    row.items.add(juce::FlexItem(syncColumn).withFlex(1.0f).withMargin({5, 5, 5, 5}));
+
+    row.performLayout(oscModuleArea);
+
+    auto columnWidth = oscModuleArea.getWidth()/numComponents;
+
+    levelColumn.performLayout(oscModuleArea.removeFromLeft(columnWidth).reduced(5));
+    semitonesColumn.performLayout(oscModuleArea.removeFromLeft(columnWidth).reduced(5));
+    fmAmountColumn.performLayout(oscModuleArea.removeFromLeft(columnWidth).reduced(5));
+    ringModColumn.performLayout(oscModuleArea.removeFromLeft(columnWidth).reduced(5));
+    wavetypeColumn.performLayout(oscModuleArea.removeFromLeft(columnWidth).reduced(5));
+    syncColumn.performLayout(oscModuleArea.removeFromLeft(columnWidth).reduced(5));
+}
+
+void Oscillator2Component::configureKnob(juce::Slider &knob)
+{
+    knob.setSliderStyle(juce::Slider::SliderStyle::Rotary);
+    knob.setTextBoxStyle(
+        juce::Slider::TextEntryBoxPosition::TextBoxBelow,
+        false,
+        50,
+        15);
+
+    addAndMakeVisible(knob);
+}
+
+void Oscillator2Component::configureComboBox(juce::ComboBox &comboBox, const juce::StringArray &items)
+{
+    comboBox.addItemList(items, 1);
+    addAndMakeVisible(comboBox);
+}
+
+void Oscillator2Component::configureComponentLabel(juce::Label &componentLabel, const juce::String &componentLabelText)
+{
+    componentLabel.setText(componentLabelText, juce::dontSendNotification);
+    componentLabel.setJustificationType(juce::Justification::centred);
+    componentLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+    addAndMakeVisible(componentLabel);
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "Cynthia_UI/SynthUIModule.h"
+
+// the second oscillator: its own level and tuning, and how it modulates the first one
+class Oscillator2Component : public SynthUIModule
+{
+public:
+    Oscillator2Component(APVTS &apvts);
+
+private:
+    void paint(juce::Graphics &g) override;
+    void resized() override;
+
+    void configureKnob(juce::Slider &knob) override;
+    void configureComboBox(juce::ComboBox &comboBox, const juce::StringArray &items) override;
+    void configureComponentLabel(juce::Label &componentLabel, const juce::String &componentLabelText) override;
+
+    const juce::String moduleHeader = "Oscillator 2";
+    const int numComponents = 6;
+
+    juce::Slider levelKnob;
+    juce::Slider semitonesKnob;
+    juce::Slider fmAmountKnob;
+    juce::Slider ringModKnob;
+    juce::ComboBox wavetypeComboBox;
+    juce::ComboBox syncComboBox;
+
+    juce::Label levelLabel;
+    juce::Label semitonesLabel;
+    juce::Label fmAmountLabel;
+    juce::Label ringModLabel;
+    juce::Label wavetypeLabel;
+    juce::Label syncLabel;
+
+    // declared after the controls, so they're destroyed first
+    SliderAttachment levelKnobAttachment;
+    SliderAttachment semitonesKnobAttachment;
+    SliderAttachment fmAmountKnobAttachment;
+    SliderAttachment ringModKnobAttachment;
+    ComboBoxAttachment wavetypeComboBoxAttachment;
+    ComboBoxAttachment syncComboBoxAttachment;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Oscillator2Component)
+};
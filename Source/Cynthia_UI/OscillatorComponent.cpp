@@ -3,18 +3,34 @@
 OscillatorComponent::OscillatorComponent(APVTS &apvts) : morphValueKnobAttachment(apvts, ParameterID::morphValueOsc.getParamID(), morphValueKnob),
                                                          detuneDentsKnobAttachment(apvts, ParameterID::detuneCentsOsc.getParamID(), detuneCentsKnob),
                                                          wavetypeAComboBoxAttachment(apvts, ParameterID::wavetypeAOsc.getParamID(), wavetypeAComboBox),
-                                                         wavetypeBComboBoxAttachment(apvts, ParameterID::wavetypeBOsc.getParamID(), wavetypeBComboBox)
+                                                         wavetypeBComboBoxAttachment(apvts, ParameterID::wavetypeBOsc.getParamID(), wavetypeBComboBox),
+                                                         tableSourceComboBoxAttachment(apvts, ParameterID::tableSourceOsc.getParamID(), tableSourceComboBox),
+                                                         interpolationComboBoxAttachment(apvts, ParameterID::interpolationOsc.getParamID(), interpolationComboBox),
+                                                         noiseLevelKnobAttachment(apvts, ParameterID::noiseLevel.getParamID(), noiseLevelKnob),
+                                                         noiseTypeComboBoxAttachment(apvts, ParameterID::noiseType.getParamID(), noiseTypeComboBox)
                                                          
 {
+    // paint() fills the whole module, so nothing behind it ever needs repainting
+    setOpaque(true);
+
     configureKnob(morphValueKnob);
     configureKnob(detuneCentsKnob);
     configureComboBox(wavetypeAComboBox, juce::StringArray{"Sine", "Saw", "Triangle", "Square"});
     configureComboBox(wavetypeBComboBox, juce::StringArray{"Sine", "Saw", "Triangle", "Square"});
+    configureComboBox(tableSourceComboBox, juce::StringArray{"Factory", "User"});
+    configureComboBox(interpolationComboBox, juce::StringArray{"Linear", "Hermite", "Sinc"});
+    configureKnob(noiseLevelKnob);
+    configureComboBox(noiseTypeComboBox, juce::StringArray{"White", "Pink", "Filtered"});
+
+    loadWavetableButton.onClick = [this] { chooseWavetable(); };
+    addAndMakeVisible(loadWavetableButton);
 
     configureComponentLabel(morphValueLabel, juce::String("Morph"));
     configureComponentLabel(detuneCentsLabel, juce::String("Detune"));
     configureComponentLabel(wavetypeALabel, juce::String("Wavetype A"));
     configureComponentLabel(wavetypeBLabel, juce::String("Wavetype B"));
+    configureComponentLabel(noiseLevelLabel, juce::String("Noise"));
+    configureComponentLabel(noiseTypeLabel, juce::String("Noise Type"));
 }
 
 void OscillatorComponent::paint(juce::Graphics &g)
@@ -29,8 +45,43 @@ void OscillatorComponent::paint(juce::Graphics &g)
         juce::Justification::centred);
 }
 
+void OscillatorComponent::chooseWavetable()
+{
+    wavetableChooser = std::make_unique<juce::FileChooser>("Load a wavetable", juce::File(), "*.wav;*.aif;*.aiff;*.flac");
+
+    wavetableChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                                  [this](const juce::FileChooser &chooser)
+                                  {
+                                      auto file = chooser.getResult();
+
+                                      if (file.existsAsFile() && onWavetableChosen)
+                                          onWavetableChosen(file);
+                                  });
+}
+
+void OscillatorComponent::showWavetableResult(const juce::File &file, const juce::String &errorMessage)
+{
+    if (errorMessage.isEmpty())
+    {
+        loadWavetableButton.setTooltip(file.getFullPathName());
+        return;
+    }
+
+    juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon,
+                                           "Couldn't load " + file.getFileName(),
+                                           errorMessage,
+                                           {},
+                                           this);
+}
+
 void OscillatorComponent::resized()
 {
+    // the table source, interpolation and load button share the header strip with the module name
+    auto header = getLocalBounds().removeFromTop(20).reduced(2);
+    tableSourceComboBox.setBounds(header.removeFromLeft(90));
+    interpolationComboBox.setBounds(header.removeFromLeft(90));
+    loadWavetableButton.setBounds(header.removeFromRight(90));
+
     auto bounds = getLocalBounds().reduced(10);
     auto oscModuleArea = bounds;
     int knobSize = std::min(oscModuleArea.getWidth()/numComponents, oscModuleArea.getHeight()-30);
@@ -45,11 +96,15 @@ void OscillatorComponent::resized()
     auto detuneColumn = makeComponentWithLabel(detuneCentsKnob, detuneCentsLabel, knobSize/4, knobSize, knobSize, knobSize);
     auto wavetypeAColumn = makeComponentWithLabel(wavetypeAComboBox, wavetypeALabel, comboBoxSize/3, comboBoxSize, comboBoxSize/3, comboBoxSize);
     auto wavetypeBColumn = makeComponentWithLabel(wavetypeBComboBox, wavetypeBLabel, comboBoxSize/3, comboBoxSize, comboBoxSize/3, comboBoxSize);
+    auto noiseLevelColumn = makeComponentWithLabel(noiseLevelKnob, noiseLevelLabel, knobSize/4, knobSize, knobSize, knobSize);
+    auto noiseTypeColumn = makeComponentWithLabel(noiseTypeComboBox, noiseTypeLabel, comboBoxSize/3, comboBoxSize, comboBoxSize/3, comboBoxSize);
 
     row.items.add(juce::FlexItem(morphColumn).withFlex(1.0f).withMargin({5, 5, 5, 5}));
     row.items.add(juce::FlexItem(detuneColumn).withFlex(1.0f).withMargin({5, 5, 5, 5}));
     row.items.add(juce::FlexItem(wavetypeAColumn).withFlex(1.0f).withMargin({5, 5, 5, 5}));
     row.items.add(juce::FlexItem(wavetypeBColumn).withFlex(1.0f).withMargin({5, 5, 5, 5}));
+    row.items.add(juce::FlexItem(noiseLevelColumn).withFlex(1.0f).withMargin({5, 5, 5, 5}));
+    row.items.add(juce::FlexItem(noiseTypeColumn).withFlex(1.0f).withMargin({5, 5, 5, 5}));
 
     row.performLayout(oscModuleArea);
 
@@ -60,6 +115,8 @@ void OscillatorComponent::resized()
     detuneColumn.performLayout(oscModuleArea.removeFromLeft(columnWidth).reduced(5));
     wavetypeAColumn.performLayout(oscModuleArea.removeFromLeft(columnWidth).reduced(5));
     wavetypeBColumn.performLayout(oscModuleArea.removeFromLeft(columnWidth).reduced(5));
+    noiseLevelColumn.performLayout(oscModuleArea.removeFromLeft(columnWidth).reduced(5));
+    noiseTypeColumn.performLayout(oscModuleArea.removeFromLeft(columnWidth).reduced(5));
 }
 
 void OscillatorComponent::configureKnob(juce::Slider &knob)
@@ -6,6 +6,12 @@ class OscillatorComponent : public SynthUIModule
 public:
     OscillatorComponent(APVTS &apvts);
 
+    // called with the file picked through the "Load WAV" button
+    std::function<void(const juce::File &)> onWavetableChosen;
+
+    // shows how loading the chosen file went. An empty error message means it worked
+    void showWavetableResult(const juce::File &file, const juce::String &errorMessage);
+
 private:
     void paint(juce::Graphics &g);
     void resized();
@@ -15,22 +21,36 @@ private:
     void configureComponentLabel(juce::Label &componentLabel, const juce::String &componentLabelText) override;
 
     const juce::String moduleHeader = "Oscillator";
-    const int numComponents = 4;
+    const int numComponents = 6;
 
     juce::Slider morphValueKnob;
     juce::Slider detuneCentsKnob;
     juce::ComboBox wavetypeAComboBox;
     juce::ComboBox wavetypeBComboBox;
+    juce::Slider noiseLevelKnob;
+    juce::ComboBox noiseTypeComboBox;
+    juce::ComboBox tableSourceComboBox;
+    juce::ComboBox interpolationComboBox;
+    juce::TextButton loadWavetableButton { "Load WAV" };
+    std::unique_ptr<juce::FileChooser> wavetableChooser;
 
     juce::Label morphValueLabel;
     juce::Label detuneCentsLabel;
     juce::Label wavetypeALabel;
     juce::Label wavetypeBLabel;
+    juce::Label noiseLevelLabel;
+    juce::Label noiseTypeLabel;
 
     SliderAttachment morphValueKnobAttachment;
     SliderAttachment detuneDentsKnobAttachment;
     ComboBoxAttachment wavetypeAComboBoxAttachment;
     ComboBoxAttachment wavetypeBComboBoxAttachment;
+    ComboBoxAttachment tableSourceComboBoxAttachment;
+    ComboBoxAttachment interpolationComboBoxAttachment;
+    SliderAttachment noiseLevelKnobAttachment;
+    ComboBoxAttachment noiseTypeComboBoxAttachment;
+
+    void chooseWavetable();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OscillatorComponent)
 };
\ No newline at end of file
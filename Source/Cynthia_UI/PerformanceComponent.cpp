@@ -0,0 +1,59 @@
+#include "Cynthia_UI/PerformanceComponent.h"
+
+PerformanceComponent::PerformanceComponent(std::function<PerformanceMeter::Stats()> getStats, std::function<void()> resetStats,
+                                           RepaintCoalescer &coalescer)
+    : getStats(std::move(getStats)), resetStats(std::move(resetStats)), coalescer(coalescer)
+{
+    setOpaque(true);
+    coalescer.addClient(*this, *this, refreshRate);
+}
+
+PerformanceComponent::~PerformanceComponent()
+{
+    coalescer.removeClient(*this);
+}
+
+bool PerformanceComponent::updateFrame()
+{
+    auto stats = getStats();
+
+    juce::String newText;
+    newText << "CPU " << juce::String(stats.load * 100.0, 1) << "%"
+            << " (peak " << juce::String(stats.peakLoad * 100.0, 1) << "%)"
+            << "    Voices " << stats.activeVoices << " / " << stats.voiceLimit
+            << " (peak " << stats.peakVoices << ")"
+            << "    Stolen " << juce::String(stats.stolenVoices)
+            << "    Near xruns " << juce::String(stats.xrunRiskBlocks)
+            << "    Overruns " << juce::String(stats.overrunBlocks)
+            << "    UI " << juce::String(coalescer.getFrameBudget().getCostPerSecond(), 1) << " ms/s";
+
+    // turn the text red once anything came close to the deadline
+    bool newAtRisk = stats.xrunRiskBlocks > 0 || stats.overrunBlocks > 0;
+
+    if (newText == text && newAtRisk == atRisk)
+        return false;
+
+    text = newText;
+    atRisk = newAtRisk;
+    return true;
+}
+
+void PerformanceComponent::mouseUp(const juce::MouseEvent &)
+{
+    resetStats();
+
+    if (updateFrame())
+        repaint();
+}
+
+void PerformanceComponent::paint(juce::Graphics &g)
+{
+    RepaintCoalescer::ScopedPaintTimer paintTimer(coalescer);
+
+    g.fillAll(juce::Colours::black);
+    g.setColour(juce::Colours::red);
+    g.drawRect(getLocalBounds(), 1);
+
+    g.setColour(atRisk ? juce::Colours::red : juce::Colours::white);
+    g.drawText(text, getLocalBounds().reduced(10, 0), juce::Justification::centredLeft);
+}
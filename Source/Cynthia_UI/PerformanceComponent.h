@@ -0,0 +1,43 @@
+/*
+    PerformanceComponent.h
+
+    A one line readout of the processor's PerformanceMeter: CPU load (smoothed and peak),
+    voices in use, stolen voices and blocks that came close to (or missed) the deadline.
+
+    Also shows how much message thread time the editors' animation took over the last second.
+
+    Polls a few times a second and only repaints when the text changed. Click it to reset
+    the peaks and counters.
+*/
+
+#pragma once
+
+#include <functional>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "Cynthia_UI/RepaintCoalescer.h"
+#include "Cynthia_Utilities/PerformanceMeter.h"
+
+class PerformanceComponent : public juce::Component, private RepaintCoalescer::Client
+{
+public:
+    // getStats and resetStats usually forward to the processor
+    PerformanceComponent(std::function<PerformanceMeter::Stats()> getStats, std::function<void()> resetStats,
+                         RepaintCoalescer &coalescer);
+    ~PerformanceComponent() override;
+
+private:
+    void paint(juce::Graphics &g) override;
+    void mouseUp(const juce::MouseEvent &event) override;
+    bool updateFrame() override;
+
+    static constexpr int refreshRate = 4;
+
+    std::function<PerformanceMeter::Stats()> getStats;
+    std::function<void()> resetStats;
+    RepaintCoalescer &coalescer;
+
+    juce::String text;
+    bool atRisk = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PerformanceComponent)
+};
@@ -0,0 +1,60 @@
+#include <algorithm>
+#include "Cynthia_UI/RepaintCoalescer.h"
+
+void RepaintCoalescer::FrameBudget::addCost(double milliseconds)
+{
+    windowCost += milliseconds;
+
+    double now = juce::Time::getMillisecondCounterHiRes();
+    double elapsed = now - windowStart;
+
+    if (elapsed < 1000.0)
+        return;
+
+    costPerSecond = windowCost * 1000.0 / elapsed;
+    windowStart = now;
+    windowCost = 0.0;
+
+    // the cost scales with the frame rate, so stretching the intervals by the overshoot
+    // brings the next second back within budget. Never slower than a few frames a second
+    double target = costPerSecond * slowdown / millisecondsPerSecond;
+    slowdown = juce::jlimit(1.0, 8.0, target);
+}
+
+RepaintCoalescer::RepaintCoalescer(juce::Component &editor)
+    : vBlankAttachment(&editor, [this] { updateClients(); })
+{
+}
+
+void RepaintCoalescer::addClient(juce::Component &component, Client &client, double framesPerSecond)
+{
+    entries.push_back({ &component, &client, 1000.0 / framesPerSecond, 0.0 });
+}
+
+void RepaintCoalescer::removeClient(Client &client)
+{
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [&client](const Entry &entry) { return entry.client == &client; }),
+                  entries.end());
+}
+
+void RepaintCoalescer::updateClients()
+{
+    double now = juce::Time::getMillisecondCounterHiRes();
+    double slowdown = frameBudget->getSlowdown();
+
+    for (auto &entry : entries)
+    {
+        if (now < entry.nextFrameTime || ! entry.component->isShowing())
+            continue;
+
+        // keep the cadence while vblanks keep up with it, start over from now when they didn't
+        double interval = entry.interval * slowdown;
+        bool fellBehind = now - entry.nextFrameTime > interval;
+        entry.nextFrameTime = (fellBehind ? now : entry.nextFrameTime) + interval;
+
+        if (entry.client->updateFrame())
+            entry.component->repaint();
+    }
+
+    frameBudget->addCost(juce::Time::getMillisecondCounterHiRes() - now);
+}
@@ -0,0 +1,112 @@
+/*
+    RepaintCoalescer.h
+
+    Drives every animated part of an editor from one vblank callback, within a frame budget.
+
+    Rendering policy for the editor:
+
+        Static things (module frames, headers, grids, curves that only change with a parameter)
+        are painted once into a CachedBackground image and blitted after that.
+
+        Animated things (scope traces, playhead dots, meters) don't own timers. They register
+        with the editor's RepaintCoalescer as a Client with the frame rate they'd like, and get
+        asked for a frame on the next vblank after they're due. They only repaint when that
+        frame actually changed something, and never while they're hidden.
+
+        Components that fill their whole area are opaque, so repainting them never repaints
+        whatever is behind them.
+
+    The frame budget is shared by every open Cynthia editor in the process (hosts run all
+    plugin UIs on one message thread). Clients time their paint() with a ScopedPaintTimer,
+    the coalescer times their frame updates, and once the total goes over the budget every
+    editor stretches its frame intervals by the same factor. Thirty open editors then each
+    animate less often, instead of all of them together stalling the host.
+*/
+
+#pragma once
+
+#include <vector>
+#include <juce_gui_basics/juce_gui_basics.h>
+
+class RepaintCoalescer
+{
+public:
+    class Client
+    {
+    public:
+        virtual ~Client() = default;
+
+        // called when the client is due a frame. Return true if it needs repainting
+        virtual bool updateFrame() = 0;
+    };
+
+    // measures the animation work of every editor in the process. Shared through a
+    // SharedResourcePointer; message thread only
+    class FrameBudget
+    {
+    public:
+        // milliseconds of message thread time per second all editors' animation may use
+        static constexpr double millisecondsPerSecond = 40.0;
+
+        void addCost(double milliseconds);
+
+        // 1 while within budget, otherwise how much longer every frame interval should get
+        double getSlowdown() const { return slowdown; }
+
+        // the measured animation cost over the last second, in milliseconds
+        double getCostPerSecond() const { return costPerSecond; }
+
+    private:
+        double windowStart = juce::Time::getMillisecondCounterHiRes();
+        double windowCost = 0.0;
+        double costPerSecond = 0.0;
+        double slowdown = 1.0;
+    };
+
+    // put one at the top of a client's paint(), so painting counts towards the budget
+    class ScopedPaintTimer
+    {
+    public:
+        explicit ScopedPaintTimer(RepaintCoalescer &coalescer)
+            : coalescer(coalescer), start(juce::Time::getMillisecondCounterHiRes())
+        {}
+
+        ~ScopedPaintTimer()
+        {
+            coalescer.frameBudget->addCost(juce::Time::getMillisecondCounterHiRes() - start);
+        }
+
+    private:
+        RepaintCoalescer &coalescer;
+        double start;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedPaintTimer)
+    };
+
+    // vblank callbacks follow the display the editor is on
+    explicit RepaintCoalescer(juce::Component &editor);
+
+    // clients must remove themselves before they're destroyed
+    void addClient(juce::Component &component, Client &client, double framesPerSecond);
+    void removeClient(Client &client);
+
+    const FrameBudget& getFrameBudget() const { return *frameBudget; }
+
+    // run every due client now. Called on each vblank
+    void updateClients();
+
+private:
+    struct Entry
+    {
+        juce::Component *component;
+        Client *client;
+        double interval;       // milliseconds
+        double nextFrameTime;  // milliseconds
+    };
+
+    std::vector<Entry> entries;
+    juce::SharedResourcePointer<FrameBudget> frameBudget;
+    juce::VBlankAttachment vBlankAttachment;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RepaintCoalescer)
+};
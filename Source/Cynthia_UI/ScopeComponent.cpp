@@ -0,0 +1,154 @@
+#include "Cynthia_UI/ScopeComponent.h"
+
+ScopeComponent::ScopeComponent(ScopeBuffer &scopeBuffer, RepaintCoalescer &coalescer)
+    : scopeBuffer(scopeBuffer), coalescer(coalescer)
+{
+    setOpaque(true);
+    spectrumDecibels.fill(minDecibels);
+    lastWritePosition = scopeBuffer.getWritePosition();
+
+    // from here on the audio thread starts feeding us
+    scopeBuffer.addReader();
+    coalescer.addClient(*this, *this, frameRate);
+}
+
+ScopeComponent::~ScopeComponent()
+{
+    coalescer.removeClient(*this);
+    scopeBuffer.removeReader();
+}
+
+bool ScopeComponent::updateFrame()
+{
+    // nothing new (transport stopped, or the host isn't processing), so nothing to redraw
+    uint32_t writePosition = scopeBuffer.getWritePosition();
+    if (writePosition == lastWritePosition)
+        return false;
+
+    lastWritePosition = writePosition;
+    analyse();
+    return true;
+}
+
+void ScopeComponent::analyse()
+{
+    scopeBuffer.copyLatest(latestSamples.data(), fftSize);
+
+    // trigger on a rising zero crossing, so a steady note stands still on the scope
+    int start = fftSize - scopeLength;
+    for (int i = 1; i <= fftSize - scopeLength; ++i)
+    {
+        if (latestSamples[static_cast<size_t>(i - 1)] < 0.0f && latestSamples[static_cast<size_t>(i)] >= 0.0f)
+        {
+            start = i;
+            break;
+        }
+    }
+
+    std::copy(latestSamples.begin() + start, latestSamples.begin() + start + scopeLength, scopeSamples.begin());
+
+    std::copy(latestSamples.begin(), latestSamples.end(), fftData.begin());
+    window.multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(fftSize));
+    fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+    // a full scale sine peaks at fftSize / 4 (half from the real transform, half from the Hann window)
+    constexpr float fullScale = fftSize / 4.0f;
+
+    for (size_t bin = 0; bin < spectrumDecibels.size(); ++bin)
+    {
+        float decibels = juce::jmax(minDecibels, juce::Decibels::gainToDecibels(fftData[bin] / fullScale, minDecibels));
+
+        // peaks jump up straight away and fall back slowly, which is much easier to read
+        spectrumDecibels[bin] = juce::jmax(decibels, spectrumDecibels[bin] - decayDecibelsPerFrame);
+    }
+}
+
+void ScopeComponent::paint(juce::Graphics &g)
+{
+    RepaintCoalescer::ScopedPaintTimer paintTimer(coalescer);
+
+    background.draw(g, getLocalBounds(), [this](juce::Graphics &backgroundGraphics) { paintBackground(backgroundGraphics); });
+
+    drawScope(g, scopeArea.withTrimmedTop(20).reduced(10).toFloat());
+    drawSpectrum(g, spectrumArea.withTrimmedTop(20).reduced(10).toFloat());
+}
+
+void ScopeComponent::paintBackground(juce::Graphics &g) const
+{
+    g.fillAll(juce::Colours::black);
+
+    g.setColour(juce::Colours::red);
+    g.drawRect(scopeArea, 1);
+    g.drawRect(spectrumArea, 1);
+    g.drawText(scopeHeader, scopeArea.withHeight(20), juce::Justification::centred);
+    g.drawText(spectrumHeader, spectrumArea.withHeight(20), juce::Justification::centred);
+
+    auto scopePlot = scopeArea.withTrimmedTop(20).reduced(10).toFloat();
+    g.setColour(juce::Colours::darkgrey);
+    g.drawHorizontalLine(juce::roundToInt(scopePlot.getCentreY()), scopePlot.getX(), scopePlot.getRight());
+}
+
+void ScopeComponent::drawScope(juce::Graphics &g, juce::Rectangle<float> area) const
+{
+    juce::Path trace;
+
+    for (int i = 0; i < scopeLength; ++i)
+    {
+        float x = juce::jmap(static_cast<float>(i), 0.0f, static_cast<float>(scopeLength - 1), area.getX(), area.getRight());
+        float sample = juce::jlimit(-1.0f, 1.0f, scopeSamples[static_cast<size_t>(i)]);
+        float y = juce::jmap(sample, -1.0f, 1.0f, area.getBottom(), area.getY());
+
+        if (i == 0)
+            trace.startNewSubPath(x, y);
+        else
+            trace.lineTo(x, y);
+    }
+
+    g.setColour(juce::Colours::white);
+    g.strokePath(trace, juce::PathStrokeType(1.0f));
+}
+
+void ScopeComponent::drawSpectrum(juce::Graphics &g, juce::Rectangle<float> area) const
+{
+    constexpr float minFrequency = 20.0f;
+    constexpr float maxFrequency = 20000.0f;
+
+    double sampleRate = scopeBuffer.getSampleRate();
+    int width = juce::jmax(1, juce::roundToInt(area.getWidth()));
+
+    juce::Path trace;
+
+    // one point per pixel on a log frequency axis, reading between bins
+    for (int pixel = 0; pixel <= width; ++pixel)
+    {
+        float proportion = static_cast<float>(pixel) / static_cast<float>(width);
+        float frequency = minFrequency * std::pow(maxFrequency / minFrequency, proportion);
+        float binPosition = static_cast<float>(frequency * fftSize / sampleRate);
+
+        int bin = juce::jlimit(0, fftSize / 2 - 2, static_cast<int>(binPosition));
+        float frac = juce::jlimit(0.0f, 1.0f, binPosition - static_cast<float>(bin));
+        float decibels = spectrumDecibels[static_cast<size_t>(bin)]
+                       + frac * (spectrumDecibels[static_cast<size_t>(bin + 1)] - spectrumDecibels[static_cast<size_t>(bin)]);
+
+        float x = area.getX() + static_cast<float>(pixel);
+        float y = juce::jmap(decibels, minDecibels, 0.0f, area.getBottom(), area.getY());
+
+        if (pixel == 0)
+            trace.startNewSubPath(x, y);
+        else
+            trace.lineTo(x, y);
+    }
+
+    g.setColour(juce::Colours::white);
+    g.strokePath(trace, juce::PathStrokeType(1.0f));
+}
+
+void ScopeComponent::resized()
+{
+    auto bounds = getLocalBounds();
+
+    scopeArea = bounds.removeFromLeft(bounds.getWidth() / 2);
+    spectrumArea = bounds;
+
+    background.invalidate();
+}
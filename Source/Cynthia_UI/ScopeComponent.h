@@ -0,0 +1,66 @@
+/*
+    ScopeComponent.h
+
+    Shows the synth's output: an oscilloscope on the left, a spectrum analyser on the right.
+
+    The audio thread only copies its output into a ScopeBuffer. Everything else (triggering,
+    the FFT, smoothing, drawing) happens here on the message thread, at most 30 times a
+    second (see RepaintCoalescer), and only when new audio has arrived. The frames, headers
+    and centre line are a cached background; only the traces are drawn every frame.
+*/
+
+#pragma once
+
+#include <array>
+#include <juce_dsp/juce_dsp.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "Cynthia_UI/CachedBackground.h"
+#include "Cynthia_UI/RepaintCoalescer.h"
+#include "Cynthia_Utilities/ScopeBuffer.h"
+
+class ScopeComponent : public juce::Component, private RepaintCoalescer::Client
+{
+public:
+    ScopeComponent(ScopeBuffer &scopeBuffer, RepaintCoalescer &coalescer);
+    ~ScopeComponent() override;
+
+private:
+    void paint(juce::Graphics &g) override;
+    void resized() override;
+    bool updateFrame() override;
+
+    void paintBackground(juce::Graphics &g) const;
+
+    // copy the newest audio and update the scope trace and the spectrum from it
+    void analyse();
+
+    void drawScope(juce::Graphics &g, juce::Rectangle<float> area) const;
+    void drawSpectrum(juce::Graphics &g, juce::Rectangle<float> area) const;
+
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int scopeLength = fftSize / 2; // samples shown on the scope
+    static constexpr int frameRate = 30;
+    static constexpr float minDecibels = -90.0f;
+    static constexpr float decayDecibelsPerFrame = 1.5f; // how fast spectrum peaks fall back
+
+    const juce::String scopeHeader = "Scope";
+    const juce::String spectrumHeader = "Spectrum";
+
+    ScopeBuffer &scopeBuffer;
+    RepaintCoalescer &coalescer;
+    uint32_t lastWritePosition = 0;
+    CachedBackground background;
+
+    juce::dsp::FFT fft { fftOrder };
+    juce::dsp::WindowingFunction<float> window { static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann };
+
+    std::array<float, fftSize> latestSamples {};
+    std::array<float, 2 * fftSize> fftData {}; // performFrequencyOnlyForwardTransform() needs twice the size
+    std::array<float, fftSize / 2> spectrumDecibels;
+    std::array<float, scopeLength> scopeSamples {};
+
+    juce::Rectangle<int> scopeArea, spectrumArea;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScopeComponent)
+};
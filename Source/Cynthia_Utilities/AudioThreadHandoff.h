@@ -0,0 +1,74 @@
+/*
+    AudioThreadHandoff.h
+
+    Hands immutable, reference counted objects (such as a Wavetable) built on a background
+    thread to the audio thread, without the audio thread ever blocking, allocating or
+    deleting anything.
+
+    The audio thread only ever sees raw pointers. Every published object is also kept in a
+    release pool, and releaseUnused() (message thread) drops the ones the audio thread has
+    moved on from, so the last reference always goes away off the audio thread.
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+template <typename ObjectType>
+class AudioThreadHandoff
+{
+public:
+
+    using Ptr = juce::ReferenceCountedObjectPtr<ObjectType>;
+
+    // make an object available to the audio thread. Any thread except the audio thread
+    void publish(Ptr object)
+    {
+        const juce::SpinLock::ScopedLockType scopedLock(lock);
+
+        pool.add(object);
+        pending = object.get();
+    }
+
+    // audio thread: the most recently published object if there's a new one, otherwise nullptr.
+    // if another thread is publishing right now, the object is picked up on the next call
+    ObjectType* takeLatest() noexcept
+    {
+        const juce::SpinLock::ScopedTryLockType scopedLock(lock);
+
+        if (! scopedLock.isLocked() || pending == nullptr)
+            return nullptr;
+
+        current = pending;
+        pending = nullptr;
+        return current;
+    }
+
+    // free every object that is neither in use nor about to be. Message thread
+    void releaseUnused()
+    {
+        juce::ReferenceCountedArray<ObjectType> unused;
+
+        {
+            const juce::SpinLock::ScopedLockType scopedLock(lock);
+
+            for (int index = pool.size(); --index >= 0;)
+            {
+                auto* object = pool.getUnchecked(index);
+
+                // the pool's reference is the only one left
+                if (object != current && object != pending && object->getReferenceCount() == 1)
+                    unused.add(pool.removeAndReturn(index));
+            }
+        }
+
+        // the objects are deleted here, outside the lock
+    }
+
+private:
+
+    juce::SpinLock lock;
+    juce::ReferenceCountedArray<ObjectType> pool;
+    ObjectType* pending = nullptr;
+    ObjectType* current = nullptr;
+};
@@ -0,0 +1,113 @@
+/*
+    LiveMidiQueue.h
+
+    MIDI played live on the message thread (the editor's on-screen keyboard) on its way to the
+    audio thread, without locks.
+
+    JUCE's MidiKeyboardState and MidiMessageCollector hand MIDI over behind a CriticalSection,
+    so the audio thread can end up waiting for the message thread. This is a wait-free
+    LockFreeQueue instead, for one producer thread (the message thread) and the audio thread.
+
+    Every event is stamped with the time it was pushed. At the start of each block the audio
+    thread takes everything queued since the previous block, and spreads the time between the
+    two drains over the block: an event played halfway between them lands halfway through it.
+    Callbacks rarely come exactly one block apart, so going by the actual interval keeps the
+    events' spacing, instead of piling early or late ones onto the block's edges. Live notes
+    come in about one block late, rather than all on the first sample of a block.
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "Cynthia_Utilities/LockFreeQueue.h"
+
+class LiveMidiQueue
+{
+public:
+
+    static constexpr int capacity = 256;
+
+    // before processing starts
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        lastDrainTime = -1.0;
+    }
+
+    // producer thread. Only short messages (notes, controllers, pitch bend...) fit. Returns false
+    // and drops the message if it doesn't, or the queue is full
+    bool push(const juce::MidiMessage &message)
+    {
+        return push(message, juce::Time::getMillisecondCounterHiRes() * 0.001);
+    }
+
+    bool push(const juce::MidiMessage &message, double timeInSeconds)
+    {
+        if (message.getRawDataSize() > 3)
+            return false;
+
+        Event event;
+        event.time = timeInSeconds;
+        event.size = static_cast<uint8_t>(message.getRawDataSize());
+        std::copy(message.getRawData(), message.getRawData() + event.size, event.data.begin());
+
+        return events.push(event);
+    }
+
+    // audio thread, at the start of every block (even when nothing was played, since it also
+    // keeps track of when blocks start). Adds the queued events to midiMessages and returns how many
+    int drainInto(juce::MidiBuffer &midiMessages, int numSamples)
+    {
+        return drainInto(midiMessages, numSamples, juce::Time::getMillisecondCounterHiRes() * 0.001);
+    }
+
+    int drainInto(juce::MidiBuffer &midiMessages, int numSamples, double nowInSeconds)
+    {
+        // the time since the last drain maps onto this block. After a gap (the first block, or
+        // the host stopped calling for a while) only the last block's worth counts, and
+        // anything older lands on the first sample
+        double blockSeconds = numSamples / sampleRate;
+        double windowStart = lastDrainTime;
+
+        if (lastDrainTime < 0.0 || nowInSeconds - lastDrainTime > maxIntervalInBlocks * blockSeconds)
+            windowStart = nowInSeconds - blockSeconds;
+
+        double windowSeconds = nowInSeconds - windowStart;
+        lastDrainTime = nowInSeconds;
+
+        int numEvents = 0;
+        Event event;
+
+        while (events.pop(event))
+        {
+            int offset = 0;
+
+            if (windowSeconds > 0.0)
+                offset = juce::roundToInt((event.time - windowStart) / windowSeconds * numSamples);
+
+            offset = juce::jlimit(0, juce::jmax(0, numSamples - 1), offset);
+
+            midiMessages.addEvent(event.data.data(), event.size, offset);
+            ++numEvents;
+        }
+
+        return numEvents;
+    }
+
+private:
+    struct Event
+    {
+        double time = 0.0;
+        std::array<uint8_t, 3> data {};
+        uint8_t size = 0;
+    };
+
+    // a longer interval between drains than this counts as a gap
+    static constexpr double maxIntervalInBlocks = 4.0;
+
+    LockFreeQueue<Event, capacity> events;
+
+    // audio thread only
+    double sampleRate = 44100.0;
+    double lastDrainTime = -1.0;
+};
@@ -0,0 +1,62 @@
+/*
+    LockFreeQueue.h
+
+    A fixed-capacity, wait-free queue for exactly one producer thread and one consumer thread,
+    built on juce::AbstractFifo. Items are copied in and out of preallocated storage,
+    so neither side ever allocates or locks.
+*/
+
+#pragma once
+
+#include <array>
+#include <juce_core/juce_core.h>
+
+template <typename T, int Capacity>
+class LockFreeQueue
+{
+public:
+
+    // returns false (and drops the item) if the queue is full
+    bool push(const T& item)
+    {
+        const auto scope = fifo.write(1);
+
+        if (scope.blockSize1 > 0)
+        {
+            items[static_cast<size_t>(scope.startIndex1)] = item;
+            return true;
+        }
+
+        return false;
+    }
+
+    // returns false if there was nothing to read
+    bool pop(T& item)
+    {
+        const auto scope = fifo.read(1);
+
+        if (scope.blockSize1 > 0)
+        {
+            item = items[static_cast<size_t>(scope.startIndex1)];
+            return true;
+        }
+
+        return false;
+    }
+
+    int getNumReady() const
+    {
+        return fifo.getNumReady();
+    }
+
+    // only safe while neither thread is using the queue
+    void reset()
+    {
+        fifo.reset();
+    }
+
+private:
+    // AbstractFifo keeps one slot free to tell "full" from "empty"
+    juce::AbstractFifo fifo { Capacity + 1 };
+    std::array<T, Capacity + 1> items;
+};
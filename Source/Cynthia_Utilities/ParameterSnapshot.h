@@ -0,0 +1,70 @@
+/*
+    ParameterSnapshot.h
+
+    The normalised (0 to 1) value of every plugin parameter, in the order the processor
+    reports them from getParameters(). Fixed size, so a snapshot can be handed to the
+    audio thread through a LockFreeQueue and read there without allocating.
+*/
+
+#pragma once
+
+#include <array>
+#include <juce_audio_processors/juce_audio_processors.h>
+
+struct ParameterSnapshot
+{
+    static constexpr int maxParameters = 64;
+
+    std::array<float, maxParameters> values {};
+    int numValues = 0;
+
+    // the parameters' current values
+    static ParameterSnapshot capture(const juce::Array<juce::AudioProcessorParameter*>& parameters)
+    {
+        jassert(parameters.size() <= maxParameters);
+
+        ParameterSnapshot snapshot;
+        snapshot.numValues = juce::jmin(parameters.size(), maxParameters);
+
+        for (int index = 0; index < snapshot.numValues; ++index)
+            snapshot.values[index] = parameters[index]->getValue();
+
+        return snapshot;
+    }
+
+    // the parameters' default values
+    static ParameterSnapshot defaults(const juce::Array<juce::AudioProcessorParameter*>& parameters)
+    {
+        jassert(parameters.size() <= maxParameters);
+
+        ParameterSnapshot snapshot;
+        snapshot.numValues = juce::jmin(parameters.size(), maxParameters);
+
+        for (int index = 0; index < snapshot.numValues; ++index)
+            snapshot.values[index] = parameters[index]->getDefaultValue();
+
+        return snapshot;
+    }
+
+    // index of the parameter with this ID, or -1
+    static int findIndex(const juce::Array<juce::AudioProcessorParameter*>& parameters, const juce::String& paramID)
+    {
+        for (int index = 0; index < parameters.size(); ++index)
+        {
+            if (auto* parameter = dynamic_cast<juce::AudioProcessorParameterWithID*>(parameters[index]))
+                if (parameter->paramID == paramID)
+                    return index;
+        }
+
+        return -1;
+    }
+
+    // set the values and tell the host and editor about them. Message thread only
+    void applyToNotifyingHost(const juce::Array<juce::AudioProcessorParameter*>& parameters) const
+    {
+        int count = juce::jmin(numValues, parameters.size());
+
+        for (int index = 0; index < count; ++index)
+            parameters.getUnchecked(index)->setValueNotifyingHost(values[index]);
+    }
+};
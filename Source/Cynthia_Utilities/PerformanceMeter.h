@@ -0,0 +1,142 @@
+/*
+    PerformanceMeter.h
+
+    How close the audio thread gets to its deadline, and how hard the voice pool is working.
+
+    The audio thread times every processBlock() call and records the voice counts. All of it
+    lands in atomics, so any thread can take a snapshot (getStats()) at any time without
+    slowing the audio thread down.
+
+    Load is render time over the time the block represents. 1.0 means the block took as long
+    as it lasts, i.e. an xrun. Blocks above xrunRiskThreshold are counted as near misses,
+    since the host and other plugins need their share of the deadline too.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+class PerformanceMeter
+{
+public:
+    // a block using more than this much of its time counts as an xrun risk
+    static constexpr double xrunRiskThreshold = 0.7;
+
+    struct Stats
+    {
+        double load = 0.0;          // smoothed over recent blocks
+        double lastBlockLoad = 0.0;
+        double peakLoad = 0.0;      // since the last reset
+        int activeVoices = 0;
+        int peakVoices = 0;         // since the last reset
+        int voiceLimit = 0;         // voices the stealing logic may use
+        juce::uint64 stolenVoices = 0;
+        juce::uint64 xrunRiskBlocks = 0;
+        juce::uint64 overrunBlocks = 0;
+        juce::uint64 numBlocks = 0;
+    };
+
+    // times one processBlock() call
+    class ScopedBlockTimer
+    {
+    public:
+        ScopedBlockTimer(PerformanceMeter &meter, int numSamples) noexcept
+            : meter(meter), numSamples(numSamples), startTicks(juce::Time::getHighResolutionTicks())
+        {}
+
+        ~ScopedBlockTimer()
+        {
+            auto elapsedTicks = juce::Time::getHighResolutionTicks() - startTicks;
+            meter.registerBlock(juce::Time::highResolutionTicksToSeconds(elapsedTicks), numSamples);
+        }
+
+    private:
+        PerformanceMeter &meter;
+        int numSamples;
+        juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedBlockTimer)
+    };
+
+    // message thread, from prepareToPlay()
+    void prepare(double newSampleRate, int maxBlockSize)
+    {
+        sampleRate = newSampleRate;
+        loadMeasurer.reset(newSampleRate, maxBlockSize);
+        reset();
+    }
+
+    // audio thread: what the synth's voice pool looks like at the end of the block
+    void recordVoices(int activeVoices, int voiceLimit, int newlyStolenVoices) noexcept
+    {
+        currentVoices.store(activeVoices, std::memory_order_relaxed);
+        currentVoiceLimit.store(voiceLimit, std::memory_order_relaxed);
+        stolenVoices.fetch_add(static_cast<juce::uint64>(newlyStolenVoices), std::memory_order_relaxed);
+
+        if (activeVoices > peakVoices.load(std::memory_order_relaxed))
+            peakVoices.store(activeVoices, std::memory_order_relaxed);
+    }
+
+    // any thread
+    Stats getStats() const noexcept
+    {
+        Stats stats;
+        stats.load = loadMeasurer.getLoadAsProportion();
+        stats.lastBlockLoad = lastBlockLoad.load(std::memory_order_relaxed);
+        stats.peakLoad = peakLoad.load(std::memory_order_relaxed);
+        stats.activeVoices = currentVoices.load(std::memory_order_relaxed);
+        stats.peakVoices = peakVoices.load(std::memory_order_relaxed);
+        stats.voiceLimit = currentVoiceLimit.load(std::memory_order_relaxed);
+        stats.stolenVoices = stolenVoices.load(std::memory_order_relaxed);
+        stats.xrunRiskBlocks = xrunRiskBlocks.load(std::memory_order_relaxed);
+        stats.overrunBlocks = overrunBlocks.load(std::memory_order_relaxed);
+        stats.numBlocks = numBlocks.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    // any thread: start counting peaks and events from scratch
+    void reset() noexcept
+    {
+        peakLoad.store(0.0);
+        peakVoices.store(0);
+        stolenVoices.store(0);
+        xrunRiskBlocks.store(0);
+        overrunBlocks.store(0);
+        numBlocks.store(0);
+    }
+
+private:
+    void registerBlock(double seconds, int numSamples) noexcept
+    {
+        if (numSamples <= 0 || sampleRate <= 0.0)
+            return;
+
+        double load = seconds * sampleRate / numSamples;
+
+        loadMeasurer.registerRenderTime(seconds * 1000.0, numSamples);
+        lastBlockLoad.store(load, std::memory_order_relaxed);
+        numBlocks.fetch_add(1, std::memory_order_relaxed);
+
+        if (load > peakLoad.load(std::memory_order_relaxed))
+            peakLoad.store(load, std::memory_order_relaxed);
+
+        if (load > 1.0)
+            overrunBlocks.fetch_add(1, std::memory_order_relaxed);
+        else if (load > xrunRiskThreshold)
+            xrunRiskBlocks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    double sampleRate = 0.0;
+    juce::AudioProcessLoadMeasurer loadMeasurer;
+
+    std::atomic<double> lastBlockLoad { 0.0 };
+    std::atomic<double> peakLoad { 0.0 };
+    std::atomic<int> currentVoices { 0 };
+    std::atomic<int> peakVoices { 0 };
+    std::atomic<int> currentVoiceLimit { 0 };
+    std::atomic<juce::uint64> stolenVoices { 0 };
+    std::atomic<juce::uint64> xrunRiskBlocks { 0 };
+    std::atomic<juce::uint64> overrunBlocks { 0 };
+    std::atomic<juce::uint64> numBlocks { 0 };
+};
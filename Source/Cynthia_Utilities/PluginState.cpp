@@ -0,0 +1,123 @@
+#include "Cynthia_Utilities/PluginState.h"
+
+namespace
+{
+    constexpr int headerSize = 4 + 2 + 2 + 4;
+    constexpr int entrySize = 4 + 4;
+
+    int getParameterIDHash(juce::AudioProcessorParameter* parameter)
+    {
+        if (auto* parameterWithID = dynamic_cast<juce::AudioProcessorParameterWithID*>(parameter))
+            return parameterWithID->paramID.hashCode();
+
+        return 0;
+    }
+}
+
+bool PluginState::isBinaryState(const void* data, int sizeInBytes)
+{
+    return data != nullptr
+        && sizeInBytes >= headerSize
+        && juce::ByteOrder::littleEndianInt(data) == binaryMagic;
+}
+
+void PluginState::writeBinary(const juce::Array<juce::AudioProcessorParameter*>& parameters,
+                              const Extras& extras,
+                              juce::MemoryBlock& destData)
+{
+    destData.setSize(0);
+    destData.ensureSize(static_cast<size_t>(headerSize + parameters.size() * entrySize));
+
+    juce::MemoryOutputStream stream(destData, false);
+
+    stream.writeInt(static_cast<int>(binaryMagic));
+    stream.writeShort(static_cast<short>(binaryVersion));
+    stream.writeShort(static_cast<short>(parameters.size()));
+    stream.writeInt(extras.program);
+
+    for (auto* parameter : parameters)
+    {
+        stream.writeInt(getParameterIDHash(parameter));
+        stream.writeFloat(parameter->getValue());
+    }
+
+    stream.writeString(extras.userWavetable);
+}
+
+bool PluginState::readBinary(const void* data,
+                             int sizeInBytes,
+                             const juce::Array<juce::AudioProcessorParameter*>& parameters,
+                             ParameterSnapshot& snapshot,
+                             Extras& extras)
+{
+    if (! isBinaryState(data, sizeInBytes))
+        return false;
+
+    juce::MemoryInputStream stream(data, static_cast<size_t>(sizeInBytes), false);
+
+    stream.readInt(); // magic
+    int version = static_cast<juce::uint16>(stream.readShort());
+    int numEntries = static_cast<juce::uint16>(stream.readShort());
+    extras = {};
+    extras.program = stream.readInt();
+
+    if (version < 1 || stream.getNumBytesRemaining() < static_cast<juce::int64>(numEntries) * entrySize)
+        return false;
+
+    snapshot = ParameterSnapshot::defaults(parameters);
+
+    for (int entry = 0; entry < numEntries; ++entry)
+    {
+        int idHash = stream.readInt();
+        float value = stream.readFloat();
+
+        for (int index = 0; index < snapshot.numValues; ++index)
+        {
+            if (getParameterIDHash(parameters[index]) == idHash)
+            {
+                snapshot.values[index] = juce::jlimit(0.0f, 1.0f, value);
+                break;
+            }
+        }
+    }
+
+    if (version >= 2 && ! stream.isExhausted())
+        extras.userWavetable = stream.readString();
+
+    return true;
+}
+
+juce::uint64 PluginState::computeFingerprint(const void* data, int sizeInBytes)
+{
+    if (! isBinaryState(data, sizeInBytes))
+        return data != nullptr ? static_cast<juce::uint64>(juce::String::createStringFromData(data, sizeInBytes).hashCode64()) : 0;
+
+    juce::MemoryInputStream stream(data, static_cast<size_t>(sizeInBytes), false);
+
+    stream.readInt(); // magic
+    stream.readShort(); // version
+    int numEntries = static_cast<juce::uint16>(stream.readShort());
+    stream.readInt(); // program
+
+    numEntries = juce::jmin(numEntries, static_cast<int>(stream.getNumBytesRemaining() / entrySize));
+
+    // summing mixed per-entry hashes makes the result independent of the parameter order
+    juce::uint64 fingerprint = 0;
+
+    for (int entry = 0; entry < numEntries; ++entry)
+    {
+        auto idHash = static_cast<juce::uint32>(stream.readInt());
+        auto quantised = static_cast<juce::uint32>(juce::roundToInt(juce::jlimit(0.0f, 1.0f, stream.readFloat()) * 1023.0f));
+
+        juce::uint64 mixed = (static_cast<juce::uint64>(idHash) << 32) | quantised;
+        mixed ^= mixed >> 33;
+        mixed *= 0xff51afd7ed558ccdULL;
+        mixed ^= mixed >> 33;
+        mixed *= 0xc4ceb9fe1a85ec53ULL;
+        mixed ^= mixed >> 33;
+
+        fingerprint += mixed;
+    }
+
+    return fingerprint;
+}
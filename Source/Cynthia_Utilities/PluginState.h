@@ -0,0 +1,64 @@
+/*
+    PluginState.h
+
+    Cynthia's compact binary state format, used by getStateInformation()/setStateInformation().
+
+    Layout (little endian):
+        uint32  magic ("CYNS")
+        uint16  format version
+        uint16  number of parameter entries
+        int32   current program
+        then, for every parameter:
+            int32   hash of the parameter ID
+            float   normalised value
+        version 2 and up:
+            string  path of the user wavetable file (UTF-8, zero terminated; empty if none)
+
+    Parameters are matched by ID hash rather than position, so parameters can be added or
+    reordered without breaking old sessions. Parameters missing from the data get their default.
+    Later versions may append data after the entries; older readers ignore it.
+
+    The processor can also save its state as XML (for diffing sessions and presets), and
+    setStateInformation() accepts either format.
+*/
+
+#pragma once
+
+#include "Cynthia_Utilities/ParameterSnapshot.h"
+
+namespace PluginState
+{
+    enum class Format
+    {
+        Binary,
+        Xml
+    };
+
+    constexpr juce::uint32 binaryMagic = 0x534e5943; // "CYNS" read as a little endian uint32
+    constexpr int binaryVersion = 2;
+
+    // everything in the state besides the parameters
+    struct Extras
+    {
+        int program = 0;
+        juce::String userWavetable;
+    };
+
+    // true if data starts with the binary magic number
+    bool isBinaryState(const void* data, int sizeInBytes);
+
+    void writeBinary(const juce::Array<juce::AudioProcessorParameter*>& parameters,
+                     const Extras& extras,
+                     juce::MemoryBlock& destData);
+
+    // fills snapshot and extras from binary state. Returns false if the data is malformed
+    bool readBinary(const void* data,
+                    int sizeInBytes,
+                    const juce::Array<juce::AudioProcessorParameter*>& parameters,
+                    ParameterSnapshot& snapshot,
+                    Extras& extras);
+
+    // a hash of the parameter values in binary state, quantised so tiny rounding differences
+    // don't matter and independent of the entry order. Other data is hashed as-is
+    juce::uint64 computeFingerprint(const void* data, int sizeInBytes);
+}
@@ -0,0 +1,310 @@
+#include "Cynthia_Utilities/PresetLibrary.h"
+#include "Cynthia_Utilities/PluginState.h"
+#include <algorithm>
+#include <map>
+
+namespace
+{
+    constexpr juce::uint32 cacheMagic = 0x494e5943; // "CYNI" read as a little endian uint32
+    constexpr int cacheVersion = 1;
+
+    const char* cacheFileName = ".cynthia-index";
+
+    // sub-folders of the preset folder double as tags, e.g. Pads/Warm/Glass.cynpreset
+    juce::StringArray getTagsFromPath(const juce::File& file, const juce::File& folder)
+    {
+        auto relativePath = file.getParentDirectory().getRelativePathFrom(folder);
+        auto tags = juce::StringArray::fromTokens(relativePath, "/\\", "");
+        tags.removeString(".");
+        tags.removeEmptyStrings();
+        return tags;
+    }
+
+    juce::File& getDefaultFolderOverride()
+    {
+        static juce::File folder;
+        return folder;
+    }
+}
+
+PresetLibrary::PresetLibrary()
+    : PresetLibrary(getDefaultPresetFolder())
+{
+}
+
+PresetLibrary::PresetLibrary(const juce::File& folder)
+    : juce::Thread("Cynthia preset scanner")
+{
+    setPresetFolder(folder);
+    startThread(juce::Thread::Priority::low);
+}
+
+PresetLibrary::~PresetLibrary()
+{
+    signalThreadShouldExit();
+    notify();
+    stopThread(4000);
+}
+
+juce::File PresetLibrary::getDefaultPresetFolder()
+{
+    if (getDefaultFolderOverride() != juce::File())
+        return getDefaultFolderOverride();
+
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("Cynthia")
+        .getChildFile("Presets");
+}
+
+void PresetLibrary::setDefaultPresetFolder(const juce::File& folder)
+{
+    getDefaultFolderOverride() = folder;
+}
+
+void PresetLibrary::setPresetFolder(const juce::File& newFolder)
+{
+    {
+        const juce::ScopedLock scopedLock(lock);
+        presetFolder = newFolder;
+        index = std::make_shared<const Index>();
+    }
+
+    // whatever the last scan of this folder found is good enough until the rescan finishes
+    if (readCache(newFolder))
+        sendChangeMessage();
+
+    rescan();
+}
+
+juce::File PresetLibrary::getPresetFolder() const
+{
+    const juce::ScopedLock scopedLock(lock);
+    return presetFolder;
+}
+
+void PresetLibrary::rescan()
+{
+    rescanRequested.store(true);
+    notify();
+}
+
+std::shared_ptr<const PresetLibrary::Index> PresetLibrary::getIndex() const
+{
+    const juce::ScopedLock scopedLock(lock);
+    return index;
+}
+
+std::vector<int> PresetLibrary::search(const juce::String& text) const
+{
+    auto currentIndex = getIndex();
+    std::vector<int> matches;
+
+    for (size_t entry = 0; entry < currentIndex->size(); ++entry)
+    {
+        const auto& preset = (*currentIndex)[entry];
+
+        if (text.isEmpty()
+            || preset.name.containsIgnoreCase(text)
+            || std::any_of(preset.tags.begin(), preset.tags.end(), [&](const auto& tag) { return tag.containsIgnoreCase(text); }))
+        {
+            matches.push_back(static_cast<int>(entry));
+        }
+    }
+
+    return matches;
+}
+
+juce::File PresetLibrary::savePreset(const juce::String& name, const juce::MemoryBlock& state, const juce::StringArray& tags)
+{
+    auto folder = getPresetFolder();
+
+    for (const auto& tag : tags)
+        folder = folder.getChildFile(juce::File::createLegalFileName(tag));
+
+    auto file = folder.getChildFile(juce::File::createLegalFileName(name) + fileExtension);
+
+    if (! folder.createDirectory() || ! file.replaceWithData(state.getData(), state.getSize()))
+        return {};
+
+    rescan();
+    return file;
+}
+
+void PresetLibrary::run()
+{
+    while (! threadShouldExit())
+    {
+        if (rescanRequested.exchange(false))
+            scan();
+
+        wait(-1);
+    }
+}
+
+/*
+    Only files that are new, or whose size or modification time changed, are read.
+    Everything else is carried over from the previous index, so rescanning a large,
+    mostly unchanged library costs little more than listing the folder.
+*/
+void PresetLibrary::scan()
+{
+    auto folder = getPresetFolder();
+    auto previous = getIndex();
+
+    std::map<juce::String, const Entry*> previousEntries;
+    for (const auto& entry : *previous)
+        previousEntries[entry.file.getFullPathName()] = &entry;
+
+    auto newIndex = std::make_shared<Index>();
+    newIndex->reserve(previous->size());
+
+    bool changed = false;
+
+    for (const auto& directoryEntry : juce::RangedDirectoryIterator(folder, true, "*" + fileExtension, juce::File::findFiles))
+    {
+        // a new folder or shutdown. Leave the current index alone
+        if (threadShouldExit() || rescanRequested.load())
+            return;
+
+        auto file = directoryEntry.getFile();
+        auto fileSize = directoryEntry.getFileSize();
+        auto modificationTime = directoryEntry.getModificationTime().toMilliseconds();
+
+        auto found = previousEntries.find(file.getFullPathName());
+
+        if (found != previousEntries.end()
+            && found->second->fileSize == fileSize
+            && found->second->modificationTime == modificationTime)
+        {
+            newIndex->push_back(*found->second);
+            continue;
+        }
+
+        newIndex->push_back(readEntry(file, folder, fileSize, modificationTime));
+        changed = true;
+    }
+
+    if (! changed && newIndex->size() == previous->size())
+        return;
+
+    std::sort(newIndex->begin(), newIndex->end(), [](const Entry& a, const Entry& b)
+    {
+        return a.name.compareNatural(b.name) < 0;
+    });
+
+    writeCache(*newIndex, folder);
+    publish(std::move(newIndex), folder);
+}
+
+void PresetLibrary::publish(std::shared_ptr<const Index> newIndex, const juce::File& scannedFolder)
+{
+    {
+        const juce::ScopedLock scopedLock(lock);
+
+        // the folder was switched while this scan was finishing
+        if (scannedFolder != presetFolder)
+            return;
+
+        index = std::move(newIndex);
+    }
+
+    sendChangeMessage();
+}
+
+PresetLibrary::Entry PresetLibrary::readEntry(const juce::File& file, const juce::File& folder, juce::int64 fileSize, juce::int64 modificationTime) const
+{
+    Entry entry;
+    entry.name = file.getFileNameWithoutExtension();
+    entry.tags = getTagsFromPath(file, folder);
+    entry.file = file;
+    entry.fileSize = fileSize;
+    entry.modificationTime = modificationTime;
+
+    if (file.loadFileAsData(entry.state))
+        entry.fingerprint = PluginState::computeFingerprint(entry.state.getData(), static_cast<int>(entry.state.getSize()));
+
+    return entry;
+}
+
+
+/*
+    Cache layout: magic, version, entry count, then for every entry its path relative to the
+    preset folder, file size, modification time, name, tags, fingerprint and state data.
+*/
+bool PresetLibrary::readCache(const juce::File& folder)
+{
+    juce::FileInputStream stream(folder.getChildFile(cacheFileName));
+
+    if (! stream.openedOk()
+        || static_cast<juce::uint32>(stream.readInt()) != cacheMagic
+        || stream.readInt() != cacheVersion)
+        return false;
+
+    int numEntries = stream.readInt();
+
+    auto cachedIndex = std::make_shared<Index>();
+    cachedIndex->reserve(static_cast<size_t>(juce::jmax(0, numEntries)));
+
+    for (int entryNumber = 0; entryNumber < numEntries; ++entryNumber)
+    {
+        Entry entry;
+        entry.file = folder.getChildFile(stream.readString());
+        entry.fileSize = stream.readInt64();
+        entry.modificationTime = stream.readInt64();
+        entry.name = stream.readString();
+        entry.tags = juce::StringArray::fromTokens(stream.readString(), "\n", "");
+        entry.fingerprint = static_cast<juce::uint64>(stream.readInt64());
+
+        auto stateSize = static_cast<size_t>(stream.readCompressedInt());
+
+        if (stream.isExhausted() || stateSize > static_cast<size_t>(stream.getNumBytesRemaining()))
+            return false;
+
+        entry.state.setSize(stateSize);
+        stream.read(entry.state.getData(), static_cast<int>(stateSize));
+
+        cachedIndex->push_back(std::move(entry));
+    }
+
+    const juce::ScopedLock scopedLock(lock);
+
+    if (folder != presetFolder)
+        return false;
+
+    index = std::move(cachedIndex);
+    return true;
+}
+
+void PresetLibrary::writeCache(const Index& indexToWrite, const juce::File& folder) const
+{
+    if (! folder.isDirectory())
+        return;
+
+    // write to a temporary file first, so a crash never leaves a half-written cache behind
+    juce::TemporaryFile temporaryFile(folder.getChildFile(cacheFileName));
+
+    {
+        juce::FileOutputStream stream(temporaryFile.getFile());
+
+        if (! stream.openedOk())
+            return;
+
+        stream.writeInt(static_cast<int>(cacheMagic));
+        stream.writeInt(cacheVersion);
+        stream.writeInt(static_cast<int>(indexToWrite.size()));
+
+        for (const auto& entry : indexToWrite)
+        {
+            stream.writeString(entry.file.getRelativePathFrom(folder));
+            stream.writeInt64(entry.fileSize);
+            stream.writeInt64(entry.modificationTime);
+            stream.writeString(entry.name);
+            stream.writeString(entry.tags.joinIntoString("\n"));
+            stream.writeInt64(static_cast<juce::int64>(entry.fingerprint));
+            stream.writeCompressedInt(static_cast<int>(entry.state.getSize()));
+            stream.write(entry.state.getData(), entry.state.getSize());
+        }
+    }
+
+    temporaryFile.overwriteTargetFileWithTemporary();
+}
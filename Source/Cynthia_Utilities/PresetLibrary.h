@@ -0,0 +1,95 @@
+/*
+    PresetLibrary.h
+
+    The preset browser backend.
+
+    Presets are files (*.cynpreset) holding exactly what CynthiaAudioProcessor::getStateInformation()
+    writes, anywhere under the preset folder. Sub-folder names become the preset's tags.
+
+    The folder is scanned on a background thread. The result is an immutable index (name, tags,
+    parameter fingerprint and the preset data itself), so browsing and previewing never touch the disk.
+    The index is cached next to the presets, which makes startup instant: the cached index is
+    available right away, and the background scan only re-reads files that changed since.
+
+    One library is shared by every Cynthia instance in the process (see juce::SharedResourcePointer).
+    It opens the default preset folder, which tests point somewhere else with setDefaultPresetFolder()
+    so they never touch the user's library. Other libraries can be given a folder of their own.
+*/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <juce_events/juce_events.h>
+
+class PresetLibrary : public juce::ChangeBroadcaster,
+                      private juce::Thread
+{
+public:
+
+    struct Entry
+    {
+        juce::String name;
+        juce::StringArray tags;
+        juce::File file;
+        juce::int64 fileSize = 0;
+        juce::int64 modificationTime = 0;
+
+        // hash of the quantised parameter values. Equal fingerprints mean (almost) identical sounds
+        juce::uint64 fingerprint = 0;
+
+        // the preset's state data, ready for setStateInformation()
+        juce::MemoryBlock state;
+    };
+
+    using Index = std::vector<Entry>;
+
+    static inline const juce::String fileExtension = ".cynpreset";
+
+    PresetLibrary();
+    explicit PresetLibrary(const juce::File& folder);
+    ~PresetLibrary() override;
+
+    // the user's preset folder, unless it was overridden
+    static juce::File getDefaultPresetFolder();
+
+    // use another folder as the default, for libraries created from now on. An empty File
+    // goes back to the user's folder. Message thread only
+    static void setDefaultPresetFolder(const juce::File& folder);
+
+    // switch to another folder. Its cached index (if any) is loaded right away, then it is rescanned
+    void setPresetFolder(const juce::File& newFolder);
+    juce::File getPresetFolder() const;
+
+    // ask the background thread to look for added, changed or removed presets
+    void rescan();
+
+    // the current index. It never changes once handed out, a rescan publishes a new one
+    std::shared_ptr<const Index> getIndex() const;
+
+    // indices of the entries whose name or tags contain the text (all entries if the text is empty)
+    std::vector<int> search(const juce::String& text) const;
+
+    // write a preset into the folder (tags become sub-folders) and rescan
+    juce::File savePreset(const juce::String& name, const juce::MemoryBlock& state, const juce::StringArray& tags = {});
+
+private:
+
+    void run() override;
+    void scan();
+
+    void publish(std::shared_ptr<const Index> newIndex, const juce::File& scannedFolder);
+
+    bool readCache(const juce::File& folder);
+    void writeCache(const Index& indexToWrite, const juce::File& folder) const;
+
+    Entry readEntry(const juce::File& file, const juce::File& folder, juce::int64 fileSize, juce::int64 modificationTime) const;
+
+    mutable juce::CriticalSection lock;
+    juce::File presetFolder;
+    std::shared_ptr<const Index> index;
+
+    std::atomic<bool> rescanRequested { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetLibrary)
+};
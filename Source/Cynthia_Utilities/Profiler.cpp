@@ -0,0 +1,193 @@
+/*
+    Profiler.cpp
+
+    See Profiler.h. The audio thread side (addCycles(), finishBlock()) only touches plain
+    per-block arrays, atomics and a LockFreeQueue, so it never allocates or locks.
+*/
+
+#include "Cynthia_Utilities/Profiler.h"
+#include "Cynthia_Utilities/LockFreeQueue.h"
+
+namespace Profiler
+{
+    const char* getStageName(Stage stage)
+    {
+        switch (stage)
+        {
+            case Stage::ProcessBlock:        return "processBlock";
+            case Stage::SplitBufferByEvents: return "splitBufferByEvents";
+            case Stage::VoiceLFO:            return "voice LFO";
+            case Stage::VoiceOscillator2:    return "voice oscillator 2";
+            case Stage::VoiceOscillator:     return "voice oscillator";
+            case Stage::VoiceNoise:          return "voice noise";
+            case Stage::VoiceEnvelope:       return "voice envelope";
+            case Stage::VoiceFilter:         return "voice filter";
+            case Stage::VoiceOutput:         return "voice output";
+            case Stage::Effects:             return "effects";
+            case Stage::NumStages:           break;
+        }
+
+        return "";
+    }
+
+#if CYNTHIA_PROFILING
+    namespace
+    {
+        struct BlockRecord
+        {
+            juce::int64 startTicks = 0;
+            juce::int64 endTicks = 0;
+            int numSamples = 0;
+            std::array<juce::uint64, numStages> cycles {};
+        };
+
+        // the block in progress. A block's stages are all added on the thread that finishes it,
+        // so every audio thread (several instances, or a host with more than one) keeps its own
+        thread_local std::array<juce::uint64, numStages> blockCycles {};
+        thread_local std::array<juce::uint64, numStages> blockCalls {};
+
+        std::array<std::atomic<juce::uint64>, numStages> totalCycles {};
+        std::array<std::atomic<juce::uint64>, numStages> totalCalls {};
+        std::atomic<juce::uint64> numBlocks { 0 };
+        std::atomic<juce::uint64> numDroppedBlocks { 0 };
+
+        // about 20 s of 256 sample blocks at 48 kHz, before the oldest have to be exported.
+        // the queue takes one producer, so an audio thread that finds another one pushing
+        // drops its record rather than wait
+        LockFreeQueue<BlockRecord, 4096> records;
+        std::atomic_flag pushingRecord = ATOMIC_FLAG_INIT;
+    }
+
+    void addCycles(Stage stage, juce::uint64 cycles) noexcept
+    {
+        auto index = static_cast<size_t>(stage);
+        blockCycles[index] += cycles;
+        ++blockCalls[index];
+    }
+
+    void finishBlock(juce::int64 startTicks, juce::int64 endTicks, int numSamples) noexcept
+    {
+        BlockRecord record;
+        record.startTicks = startTicks;
+        record.endTicks = endTicks;
+        record.numSamples = numSamples;
+        record.cycles = blockCycles;
+
+        for (size_t index = 0; index < static_cast<size_t>(numStages); ++index)
+        {
+            totalCycles[index].fetch_add(blockCycles[index], std::memory_order_relaxed);
+            totalCalls[index].fetch_add(blockCalls[index], std::memory_order_relaxed);
+        }
+
+        blockCycles.fill(0);
+        blockCalls.fill(0);
+
+        bool pushed = false;
+
+        if (! pushingRecord.test_and_set(std::memory_order_acquire))
+        {
+            pushed = records.push(record);
+            pushingRecord.clear(std::memory_order_release);
+        }
+
+        if (! pushed)
+            numDroppedBlocks.fetch_add(1, std::memory_order_relaxed);
+
+        numBlocks.fetch_add(1, std::memory_order_relaxed);
+    }
+#endif
+
+    Totals getTotals()
+    {
+        Totals totals;
+
+       #if CYNTHIA_PROFILING
+        for (size_t index = 0; index < static_cast<size_t>(numStages); ++index)
+        {
+            totals.cycles[index] = totalCycles[index].load(std::memory_order_relaxed);
+            totals.calls[index] = totalCalls[index].load(std::memory_order_relaxed);
+        }
+
+        totals.numBlocks = numBlocks.load(std::memory_order_relaxed);
+        totals.numDroppedBlocks = numDroppedBlocks.load(std::memory_order_relaxed);
+       #endif
+
+        return totals;
+    }
+
+    juce::String toChromeTrace()
+    {
+        juce::Array<juce::var> events;
+
+       #if CYNTHIA_PROFILING
+        // trace timestamps are in microseconds
+        double microsecondsPerTick = 1.0e6 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+        BlockRecord record;
+
+        while (records.pop(record))
+        {
+            double timestamp = static_cast<double>(record.startTicks) * microsecondsPerTick;
+
+            // the block itself, as a slice on the audio thread's track
+            auto *slice = new juce::DynamicObject();
+            slice->setProperty("name", "processBlock");
+            slice->setProperty("ph", "X");
+            slice->setProperty("ts", timestamp);
+            slice->setProperty("dur", static_cast<double>(record.endTicks - record.startTicks) * microsecondsPerTick);
+            slice->setProperty("pid", 1);
+            slice->setProperty("tid", 1);
+
+            auto *sliceArgs = new juce::DynamicObject();
+            sliceArgs->setProperty("numSamples", record.numSamples);
+            slice->setProperty("args", sliceArgs);
+            events.add(slice);
+
+            // a counter track per stage, stepping once per block
+            for (int index = 0; index < numStages; ++index)
+            {
+                auto *counter = new juce::DynamicObject();
+                counter->setProperty("name", juce::String(getStageName(static_cast<Stage>(index))) + " (cycles)");
+                counter->setProperty("ph", "C");
+                counter->setProperty("ts", timestamp);
+                counter->setProperty("pid", 1);
+
+                auto *counterArgs = new juce::DynamicObject();
+                counterArgs->setProperty("cycles", static_cast<juce::int64>(record.cycles[static_cast<size_t>(index)]));
+                counter->setProperty("args", counterArgs);
+                events.add(counter);
+            }
+        }
+       #endif
+
+        auto *trace = new juce::DynamicObject();
+        trace->setProperty("traceEvents", events);
+        trace->setProperty("displayTimeUnit", "ms");
+
+        return juce::JSON::toString(juce::var(trace));
+    }
+
+    bool writeChromeTrace(const juce::File &file)
+    {
+        return file.replaceWithText(toChromeTrace());
+    }
+
+    void reset()
+    {
+       #if CYNTHIA_PROFILING
+        BlockRecord record;
+        while (records.pop(record)) {}
+
+        for (size_t index = 0; index < static_cast<size_t>(numStages); ++index)
+        {
+            totalCycles[index].store(0);
+            totalCalls[index].store(0);
+        }
+
+        // only this thread's block in progress. Other threads' are at most one block's worth
+        blockCycles.fill(0);
+        blockCalls.fill(0);
+        numBlocks.store(0);
+        numDroppedBlocks.store(0);
+       #endif
+    }
+}
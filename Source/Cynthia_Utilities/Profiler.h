@@ -0,0 +1,147 @@
+/*
+    Profiler.h
+
+    Opt-in timing of the audio thread, stage by stage, to find out what actually dominates a block.
+
+    When the project is configured with -DCYNTHIA_PROFILING=ON, CYNTHIA_PROFILE_SCOPE(Stage)
+    counts the CPU cycles spent in a scope (rdtsc on x86, the virtual counter on ARM) and adds
+    them to its stage's total for the block. CYNTHIA_PROFILE_BLOCK(numSamples) marks a whole
+    processBlock(): when it ends, the block's totals go into lock-free counters and into a queue
+    of per-block records, which any thread can read back without disturbing the audio thread.
+
+    Stages nest, so their times are inclusive: ProcessBlock contains SplitBufferByEvents, which
+    contains the voice stages and the effects. The voice stages are summed over every voice.
+
+    toChromeTrace() turns the recorded blocks into Chrome trace JSON (chrome://tracing or
+    ui.perfetto.dev): a slice per block, and a counter track per stage.
+
+    With CYNTHIA_PROFILING off, the macros expand to nothing and there is no cost at all.
+    Every audio thread counts its own block in progress, and the totals and records are shared,
+    so several instances profiled at once all add up into the same figures and trace.
+*/
+
+#pragma once
+
+#include <array>
+#include <optional>
+#include <juce_core/juce_core.h>
+
+#ifndef CYNTHIA_PROFILING
+ #define CYNTHIA_PROFILING 0
+#endif
+
+#if CYNTHIA_PROFILING && JUCE_MSVC
+ #include <intrin.h>
+#endif
+
+namespace Profiler
+{
+    enum class Stage
+    {
+        ProcessBlock,
+        SplitBufferByEvents,
+        VoiceLFO,
+        VoiceOscillator2,
+        VoiceOscillator,
+        VoiceNoise,
+        VoiceEnvelope,
+        VoiceFilter,
+        VoiceOutput,
+        Effects,
+        NumStages
+    };
+
+    constexpr int numStages = static_cast<int>(Stage::NumStages);
+
+    const char* getStageName(Stage stage);
+
+    // true when the profiling scopes were compiled in
+    constexpr bool isEnabled() { return CYNTHIA_PROFILING != 0; }
+
+    struct Totals
+    {
+        std::array<juce::uint64, numStages> cycles {};
+        std::array<juce::uint64, numStages> calls {};
+        juce::uint64 numBlocks = 0;
+        juce::uint64 numDroppedBlocks = 0; // blocks the record queue had no room for
+    };
+
+    // cycles and calls per stage since the last reset(). Any thread
+    Totals getTotals();
+
+    // the recorded blocks as Chrome trace event JSON. Takes the records out of the queue, so
+    // each block is exported once. Allocates, so never on the audio thread
+    juce::String toChromeTrace();
+    bool writeChromeTrace(const juce::File &file);
+
+    // forget everything recorded so far. Only while nothing is being profiled
+    void reset();
+
+#if CYNTHIA_PROFILING
+    // the cheapest clock there is. Its rate depends on the CPU, so compare cycles with each other
+    inline juce::uint64 readCycleCounter() noexcept
+    {
+       #if JUCE_INTEL && (JUCE_GCC || JUCE_CLANG)
+        return __builtin_ia32_rdtsc();
+       #elif JUCE_INTEL && JUCE_MSVC
+        return __rdtsc();
+       #elif JUCE_ARM && JUCE_64BIT && (JUCE_GCC || JUCE_CLANG)
+        juce::uint64 value;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+        return value;
+       #else
+        return static_cast<juce::uint64>(juce::Time::getHighResolutionTicks());
+       #endif
+    }
+
+    // audio thread. Adds the cycles spent in a scope to its stage
+    void addCycles(Stage stage, juce::uint64 cycles) noexcept;
+
+    // audio thread. Ends a block: its stage totals are published and the next block starts from 0
+    void finishBlock(juce::int64 startTicks, juce::int64 endTicks, int numSamples) noexcept;
+
+    class ScopedStage
+    {
+    public:
+        explicit ScopedStage(Stage stage) noexcept : stage(stage), start(readCycleCounter()) {}
+        ~ScopedStage() { addCycles(stage, readCycleCounter() - start); }
+
+    private:
+        Stage stage;
+        juce::uint64 start;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedStage)
+    };
+
+    class ScopedBlock
+    {
+    public:
+        explicit ScopedBlock(int numSamples) noexcept
+            : numSamples(numSamples), startTicks(juce::Time::getHighResolutionTicks()) {}
+
+        ~ScopedBlock()
+        {
+            // the block's own stage has to be in the totals before they're published
+            stage.reset();
+            finishBlock(startTicks, juce::Time::getHighResolutionTicks(), numSamples);
+        }
+
+    private:
+        int numSamples;
+        juce::int64 startTicks;
+        std::optional<ScopedStage> stage { std::in_place, Stage::ProcessBlock };
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedBlock)
+    };
+#endif
+}
+
+#if CYNTHIA_PROFILING
+ #define CYNTHIA_PROFILE_SCOPE(stageName) \
+    Profiler::ScopedStage JUCE_JOIN_MACRO(profilerScope, __LINE__) (Profiler::Stage::stageName)
+ #define CYNTHIA_PROFILE_BLOCK(numSamples) \
+    Profiler::ScopedBlock JUCE_JOIN_MACRO(profilerBlock, __LINE__) (numSamples)
+#else
+ #define CYNTHIA_PROFILE_SCOPE(stageName)
+ #define CYNTHIA_PROFILE_BLOCK(numSamples)
+#endif
@@ -0,0 +1,100 @@
+#include "Cynthia_Utilities/ProgramBank.h"
+#include "Cynthia_Utilities/Utils.h"
+
+ProgramBank::ProgramBank(const juce::Array<juce::AudioProcessorParameter*>& parametersToUse)
+    : parameters(parametersToUse)
+{
+    // wave types: 0 = Sine, 1 = Sawtooth, 2 = Triangle, 3 = Square
+    // filter types: 0 = LowPass, 1 = HighPass, 2 = BandPass
+
+    addProgram("Init", {});
+
+    addProgram("Soft Pad", {
+        { ParameterID::wavetypeAOsc, 2.0f },
+        { ParameterID::wavetypeBOsc, 1.0f },
+        { ParameterID::morphValueOsc, 0.35f },
+        { ParameterID::detuneCentsOsc, 12.0f },
+        { ParameterID::modDepthLFO, 0.15f },
+        { ParameterID::modFreqLFO, 3.0f },
+        { ParameterID::envAttack, 1.2f },
+        { ParameterID::envDecay, 0.8f },
+        { ParameterID::envSustain, 0.7f },
+        { ParameterID::envRelease, 2.5f },
+        { ParameterID::filterCutoff, 2500.0f },
+        { ParameterID::filterResonance, 0.4f } });
+
+    addProgram("Pluck", {
+        { ParameterID::wavetypeAOsc, 1.0f },
+        { ParameterID::wavetypeBOsc, 3.0f },
+        { ParameterID::morphValueOsc, 0.2f },
+        { ParameterID::envAttack, 0.002f },
+        { ParameterID::envDecay, 0.25f },
+        { ParameterID::envSustain, 0.0f },
+        { ParameterID::envRelease, 0.3f },
+        { ParameterID::filterCutoff, 3000.0f },
+        { ParameterID::filterResonance, 0.6f } });
+
+    addProgram("Detuned Lead", {
+        { ParameterID::wavetypeAOsc, 1.0f },
+        { ParameterID::wavetypeBOsc, 1.0f },
+        { ParameterID::morphValueOsc, 0.5f },
+        { ParameterID::detuneCentsOsc, 25.0f },
+        { ParameterID::polyMode, 0.0f },
+        { ParameterID::envAttack, 0.01f },
+        { ParameterID::envDecay, 0.2f },
+        { ParameterID::envSustain, 0.8f },
+        { ParameterID::envRelease, 0.2f },
+        { ParameterID::filterCutoff, 6000.0f } });
+
+    addProgram("Tremolo Keys", {
+        { ParameterID::wavetypeAOsc, 0.0f },
+        { ParameterID::wavetypeBOsc, 2.0f },
+        { ParameterID::morphValueOsc, 0.3f },
+        { ParameterID::modDepthLFO, 0.5f },
+        { ParameterID::modFreqLFO, 6.0f },
+        { ParameterID::envAttack, 0.005f },
+        { ParameterID::envDecay, 1.0f },
+        { ParameterID::envSustain, 0.4f },
+        { ParameterID::envRelease, 0.6f } });
+
+    addProgram("Ring Bell", {
+        { ParameterID::wavetypeAOsc, 0.0f },
+        { ParameterID::wavetypeBOsc, 3.0f },
+        { ParameterID::morphValueOsc, 0.15f },
+        { ParameterID::modDepthLFO, 1.0f },
+        { ParameterID::modFreqLFO, 220.0f },
+        { ParameterID::envAttack, 0.001f },
+        { ParameterID::envDecay, 1.5f },
+        { ParameterID::envSustain, 0.0f },
+        { ParameterID::envRelease, 1.5f },
+        { ParameterID::filterType, 1.0f },
+        { ParameterID::filterCutoff, 400.0f } });
+}
+
+int ProgramBank::getNumPrograms() const
+{
+    return static_cast<int>(programs.size());
+}
+
+const ProgramBank::Program& ProgramBank::getProgram(int index) const
+{
+    return programs[static_cast<size_t>(juce::jlimit(0, getNumPrograms() - 1, index))];
+}
+
+void ProgramBank::addProgram(const juce::String& name,
+                             std::initializer_list<std::pair<juce::ParameterID, float>> settings)
+{
+    Program program { name, ParameterSnapshot::defaults(parameters) };
+
+    for (const auto& [paramID, plainValue] : settings)
+    {
+        int index = ParameterSnapshot::findIndex(parameters, paramID.getParamID());
+        auto* parameter = dynamic_cast<juce::RangedAudioParameter*>(parameters[index]);
+        jassert(parameter != nullptr); // a program refers to a parameter that doesn't exist
+
+        if (parameter != nullptr)
+            program.snapshot.values[index] = parameter->convertTo0to1(plainValue);
+    }
+
+    programs.push_back(program);
+}
@@ -0,0 +1,38 @@
+/*
+    ProgramBank.h
+
+    The factory programs reported to the host through getNumPrograms()/setCurrentProgram().
+
+    Every program is stored as a complete ParameterSnapshot, built once on the message thread,
+    so switching programs is just handing a snapshot to the audio thread.
+*/
+
+#pragma once
+
+#include <vector>
+#include "Cynthia_Utilities/ParameterSnapshot.h"
+
+class ProgramBank
+{
+public:
+
+    struct Program
+    {
+        juce::String name;
+        ParameterSnapshot snapshot;
+    };
+
+    explicit ProgramBank(const juce::Array<juce::AudioProcessorParameter*>& parameters);
+
+    int getNumPrograms() const;
+    const Program& getProgram(int index) const;
+
+private:
+
+    // a program is the default patch with some parameters changed (given as plain values)
+    void addProgram(const juce::String& name,
+                    std::initializer_list<std::pair<juce::ParameterID, float>> settings);
+
+    const juce::Array<juce::AudioProcessorParameter*>& parameters;
+    std::vector<Program> programs;
+};
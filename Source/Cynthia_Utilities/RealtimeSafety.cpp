@@ -0,0 +1,414 @@
+/*
+    RealtimeSafety.cpp
+
+    See RealtimeSafety.h. Everything in here that runs inside a hook must itself be
+    allocation and lock free, otherwise the hooks would recurse.
+*/
+
+#include "Cynthia_Utilities/RealtimeSafety.h"
+
+#if CYNTHIA_RT_CHECKS
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <execinfo.h>
+ #define CYNTHIA_RT_HAS_BACKTRACE 1
+#else
+ #define CYNTHIA_RT_HAS_BACKTRACE 0
+#endif
+
+#if JUCE_WINDOWS
+ #include <malloc.h>
+#endif
+
+#if JUCE_LINUX
+ #include <dlfcn.h>
+ #include <pthread.h>
+
+// glibc's own allocator entry points, so the malloc hooks can forward to them
+extern "C" void* __libc_malloc(size_t);
+extern "C" void* __libc_calloc(size_t, size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+extern "C" void __libc_free(void*);
+extern "C" void* __libc_memalign(size_t, size_t);
+#endif
+
+// the TLS variables are read from inside malloc, so they must never need a lazy
+// (allocating) TLS lookup themselves
+#if JUCE_GCC || JUCE_CLANG
+ #define CYNTHIA_RT_TLS thread_local __attribute__((tls_model("initial-exec")))
+#else
+ #define CYNTHIA_RT_TLS thread_local
+#endif
+
+namespace
+{
+    constexpr int maxRecordedViolations = 32;
+    constexpr int maxStackFrames = 24;
+
+    struct Violation
+    {
+        RealtimeSafety::ViolationType type;
+        int numFrames;
+        void* frames[maxStackFrames];
+    };
+
+    CYNTHIA_RT_TLS int audioThreadDepth = 0;
+    CYNTHIA_RT_TLS bool isRecording = false;
+
+    std::atomic<int> numViolations { 0 };
+    std::array<Violation, maxRecordedViolations> violations;
+
+    const char* getTypeName(RealtimeSafety::ViolationType type)
+    {
+        switch (type)
+        {
+            case RealtimeSafety::ViolationType::Allocation:   return "allocation";
+            case RealtimeSafety::ViolationType::Deallocation: return "deallocation";
+            case RealtimeSafety::ViolationType::MutexLock:    return "mutex lock";
+        }
+
+        return "unknown";
+    }
+
+    void* allocate(size_t size)
+    {
+       #if JUCE_LINUX
+        return __libc_malloc(size);
+       #else
+        return std::malloc(size);
+       #endif
+    }
+
+    void deallocate(void* pointer)
+    {
+       #if JUCE_LINUX
+        __libc_free(pointer);
+       #else
+        std::free(pointer);
+       #endif
+    }
+
+    // memory from here must go back through deallocateAligned()
+    void* allocateAligned(size_t size, size_t alignment)
+    {
+       #if JUCE_LINUX
+        return __libc_memalign(alignment, size);
+       #elif JUCE_WINDOWS
+        return _aligned_malloc(size, alignment);
+       #else
+        void* pointer = nullptr;
+        return posix_memalign(&pointer, juce::jmax(alignment, sizeof(void*)), size) == 0 ? pointer : nullptr;
+       #endif
+    }
+
+    void deallocateAligned(void* pointer)
+    {
+       #if JUCE_WINDOWS
+        _aligned_free(pointer);
+       #else
+        deallocate(pointer);
+       #endif
+    }
+
+   #if CYNTHIA_RT_HAS_BACKTRACE
+    // backtrace() loads the unwinder (and allocates) the first time it runs,
+    // so get that out of the way before any audio thread can hit it
+    struct BacktraceWarmUp
+    {
+        BacktraceWarmUp()
+        {
+            void* frames[1];
+            backtrace(frames, 1);
+        }
+    };
+
+    const BacktraceWarmUp backtraceWarmUp;
+   #endif
+}
+
+RealtimeSafety::ScopedAudioThread::ScopedAudioThread()
+{
+    ++audioThreadDepth;
+}
+
+RealtimeSafety::ScopedAudioThread::~ScopedAudioThread()
+{
+    --audioThreadDepth;
+}
+
+void RealtimeSafety::reportViolation(ViolationType type) noexcept
+{
+    if (audioThreadDepth == 0 || isRecording)
+        return;
+
+    isRecording = true;
+
+    int index = numViolations.fetch_add(1);
+
+    if (index < maxRecordedViolations)
+    {
+        auto& violation = violations[index];
+        violation.type = type;
+
+       #if CYNTHIA_RT_HAS_BACKTRACE
+        violation.numFrames = backtrace(violation.frames, maxStackFrames);
+       #else
+        violation.numFrames = 0;
+       #endif
+    }
+
+    isRecording = false;
+}
+
+int RealtimeSafety::getNumViolations() noexcept
+{
+    return numViolations.load();
+}
+
+void RealtimeSafety::resetViolations() noexcept
+{
+    numViolations.store(0);
+}
+
+juce::String RealtimeSafety::getReport()
+{
+    int total = getNumViolations();
+    juce::String report;
+    report << total << " real-time safety violation(s) on the audio thread\n";
+
+    for (int index = 0; index < juce::jmin(total, maxRecordedViolations); ++index)
+    {
+        const auto& violation = violations[index];
+        report << "\n#" << index << ": " << getTypeName(violation.type) << "\n";
+
+       #if CYNTHIA_RT_HAS_BACKTRACE
+        if (char** symbols = backtrace_symbols(violation.frames, violation.numFrames))
+        {
+            for (int frame = 0; frame < violation.numFrames; ++frame)
+                report << "    " << symbols[frame] << "\n";
+
+            std::free(symbols);
+        }
+       #else
+        report << "    (no stack trace available on this platform)\n";
+       #endif
+    }
+
+    if (total > maxRecordedViolations)
+        report << "\n(only the first " << maxRecordedViolations << " are listed)\n";
+
+    return report;
+}
+
+//==============================================================================
+// operator new/delete hooks. These work on every platform.
+
+void* operator new(size_t size)
+{
+    RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::Allocation);
+
+    if (void* pointer = allocate(size == 0 ? 1 : size))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    if (pointer == nullptr)
+        return;
+
+    RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::Deallocation);
+    deallocate(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::Allocation);
+    return allocate(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    operator delete(pointer);
+}
+
+// over-aligned types (alignas bigger than the default new alignment) come through these
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::Allocation);
+    return allocateAligned(size == 0 ? 1 : size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, alignment, tag);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    if (void* pointer = operator new(size, alignment, std::nothrow))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+    if (pointer == nullptr)
+        return;
+
+    RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::Deallocation);
+    deallocateAligned(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t alignment) noexcept
+{
+    operator delete(pointer, alignment);
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t alignment) noexcept
+{
+    operator delete(pointer, alignment);
+}
+
+void operator delete[](void* pointer, size_t, std::align_val_t alignment) noexcept
+{
+    operator delete(pointer, alignment);
+}
+
+void operator delete(void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    operator delete(pointer, alignment);
+}
+
+void operator delete[](void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    operator delete(pointer, alignment);
+}
+
+//==============================================================================
+// malloc and mutex hooks. Symbol interposition only works this simply with glibc.
+
+#if JUCE_LINUX
+extern "C"
+{
+    void* malloc(size_t size) noexcept
+    {
+        RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::Allocation);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size) noexcept
+    {
+        RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::Allocation);
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, size_t size) noexcept
+    {
+        RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::Allocation);
+        return __libc_realloc(pointer, size);
+    }
+
+    int posix_memalign(void** result, size_t alignment, size_t size) noexcept
+    {
+        RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::Allocation);
+
+        if (alignment % sizeof(void*) != 0 || ! juce::isPowerOfTwo(alignment))
+            return EINVAL;
+
+        void* pointer = __libc_memalign(alignment, size);
+
+        if (pointer == nullptr)
+            return ENOMEM;
+
+        *result = pointer;
+        return 0;
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size) noexcept
+    {
+        RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::Allocation);
+        return __libc_memalign(alignment, size);
+    }
+
+    void* memalign(size_t alignment, size_t size) noexcept
+    {
+        RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::Allocation);
+        return __libc_memalign(alignment, size);
+    }
+
+    void free(void* pointer) noexcept
+    {
+        if (pointer != nullptr)
+            RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::Deallocation);
+
+        __libc_free(pointer);
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+    {
+        // constant initialised, so there is no static initialisation guard (which could itself lock)
+        using LockFunction = int (*)(pthread_mutex_t*);
+        static LockFunction realLock = nullptr;
+
+        if (realLock == nullptr)
+            realLock = reinterpret_cast<LockFunction>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+
+        RealtimeSafety::reportViolation(RealtimeSafety::ViolationType::MutexLock);
+        return realLock(mutex);
+    }
+}
+#endif
+
+#else
+
+void RealtimeSafety::reportViolation(ViolationType) noexcept {}
+int RealtimeSafety::getNumViolations() noexcept { return 0; }
+void RealtimeSafety::resetViolations() noexcept {}
+juce::String RealtimeSafety::getReport() { return "real-time safety checks are disabled (CYNTHIA_RT_CHECKS=OFF)"; }
+
+#endif
@@ -0,0 +1,62 @@
+/*
+    RealtimeSafety.h
+
+    Opt-in instrumentation that catches real-time safety violations on the audio thread.
+
+    When the project is configured with -DCYNTHIA_RT_CHECKS=ON, memory allocation
+    (every replaceable operator new/delete, including the aligned and nothrow ones, and
+    malloc/free/calloc/realloc and the aligned C allocators on Linux) and blocking mutex
+    acquisition (pthread_mutex_lock on Linux) are hooked. Any of these happening while a
+    ScopedAudioThread is alive on the calling thread is recorded as a violation,
+    together with a stack trace where the platform provides one.
+
+    The hooks replace global symbols, so this is meant for test and debug builds only.
+    With CYNTHIA_RT_CHECKS off, ScopedAudioThread is an empty object and nothing is hooked.
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#ifndef CYNTHIA_RT_CHECKS
+ #define CYNTHIA_RT_CHECKS 0
+#endif
+
+namespace RealtimeSafety
+{
+    enum class ViolationType
+    {
+        Allocation,
+        Deallocation,
+        MutexLock
+    };
+
+#if CYNTHIA_RT_CHECKS
+    // marks the current thread as the audio thread for the lifetime of this object
+    struct ScopedAudioThread
+    {
+        ScopedAudioThread();
+        ~ScopedAudioThread();
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedAudioThread)
+    };
+#else
+    struct ScopedAudioThread
+    {
+        ScopedAudioThread() {}
+    };
+#endif
+
+    // true when the checks were compiled in
+    constexpr bool isEnabled() { return CYNTHIA_RT_CHECKS != 0; }
+
+    // called by the hooks. Records a violation if the current thread is inside a ScopedAudioThread
+    void reportViolation(ViolationType type) noexcept;
+
+    int getNumViolations() noexcept;
+    void resetViolations() noexcept;
+
+    // a readable list of the recorded violations with their stack traces.
+    // this allocates, so never call it from the audio thread
+    juce::String getReport();
+}
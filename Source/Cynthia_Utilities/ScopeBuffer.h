@@ -0,0 +1,79 @@
+/*
+    ScopeBuffer.h
+
+    Carries the synth's output from the audio thread to the scope/spectrum view.
+
+    Unlike LockFreeQueue, nothing here is ever consumed: the audio thread keeps overwriting a
+    ring of the most recent samples and publishes how far it has written, and the UI copies
+    whatever window it wants behind that point. The writer never waits and never drops
+    anything, and a slow or absent reader costs it nothing.
+
+    A reader that falls a whole ring behind could see a torn window. The ring holds far more
+    than a display frame needs, so at any sensible frame rate that can't happen, and for a
+    view it wouldn't matter anyway.
+
+    Pushing is skipped entirely while no view is attached, so a closed editor costs nothing.
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+class ScopeBuffer
+{
+public:
+    static constexpr int capacity = 1 << 15; // samples, a power of two so positions wrap with a mask
+
+    // audio thread: append a mono mix of the first two channels
+    void push(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+    {
+        if (numReaders.load(std::memory_order_relaxed) == 0)
+            return;
+
+        const float* left = buffer.getReadPointer(0, startSample);
+        const float* right = buffer.getNumChannels() > 1 ? buffer.getReadPointer(1, startSample) : left;
+
+        uint32_t position = writePosition.load(std::memory_order_relaxed);
+
+        for (int i = 0; i < numSamples; ++i)
+            samples[(position + static_cast<uint32_t>(i)) & mask] = 0.5f * (left[i] + right[i]);
+
+        writePosition.store(position + static_cast<uint32_t>(numSamples), std::memory_order_release);
+    }
+
+    // UI thread: copy the newest numSamples samples (oldest first). numSamples must not exceed capacity
+    void copyLatest(float* destination, int numSamples) const noexcept
+    {
+        jassert(numSamples <= capacity);
+
+        uint32_t end = writePosition.load(std::memory_order_acquire);
+        uint32_t start = end - static_cast<uint32_t>(numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+            destination[i] = samples[(start + static_cast<uint32_t>(i)) & mask];
+    }
+
+    // total samples written so far (wraps). Lets a reader tell whether anything new arrived
+    uint32_t getWritePosition() const noexcept
+    {
+        return writePosition.load(std::memory_order_acquire);
+    }
+
+    // set from prepareToPlay(), so a view can put frequencies on its spectrum
+    void setSampleRate(double newSampleRate) noexcept { sampleRate.store(newSampleRate); }
+    double getSampleRate() const noexcept { return sampleRate.load(); }
+
+    // a view calls these while it's showing, so the audio thread only pushes when someone is looking
+    void addReader() noexcept    { numReaders.fetch_add(1); }
+    void removeReader() noexcept { numReaders.fetch_sub(1); }
+
+private:
+    static constexpr uint32_t mask = capacity - 1;
+
+    std::array<float, capacity> samples {};
+    std::atomic<uint32_t> writePosition { 0 };
+    std::atomic<int> numReaders { 0 };
+    std::atomic<double> sampleRate { 44100.0 };
+};
@@ -17,29 +17,56 @@
     Here we create a new namespace which contains juce::ParameterID objects for each parameter definition.
     To get the identifier of a parameter, we can just write "ParameterID::paramID".
     The actual string value is just "paramID".
+
+    The second argument is the version hint: the plugin version the parameter first appeared in.
+    Hosts (AU in particular) rely on it to map existing sessions, so a parameter added after a
+    release gets a higher number than the ones already there. Never change it once released.
 */
 namespace ParameterID
 {
-    #define PARAMETER_ID(str) const juce::ParameterID str(#str, 1);
-        PARAMETER_ID(wavetypeAOsc)
-        PARAMETER_ID(wavetypeBOsc)
-        PARAMETER_ID(morphValueOsc)
-        PARAMETER_ID(detuneCentsOsc)
-        PARAMETER_ID(wavetypeALFO)
-        PARAMETER_ID(wavetypeBLFO)
-        PARAMETER_ID(morphValueLFO)
-        PARAMETER_ID(detuneCentsLFO)
-        PARAMETER_ID(modDepthLFO)
-        PARAMETER_ID(modFreqLFO)
-        PARAMETER_ID(polyMode)
-        PARAMETER_ID(envAttack)
-        PARAMETER_ID(envDecay)
-        PARAMETER_ID(envSustain)
-        PARAMETER_ID(envRelease)
-        PARAMETER_ID(filterType)
-        PARAMETER_ID(filterCutoff)
-        PARAMETER_ID(filterResonance)
-        PARAMETER_ID(outputGain)
+    #define PARAMETER_ID(str, version) const juce::ParameterID str(#str, version);
+        PARAMETER_ID(wavetypeAOsc, 1)
+        PARAMETER_ID(wavetypeBOsc, 1)
+        PARAMETER_ID(morphValueOsc, 1)
+        PARAMETER_ID(detuneCentsOsc, 1)
+        PARAMETER_ID(tableSourceOsc, 2)
+        PARAMETER_ID(interpolationOsc, 2)
+        PARAMETER_ID(noiseLevel, 2)
+        PARAMETER_ID(noiseType, 2)
+        PARAMETER_ID(levelOsc2, 2)
+        PARAMETER_ID(wavetypeOsc2, 2)
+        PARAMETER_ID(semitonesOsc2, 2)
+        PARAMETER_ID(fmAmountOsc2, 2)
+        PARAMETER_ID(ringModOsc2, 2)
+        PARAMETER_ID(syncOsc2, 2)
+        PARAMETER_ID(wavetypeALFO, 1)
+        PARAMETER_ID(wavetypeBLFO, 1)
+        PARAMETER_ID(morphValueLFO, 1)
+        PARAMETER_ID(detuneCentsLFO, 1)
+        PARAMETER_ID(modDepthLFO, 1)
+        PARAMETER_ID(modFreqLFO, 1)
+        PARAMETER_ID(positionModLFO, 2)
+        PARAMETER_ID(syncRateLFO, 2)
+        PARAMETER_ID(polyMode, 1)
+        PARAMETER_ID(voiceCount, 2)
+        PARAMETER_ID(deterministic, 2)
+        PARAMETER_ID(envAttack, 1)
+        PARAMETER_ID(envDecay, 1)
+        PARAMETER_ID(envSustain, 1)
+        PARAMETER_ID(envRelease, 1)
+        PARAMETER_ID(filterType, 1)
+        PARAMETER_ID(filterCutoff, 1)
+        PARAMETER_ID(filterResonance, 1)
+        PARAMETER_ID(chorusMix, 2)
+        PARAMETER_ID(chorusRate, 2)
+        PARAMETER_ID(chorusDepth, 2)
+        PARAMETER_ID(delayMix, 2)
+        PARAMETER_ID(delayTime, 2)
+        PARAMETER_ID(delayFeedback, 2)
+        PARAMETER_ID(reverbMix, 2)
+        PARAMETER_ID(reverbSize, 2)
+        PARAMETER_ID(reverbDamping, 2)
+        PARAMETER_ID(outputGain, 1)
     #undef PARAMETER_ID
 }
 
@@ -86,6 +113,83 @@ inline juce::AudioProcessorValueTreeState::ParameterLayout configureLayout()
         0.0f
     ));
 
+    // "User" plays the wavetable loaded from a file instead of Wavetype A/B
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        ParameterID::tableSourceOsc,
+        "Table",
+        juce::StringArray{"Factory", "User"},
+        0));
+
+    // how the oscillator reads between wavetable samples. Better quality costs more CPU
+    // (see WavetableInterpolation.h, and the interpolation benchmark for numbers)
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        ParameterID::interpolationOsc,
+        "Interpolation",
+        juce::StringArray{"Linear", "Hermite", "Sinc"},
+        0));
+
+    // noise mixed in with the oscillator, before the filter
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        ParameterID::noiseLevel,
+        "Noise",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.0f // default: no noise
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        ParameterID::noiseType,
+        "Noise Type",
+        juce::StringArray{"White", "Pink", "Filtered"},
+        0));
+
+    /*
+        Oscillator 2 Params
+
+        Oscillator 2 is heard at its own level, and can also modulate oscillator 1
+        (phase modulation, ring modulation, hard sync) at any level, including 0
+    */
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        ParameterID::levelOsc2,
+        "Osc 2 Level",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.0f // default: off
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        ParameterID::wavetypeOsc2,
+        "Osc 2 Wavetype",
+        juce::StringArray{"Sine", "Sawtooth", "Triangle", "Square"},
+        0));
+
+    // tuning relative to the note (and so to oscillator 1)
+    layout.add(std::make_unique<juce::AudioParameterInt>(
+        ParameterID::semitonesOsc2,
+        "Osc 2 Semitones",
+        -24,
+        24,
+        0));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        ParameterID::fmAmountOsc2,
+        "Osc 2 FM",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.0f
+    ));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        ParameterID::ringModOsc2,
+        "Osc 2 Ring Mod",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.0f
+    ));
+
+    // restart oscillator 1's cycle every time oscillator 2 starts a new one
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        ParameterID::syncOsc2,
+        "Osc 2 Sync",
+        juce::StringArray{"Off", "On"},
+        0));
+
     /*
         LFO Params
     */
@@ -129,6 +233,22 @@ inline juce::AudioProcessorValueTreeState::ParameterLayout configureLayout()
         0.0f
     ));
 
+    // how far the LFO sweeps the oscillator's wavetable position (or its morph between A and B)
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        ParameterID::positionModLFO,
+        "Position Mod",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.0f
+    ));
+
+    // Free runs the LFO at Mod Freq. The note values lock it to the host's tempo and song
+    // position, in the order of TempoSync::noteValueBeats (T is triplet, D dotted)
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        ParameterID::syncRateLFO,
+        "LFO Sync",
+        juce::StringArray{"Free", "4 Bars", "2 Bars", "1/1", "1/2", "1/4", "1/8", "1/16", "1/8 T", "1/16 T", "1/8 D"},
+        0));
+
     /*
         Polyphony Param
     */
@@ -139,6 +259,23 @@ inline juce::AudioProcessorValueTreeState::ParameterLayout configureLayout()
         juce::StringArray{"Monophonic", "Polyphonic"}, 
         1));                                           
 
+    // number of voices available in polyphonic mode.
+    // the synth's voice pool is sized to this value, so fewer voices also means less memory.
+    layout.add(std::make_unique<juce::AudioParameterInt>(
+        ParameterID::voiceCount,
+        "Voices",
+        1,
+        128,
+        16));
+
+    // every note starts from the same oscillator phases and noise, so renders repeat exactly
+    // and a bounce matches realtime playback (see Synth::setDeterministic())
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        ParameterID::deterministic,
+        "Deterministic",
+        juce::StringArray{"Off", "On"},
+        0));
+
     /*
 
         ADSR Params
@@ -204,6 +341,68 @@ inline juce::AudioProcessorValueTreeState::ParameterLayout configureLayout()
         0.5f,
         juce::AudioParameterFloatAttributes().withLabel("Q")));
 
+    /*
+        Effects Params
+
+        The voice mix goes through chorus, then delay, then reverb.
+        Each effect is switched off (and costs nothing) while its mix is 0
+    */
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        ParameterID::chorusMix,
+        "Chorus Mix",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.0f));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        ParameterID::chorusRate,
+        "Chorus Rate",
+        juce::NormalisableRange<float>(0.05f, 5.0f, 0.01f, 0.5f),
+        0.5f,
+        juce::AudioParameterFloatAttributes().withLabel("Hz")));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        ParameterID::chorusDepth,
+        "Chorus Depth",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.5f));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        ParameterID::delayMix,
+        "Delay Mix",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.0f));
+
+    // note values at the host's tempo (see DelayEffect::noteValueBeats)
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        ParameterID::delayTime,
+        "Delay Time",
+        juce::StringArray{"1/16", "1/8", "1/8 Dotted", "1/4", "1/4 Dotted", "1/2", "1/1"},
+        1));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        ParameterID::delayFeedback,
+        "Delay Feedback",
+        juce::NormalisableRange<float>(0.0f, 0.95f, 0.01f),
+        0.4f));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        ParameterID::reverbMix,
+        "Reverb Mix",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.0f));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        ParameterID::reverbSize,
+        "Reverb Size",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.5f));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        ParameterID::reverbDamping,
+        "Reverb Damping",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.5f));
+
     /*
         Final Output Gain Param
     */
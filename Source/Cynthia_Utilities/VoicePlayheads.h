@@ -0,0 +1,93 @@
+/*
+    VoicePlayheads.h
+
+    Where each voice is in its envelope and LFO, for the envelope and LFO displays.
+
+    Once per block the audio thread writes a handful of numbers per voice into atomics; the
+    displays read them whenever they repaint. Nothing is queued and nothing waits. A reader
+    can see one voice's fields from two different blocks, which a dot on a curve can't show.
+
+    Like ScopeBuffer, nothing is written while no display is attached.
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <juce_core/juce_core.h>
+
+class VoicePlayheads
+{
+public:
+    static constexpr int maxVoices = 128;
+
+    enum class State
+    {
+        Idle,
+        Held,       // key down: attack, decay or sustain
+        Released
+    };
+
+    struct Playhead
+    {
+        State state = State::Idle;
+        float envelopeLevel = 0.0f;
+        float envelopeSeconds = 0.0f; // since the note on, or since the note off once released
+        float lfoPhase = 0.0f;        // 0 to 1
+    };
+
+    bool hasReaders() const noexcept
+    {
+        return numReaders.load(std::memory_order_relaxed) > 0;
+    }
+
+    // audio thread
+    void publish(int voice, const Playhead &playhead) noexcept
+    {
+        auto &slot = slots[static_cast<size_t>(voice)];
+        slot.envelopeLevel.store(playhead.envelopeLevel, std::memory_order_relaxed);
+        slot.envelopeSeconds.store(playhead.envelopeSeconds, std::memory_order_relaxed);
+        slot.lfoPhase.store(playhead.lfoPhase, std::memory_order_relaxed);
+        slot.state.store(static_cast<int>(playhead.state), std::memory_order_release);
+    }
+
+    // audio thread: voices from here on don't exist (the pool is smaller)
+    void setNumVoices(int newNumVoices) noexcept
+    {
+        numVoices.store(juce::jlimit(0, maxVoices, newNumVoices), std::memory_order_release);
+    }
+
+    int getNumVoices() const noexcept
+    {
+        return numVoices.load(std::memory_order_acquire);
+    }
+
+    Playhead get(int voice) const noexcept
+    {
+        const auto &slot = slots[static_cast<size_t>(voice)];
+
+        Playhead playhead;
+        playhead.state = static_cast<State>(slot.state.load(std::memory_order_acquire));
+        playhead.envelopeLevel = slot.envelopeLevel.load(std::memory_order_relaxed);
+        playhead.envelopeSeconds = slot.envelopeSeconds.load(std::memory_order_relaxed);
+        playhead.lfoPhase = slot.lfoPhase.load(std::memory_order_relaxed);
+        return playhead;
+    }
+
+    // a display calls these while it's showing
+    void addReader() noexcept    { numReaders.fetch_add(1); }
+    void removeReader() noexcept { numReaders.fetch_sub(1); }
+
+private:
+    struct Slot
+    {
+        std::atomic<int> state { 0 };
+        std::atomic<float> envelopeLevel { 0.0f };
+        std::atomic<float> envelopeSeconds { 0.0f };
+        std::atomic<float> lfoPhase { 0.0f };
+    };
+
+    std::array<Slot, maxVoices> slots;
+    std::atomic<int> numVoices { 0 };
+    std::atomic<int> numReaders { 0 };
+};
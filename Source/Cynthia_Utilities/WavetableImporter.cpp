@@ -0,0 +1,102 @@
+#include "Cynthia_Utilities/WavetableImporter.h"
+#include "Cynthia_DSP/WavetableCache.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+
+namespace
+{
+    // resample one cycle to Wavetable::tableSize with periodic cubic (Catmull-Rom) interpolation.
+    // any aliasing this introduces is removed again when the mipmaps are built
+    void resampleCycle(const float* cycle, int cycleLength, float* destination)
+    {
+        auto at = [&](int index) { return cycle[(index % cycleLength + cycleLength) % cycleLength]; };
+
+        double step = static_cast<double>(cycleLength) / Wavetable::tableSize;
+
+        for (int sample = 0; sample < Wavetable::tableSize; ++sample)
+        {
+            double position = sample * step;
+            int index = static_cast<int>(position);
+            auto t = static_cast<float>(position - index);
+
+            float y0 = at(index - 1), y1 = at(index), y2 = at(index + 1), y3 = at(index + 2);
+
+            destination[sample] = y1 + 0.5f * t * ((y2 - y0)
+                                + t * ((2.0f * y0 - 5.0f * y1 + 4.0f * y2 - y3)
+                                + t * (3.0f * (y1 - y2) + y3 - y0)));
+        }
+    }
+}
+
+Wavetable::Ptr WavetableImporter::importFile(const juce::File& file, juce::String& errorMessage)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+
+    if (reader == nullptr)
+    {
+        errorMessage = "Couldn't read " + file.getFileName();
+        return nullptr;
+    }
+
+    auto maxLength = static_cast<juce::int64>(Wavetable::maxFrames) * Wavetable::tableSize;
+
+    if (reader->lengthInSamples <= 0 || reader->lengthInSamples > maxLength)
+    {
+        errorMessage = file.getFileName() + " is too long to be a wavetable";
+        return nullptr;
+    }
+
+    auto numSamples = static_cast<int>(reader->lengthInSamples);
+    auto numChannels = static_cast<int>(reader->numChannels);
+
+    juce::AudioBuffer<float> buffer(numChannels, numSamples);
+    reader->read(&buffer, 0, numSamples, 0, true, true);
+
+    // mix down to mono
+    for (int channel = 1; channel < numChannels; ++channel)
+        buffer.addFrom(0, 0, buffer, channel, 0, numSamples);
+
+    if (numChannels > 1)
+        buffer.applyGain(0, 0, numSamples, 1.0f / static_cast<float>(numChannels));
+
+    return importSamples(buffer.getReadPointer(0), numSamples, file.getFileNameWithoutExtension(), errorMessage);
+}
+
+Wavetable::Ptr WavetableImporter::importSamples(const float* samples, int numSamples, const juce::String& name, juce::String& errorMessage)
+{
+    int cycleLength = 0;
+
+    if (numSamples % Wavetable::tableSize == 0)
+        cycleLength = Wavetable::tableSize;
+    else if (numSamples <= maxSingleCycleLength)
+        cycleLength = numSamples;
+
+    if (cycleLength < 4)
+    {
+        errorMessage = name + " isn't a single cycle or a sequence of " + juce::String(Wavetable::tableSize) + " sample frames";
+        return nullptr;
+    }
+
+    int numFrames = juce::jmin(Wavetable::maxFrames, numSamples / cycleLength);
+    std::vector<float> frames(static_cast<size_t>(numFrames * Wavetable::tableSize));
+
+    for (int frame = 0; frame < numFrames; ++frame)
+        resampleCycle(samples + frame * cycleLength, cycleLength, frames.data() + frame * Wavetable::tableSize);
+
+    auto peak = juce::FloatVectorOperations::findMaximum(frames.data(), static_cast<int>(frames.size()));
+    auto trough = juce::FloatVectorOperations::findMinimum(frames.data(), static_cast<int>(frames.size()));
+    auto magnitude = juce::jmax(std::abs(peak), std::abs(trough));
+
+    if (magnitude < 1.0e-6f)
+    {
+        errorMessage = name + " is silent";
+        return nullptr;
+    }
+
+    juce::FloatVectorOperations::multiply(frames.data(), 1.0f / magnitude, static_cast<int>(frames.size()));
+
+    // importing the same file again (or reopening a session that uses it) maps the cached mipmaps
+    return WavetableCache::getOrBuild(frames.data(), numFrames, name);
+}
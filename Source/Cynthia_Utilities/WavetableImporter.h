@@ -0,0 +1,28 @@
+/*
+    WavetableImporter.h
+
+    Turns an audio file into a Wavetable.
+
+    A file whose length is a multiple of Wavetable::tableSize is read as that many frames
+    (the usual layout of multi-frame wavetable WAVs, e.g. 2048 samples per frame).
+    Anything else up to maxSingleCycleLength samples is treated as one single cycle.
+    Every frame is resampled to Wavetable::tableSize, the whole table is normalised, and
+    then band-limited into mipmaps (or mapped from the WavetableCache if it was built before).
+
+    Reading and building take a while, so call this from a background thread.
+*/
+
+#pragma once
+
+#include "Cynthia_DSP/Wavetable.h"
+
+namespace WavetableImporter
+{
+    constexpr int maxSingleCycleLength = 8192;
+
+    // returns nullptr and describes the problem in errorMessage if the file can't be used
+    Wavetable::Ptr importFile(const juce::File& file, juce::String& errorMessage);
+
+    // the same, for samples that are already in memory (mixed down to mono)
+    Wavetable::Ptr importSamples(const float* samples, int numSamples, const juce::String& name, juce::String& errorMessage);
+}
@@ -13,17 +13,41 @@
 
 //==============================================================================
 CynthiaAudioProcessorEditor::CynthiaAudioProcessorEditor (CynthiaAudioProcessor& p)
-    : AudioProcessorEditor (&p), processorRef (p), adsrUI(p.apvts), filterUI(p.apvts), oscillatorUI(p.apvts), lfoUI(p.apvts)
+    : AudioProcessorEditor (&p), processorRef (p),
+      adsrUI(p.apvts, p.getVoicePlayheads(), repaintCoalescer), filterUI(p.apvts), oscillatorUI(p.apvts), oscillator2UI(p.apvts),
+      lfoUI(p.apvts, p.getVoicePlayheads(), repaintCoalescer), effectsUI(p.apvts), scopeUI(p.getScopeBuffer(), repaintCoalescer),
+      performanceUI([&p] { return p.getPerformanceStats(); }, [&p] { p.resetPerformanceStats(); }, repaintCoalescer),
+      keyboardUI(p.getLiveMidiQueue())
 {
+    // loading a table also switches the oscillator over to it
+    oscillatorUI.onWavetableChosen = [this](const juce::File &file)
+    {
+        processorRef.loadUserWavetable(file);
+
+        if (auto *tableSource = processorRef.apvts.getParameter(ParameterID::tableSourceOsc.getParamID()))
+            tableSource->setValueNotifyingHost(1.0f);
+    };
+
+    processorRef.onWavetableLoaded = [this](const juce::File &file, const juce::String &errorMessage)
+    {
+        oscillatorUI.showWavetableResult(file, errorMessage);
+    };
+
     addAndMakeVisible(oscillatorUI);
+    addAndMakeVisible(oscillator2UI);
     addAndMakeVisible(filterUI);
     addAndMakeVisible(adsrUI);
     addAndMakeVisible(lfoUI);
-    setSize(900, 400);
+    addAndMakeVisible(effectsUI);
+    addAndMakeVisible(scopeUI);
+    addAndMakeVisible(performanceUI);
+    addAndMakeVisible(keyboardUI);
+    setSize(900, 994);
 }
 
 CynthiaAudioProcessorEditor::~CynthiaAudioProcessorEditor()
 {
+    processorRef.onWavetableLoaded = nullptr;
 }
 
 //==============================================================================
@@ -37,11 +61,28 @@ void CynthiaAudioProcessorEditor::resized()
 {
     auto editorBounds = getLocalBounds();
 
+    performanceUI.setBounds(editorBounds.removeFromBottom(24));
+    keyboardUI.setBounds(editorBounds.removeFromBottom(70));
+
+    // oscillator 2 and the effects are strips of their own. The keyboard, scope and spectrum get
+    // the bottom, and the other modules share what's left in two rows
+    int stripHeight = 130;
+    int scopeHeight = 200;
+
+    scopeUI.setBounds(editorBounds.removeFromBottom(scopeHeight));
+    effectsUI.setBounds(editorBounds.removeFromBottom(stripHeight));
+
+    int rowHeight = (editorBounds.getHeight() - stripHeight) / 2;
+
     int width = editorBounds.getWidth()/2;
-    int height = editorBounds.getHeight()/2;
 
-    oscillatorUI.setBounds(0,0, width, height);
-    filterUI.setBounds(oscillatorUI.getWidth(), 0, width, height);
-    adsrUI.setBounds(0, oscillatorUI.getHeight(), width, height);
-    lfoUI.setBounds(adsrUI.getWidth(), filterUI.getHeight(), width, height);
+    auto topRow = editorBounds.removeFromTop(rowHeight);
+    oscillatorUI.setBounds(topRow.removeFromLeft(width));
+    filterUI.setBounds(topRow);
+
+    oscillator2UI.setBounds(editorBounds.removeFromTop(stripHeight));
+
+    auto bottomRow = editorBounds;
+    adsrUI.setBounds(bottomRow.removeFromLeft(width));
+    lfoUI.setBounds(bottomRow);
 }
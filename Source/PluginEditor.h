@@ -4,7 +4,12 @@
 #include "Cynthia_UI/ADSRComponent.h"
 #include "Cynthia_UI/FilterComponent.h"
 #include "Cynthia_UI/OscillatorComponent.h"
+#include "Cynthia_UI/Oscillator2Component.h"
 #include "Cynthia_UI/LFOComponent.h"
+#include "Cynthia_UI/EffectsComponent.h"
+#include "Cynthia_UI/ScopeComponent.h"
+#include "Cynthia_UI/PerformanceComponent.h"
+#include "Cynthia_UI/KeyboardComponent.h"
 
 //==============================================================================
 class CynthiaAudioProcessorEditor final : public juce::AudioProcessorEditor
@@ -21,9 +26,18 @@ private:
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     CynthiaAudioProcessor& processorRef;
+
+    // drives the animated components below, so it must be declared before them
+    RepaintCoalescer repaintCoalescer { *this };
+
     ADSRComponent adsrUI;
     FilterComponent filterUI;
     OscillatorComponent oscillatorUI;
+    Oscillator2Component oscillator2UI;
     LFOComponent lfoUI;
+    EffectsComponent effectsUI;
+    ScopeComponent scopeUI;
+    PerformanceComponent performanceUI;
+    KeyboardComponent keyboardUI;
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CynthiaAudioProcessorEditor)
 };
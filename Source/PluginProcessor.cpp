@@ -9,6 +9,9 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "Cynthia_Utilities/RealtimeSafety.h"
+#include "Cynthia_Utilities/Profiler.h"
+#include "Cynthia_Utilities/WavetableImporter.h"
 
 //==============================================================================
 CynthiaAudioProcessor::CynthiaAudioProcessor()
@@ -25,6 +28,17 @@ CynthiaAudioProcessor::CynthiaAudioProcessor()
     castParameter(apvts, ParameterID::wavetypeBOsc, wavetypeBParamOsc);
     castParameter(apvts, ParameterID::morphValueOsc, morphValueParamOsc);
     castParameter(apvts, ParameterID::detuneCentsOsc, detuneCentsParamOsc);
+    castParameter(apvts, ParameterID::tableSourceOsc, tableSourceParamOsc);
+    castParameter(apvts, ParameterID::interpolationOsc, interpolationParamOsc);
+    castParameter(apvts, ParameterID::noiseLevel, noiseLevelParam);
+    castParameter(apvts, ParameterID::noiseType, noiseTypeParam);
+
+    castParameter(apvts, ParameterID::levelOsc2, levelParamOsc2);
+    castParameter(apvts, ParameterID::wavetypeOsc2, wavetypeParamOsc2);
+    castParameter(apvts, ParameterID::semitonesOsc2, semitonesParamOsc2);
+    castParameter(apvts, ParameterID::fmAmountOsc2, fmAmountParamOsc2);
+    castParameter(apvts, ParameterID::ringModOsc2, ringModParamOsc2);
+    castParameter(apvts, ParameterID::syncOsc2, syncParamOsc2);
 
     castParameter(apvts, ParameterID::wavetypeALFO, wavetypeAParamLFO);
     castParameter(apvts, ParameterID::wavetypeBLFO, wavetypeBParamLFO);
@@ -32,8 +46,12 @@ CynthiaAudioProcessor::CynthiaAudioProcessor()
     castParameter(apvts, ParameterID::detuneCentsLFO, detuneCentsParamLFO);
     castParameter(apvts, ParameterID::modDepthLFO, modDepthParamLFO);
     castParameter(apvts, ParameterID::modFreqLFO, modFreqParamLFO);
+    castParameter(apvts, ParameterID::positionModLFO, positionModParamLFO);
+    castParameter(apvts, ParameterID::syncRateLFO, syncRateParamLFO);
 
     castParameter(apvts, ParameterID::polyMode, polyModeParam);
+    castParameter(apvts, ParameterID::voiceCount, voiceCountParam);
+    castParameter(apvts, ParameterID::deterministic, deterministicParam);
 
     castParameter(apvts, ParameterID::envAttack, envAttackParam);
     castParameter(apvts, ParameterID::envDecay, envDecayParam);
@@ -44,21 +62,49 @@ CynthiaAudioProcessor::CynthiaAudioProcessor()
     castParameter(apvts, ParameterID::filterCutoff, filterCutoffParam);
     castParameter(apvts, ParameterID::filterResonance, filterResonanceParam);
 
+    castParameter(apvts, ParameterID::chorusMix, chorusMixParam);
+    castParameter(apvts, ParameterID::chorusRate, chorusRateParam);
+    castParameter(apvts, ParameterID::chorusDepth, chorusDepthParam);
+    castParameter(apvts, ParameterID::delayMix, delayMixParam);
+    castParameter(apvts, ParameterID::delayTime, delayTimeParam);
+    castParameter(apvts, ParameterID::delayFeedback, delayFeedbackParam);
+    castParameter(apvts, ParameterID::reverbMix, reverbMixParam);
+    castParameter(apvts, ParameterID::reverbSize, reverbSizeParam);
+    castParameter(apvts, ParameterID::reverbDamping, reverbDampingParam);
+
     castParameter(apvts, ParameterID::outputGain, outputGainParam);
 
     apvts.state.addListener(this);
+
+    presetIndex = presetLibrary->getIndex();
+    numPresets.store(static_cast<int>(presetIndex->size()));
+    presetLibrary->addChangeListener(this);
+
+    startTimerHz(50);
 }
 
 CynthiaAudioProcessor::~CynthiaAudioProcessor()
 {
+    stopTimer();
+    presetLibrary->removeChangeListener(this);
     apvts.state.removeListener(this);
 }
 
 // a method for any pre-playback intialization
 void CynthiaAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    synth.allocateResources(sampleRate, samplesPerBlock);
-    parametersChanged.store(true);
+    synth.allocateResources(sampleRate, samplesPerBlock, voiceCountParam->get());
+    scopeBuffer.setSampleRate(sampleRate);
+    performanceMeter.prepare(sampleRate, samplesPerBlock);
+    liveMidiQueue.prepare(sampleRate);
+    blockMidi.ensureSize(4096);
+
+    // the audio thread isn't running, so whatever it was switching to is in the parameters by now
+    usingSnapshot = false;
+
+    // apply the parameters before reset(), so the effects start out at the patch's settings
+    // rather than smoothing their way over from wherever they were left
+    update();
     reset();
 }
 
@@ -86,6 +132,14 @@ void CynthiaAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
     */
     juce::ScopedNoDenormals noDenormals;
 
+    // with CYNTHIA_RT_CHECKS on, any allocation or mutex lock from here on is reported.
+    // compiles to nothing otherwise
+    RealtimeSafety::ScopedAudioThread realtimeCheck;
+
+    // times everything below, up to the end of the block
+    PerformanceMeter::ScopedBlockTimer blockTimer(performanceMeter, buffer.getNumSamples());
+    CYNTHIA_PROFILE_BLOCK(buffer.getNumSamples());
+
     /*
         JUCE does not guarantee the AudioBuffer is already cleared.
         So we must clear it of potential garbage values.
@@ -94,15 +148,85 @@ void CynthiaAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
 
     buffer.clear();
 
+    // a program change or restored state arrives as one snapshot. The message thread writes it
+    // into the parameters one at a time, so until it has finished, update() reads the snapshot
+    // instead, and never sees half of one program and half of another (see applySnapshot())
+    bool snapshotArrived = takeSnapshot();
+
+    if (usingSnapshot && numSnapshotsBeingApplied.load() == 0 && snapshotQueue.getNumReady() == 0)
+    {
+        // the parameters have caught up, along with anything automated since
+        usingSnapshot = false;
+        parametersChanged.store(true);
+    }
+
+    // a freshly imported wavetable replaces the old one on every voice at once
+    if (auto *wavetable = wavetableHandoff.takeLatest())
+        synth.setUserWavetable(wavetable);
+
     bool expected = true;
     
     // this line does a thread-safe check to see if parametersChanged is true.
     // if so, it calls the update method to perform parameter recalculation
-    // then immediately sets parametersChanged back to false
-    if (parametersChanged.compare_exchange_strong(expected, false))
+    // then immediately sets parametersChanged back to false.
+    // while a snapshot is in use, the parameters are still being written, so only a new
+    // snapshot counts. They're read again once they've caught up
+    bool changed = parametersChanged.compare_exchange_strong(expected, false);
+
+    if (usingSnapshot ? snapshotArrived : changed)
         update();
 
-    splitBufferByEvents(buffer, midiMessages);
+    // a program may have started arriving while update() was reading the parameters. It's
+    // queued before any of them change, so if this block read some of it, it's waiting here
+    if (! usingSnapshot && takeSnapshot())
+        update();
+
+    // the delay and synced LFOs follow the host's tempo and song position when there is a host.
+    // read once per block; Synth works out where each sample falls from there
+    TempoSync::Transport transport;
+
+    if (auto *playHead = getPlayHead())
+    {
+        if (auto position = playHead->getPosition())
+        {
+            if (auto bpm = position->getBpm())
+                transport.bpm = *bpm;
+
+            if (auto ppq = position->getPpqPosition())
+            {
+                transport.ppqPosition = *ppq;
+                transport.hasPosition = true;
+            }
+
+            transport.isPlaying = position->getIsPlaying();
+        }
+    }
+
+    synth.setTransport(transport, buffer.getNumSamples());
+
+    // notes played on the editor's keyboard join the host's MIDI, at the offsets they were played at
+    blockMidi.clear();
+    blockMidi.addEvents(midiMessages, 0, -1, 0);
+    midiMessages.clear();
+    liveMidiQueue.drainInto(blockMidi, buffer.getNumSamples());
+
+    {
+        CYNTHIA_PROFILE_SCOPE(SplitBufferByEvents);
+        splitBufferByEvents(buffer, blockMidi);
+    }
+
+    performanceMeter.recordVoices(synth.getNumActiveVoices(), synth.numVoices, synth.takeNumStolenVoices());
+
+    // a few atomic stores per voice, and only while the envelope or LFO display is showing
+    if (voicePlayheads.hasReaders())
+        synth.publishPlayheads(voicePlayheads);
+
+    // costs nothing unless the editor's scope is showing
+    scopeBuffer.push(buffer, 0, buffer.getNumSamples());
+
+    int program = synth.takeProgramChange();
+    if (program >= 0)
+        requestedProgram.store(program);
 }
 
 //==============================================================================
@@ -166,7 +290,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout CynthiaAudioProcessor::creat
 
 void CynthiaAudioProcessor::update()
 {
-    synth.outputGain = outputGainParam->get();
+    synth.outputGain = valueOf(outputGainParam);
     
     updatePolyMode();
 
@@ -176,43 +300,90 @@ void CynthiaAudioProcessor::update()
 
     updateDateWavetable();
 
+    updateOsc2();
+
     updateLFO();
+
+    updateEffects();
 }
 
 void CynthiaAudioProcessor::updateDateWavetable() 
 {
-    synth.setOscWaveformIndices(wavetypeAParamOsc->getIndex(), wavetypeBParamOsc->getIndex());
-    synth.setOscMorphValue(morphValueParamOsc->get());
-    synth.setOscDetuneCentsValue(detuneCentsParamOsc->get());
+    synth.setOscWaveformIndices(valueOf(wavetypeAParamOsc), valueOf(wavetypeBParamOsc));
+    synth.setOscMorphValue(valueOf(morphValueParamOsc));
+    synth.setOscDetuneCentsValue(valueOf(detuneCentsParamOsc));
+    synth.setOscTableSource(valueOf(tableSourceParamOsc));
+    synth.setOscInterpolation(valueOf(interpolationParamOsc));
+    synth.setNoiseLevel(valueOf(noiseLevelParam));
+    synth.setNoiseType(valueOf(noiseTypeParam));
+}
+
+void CynthiaAudioProcessor::updateOsc2()
+{
+    synth.setOsc2Level(valueOf(levelParamOsc2));
+    synth.setOsc2WaveformIndex(valueOf(wavetypeParamOsc2));
+    synth.setOsc2Semitones(valueOf(semitonesParamOsc2));
+    synth.setOsc2FMAmount(valueOf(fmAmountParamOsc2));
+    synth.setOsc2RingMod(valueOf(ringModParamOsc2));
+    synth.setOsc2Sync(valueOf(syncParamOsc2) == 1);
 }
 
 void CynthiaAudioProcessor::updateLFO()
 {
-    synth.setLFOWaveformIndices(wavetypeAParamLFO->getIndex(), wavetypeBParamLFO->getIndex());
-    synth.setLFOMorphValue(morphValueParamLFO->get());
-    synth.setLFODetuneCentsValue(detuneCentsParamLFO->get());
-    synth.setLFOModDepthValue(modDepthParamLFO->get());
-    synth.setLFOModFreqValue(modFreqParamLFO->get());
+    synth.setLFOWaveformIndices(valueOf(wavetypeAParamLFO), valueOf(wavetypeBParamLFO));
+    synth.setLFOMorphValue(valueOf(morphValueParamLFO));
+    synth.setLFODetuneCentsValue(valueOf(detuneCentsParamLFO));
+    synth.setLFOModDepthValue(valueOf(modDepthParamLFO));
+    synth.setLFOModFreqValue(valueOf(modFreqParamLFO));
+    synth.setLFOPositionModValue(valueOf(positionModParamLFO));
+    synth.setLFOSyncRate(valueOf(syncRateParamLFO));
+}
+
+void CynthiaAudioProcessor::updateEffects()
+{
+    synth.setChorus(valueOf(chorusMixParam), valueOf(chorusRateParam), valueOf(chorusDepthParam));
+    synth.setDelay(valueOf(delayMixParam), valueOf(delayFeedbackParam), valueOf(delayTimeParam));
+    synth.setReverb(valueOf(reverbMixParam), valueOf(reverbSizeParam), valueOf(reverbDampingParam));
 }
 
 void CynthiaAudioProcessor::updatePolyMode()
 {
-    synth.numVoices = (polyModeParam->getIndex() == 0) ? 1 : Synth::MAX_VOICES;
+    // the pool may briefly be smaller than the parameter until updateVoicePool() catches up
+    int polyVoices = juce::jmin(valueOf(voiceCountParam), synth.getVoicePoolSize());
+    synth.numVoices = (valueOf(polyModeParam) == 0) ? 1 : polyVoices;
+    synth.setDeterministic(valueOf(deterministicParam) == 1);
+}
+
+// APVTS flushes parameter changes into its ValueTree on the message thread, so this is where
+// the voice pool gets resized when the voice count changes. suspendProcessing() waits for
+// the block in progress to finish, so the audio thread never sees the pool mid-resize.
+void CynthiaAudioProcessor::updateVoicePool()
+{
+    int newPoolSize = voiceCountParam->get();
+
+    if (newPoolSize == synth.getVoicePoolSize())
+        return;
+
+    suspendProcessing(true);
+    synth.resizeVoicePool(newPoolSize);
+    suspendProcessing(false);
+
+    parametersChanged.store(true);
 }
 
 void CynthiaAudioProcessor::updateFilter()
 {
-    synth.setFilterType(filterTypeParam->getIndex());
-    synth.setFilterCutoff(filterCutoffParam->get());
-    synth.setFilterResonance(filterResonanceParam->get());
+    synth.setFilterType(valueOf(filterTypeParam));
+    synth.setFilterCutoff(valueOf(filterCutoffParam));
+    synth.setFilterResonance(valueOf(filterResonanceParam));
 }
 
 void CynthiaAudioProcessor::updateADSR()
 {
-    synth.setEnvAttack(envAttackParam->get());
-    synth.setEnvDecay(envDecayParam->get());
-    synth.setEnvSustain(envSustainParam->get());
-    synth.setEnvRelease(envReleaseParam->get());
+    synth.setEnvAttack(valueOf(envAttackParam));
+    synth.setEnvDecay(valueOf(envDecayParam));
+    synth.setEnvSustain(valueOf(envSustainParam));
+    synth.setEnvRelease(valueOf(envReleaseParam));
 }
 
 //==============================================================================
@@ -250,36 +421,176 @@ bool CynthiaAudioProcessor::isMidiEffect() const
 
 double CynthiaAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // the delay and reverb keep ringing after the last note. This is a generous upper bound
+    // rather than an exact figure, so hosts don't cut the tail off when bouncing
+    bool hasTail = delayMixParam->get() > 0.0f || reverbMixParam->get() > 0.0f;
+    return hasTail ? 10.0 : 0.0;
 }
 
 int CynthiaAudioProcessor::getNumPrograms()
 {
-    return 1; // NB: some hosts don't cope very well if you tell them there are 0 programs,
-              // so this should be at least 1, even if you're not really implementing programs.
+    // the factory programs, then the library's presets
+    return programBank.getNumPrograms() + numPresets.load();
 }
 
 int CynthiaAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram;
 }
 
 void CynthiaAudioProcessor::setCurrentProgram(int index)
 {
-    juce::ignoreUnused(index);
+    if (index < 0 || index >= getNumPrograms())
+        return;
+
+    currentProgram = index;
+    unresolvedProgram = -1;
+
+    if (index < programBank.getNumPrograms())
+        applySnapshot(programBank.getProgram(index).snapshot);
+    else if (index - programBank.getNumPrograms() < static_cast<int>(presetIndex->size()))
+        loadPreset((*presetIndex)[static_cast<size_t>(index - programBank.getNumPrograms())]);
 }
 
 const juce::String CynthiaAudioProcessor::getProgramName(int index)
 {
-    juce::ignoreUnused(index);
-    return {};
+    if (index < 0 || index >= getNumPrograms())
+        return {};
+
+    if (index < programBank.getNumPrograms())
+        return programBank.getProgram(index).name;
+
+    auto presetNumber = static_cast<size_t>(index - programBank.getNumPrograms());
+    return presetNumber < presetIndex->size() ? (*presetIndex)[presetNumber].name : juce::String();
 }
 
 void CynthiaAudioProcessor::changeProgramName(int index, const juce::String &newName)
 {
+    // factory programs can't be renamed, and library presets are renamed through their files
     juce::ignoreUnused(index, newName);
 }
 
+PresetLibrary &CynthiaAudioProcessor::getPresetLibrary()
+{
+    return *presetLibrary;
+}
+
+bool CynthiaAudioProcessor::loadPreset(const PresetLibrary::Entry &preset)
+{
+    // the preset data is already in memory (the library indexed it), so this never touches the disk
+    ParameterSnapshot snapshot;
+    PluginState::Extras extras;
+
+    if (! decodeState(preset.state.getData(), static_cast<int>(preset.state.getSize()), snapshot, extras))
+        return false;
+
+    applySnapshot(snapshot);
+    restoreUserWavetable(extras);
+    return true;
+}
+
+juce::File CynthiaAudioProcessor::savePreset(const juce::String &name, const juce::StringArray &tags)
+{
+    juce::MemoryBlock state;
+    getStateInformation(state);
+    return presetLibrary->savePreset(name, state, tags);
+}
+
+void CynthiaAudioProcessor::changeListenerCallback(juce::ChangeBroadcaster *)
+{
+    presetIndex = presetLibrary->getIndex();
+    numPresets.store(static_cast<int>(presetIndex->size()));
+
+    // the session's parameters are already restored, so this only puts the program number back
+    if (unresolvedProgram >= 0 && unresolvedProgram < getNumPrograms())
+        currentProgram = std::exchange(unresolvedProgram, -1);
+
+    updateHostDisplay(juce::AudioProcessorListener::ChangeDetails().withProgramChanged(true));
+}
+
+void CynthiaAudioProcessor::timerCallback()
+{
+    wavetableHandoff.releaseUnused();
+
+    std::vector<WavetableImport> imports;
+    {
+        const juce::ScopedLock scopedLock(wavetableImportLock);
+        imports.swap(finishedWavetableImports);
+    }
+
+    // the path is only kept once the table has loaded, so a failed import isn't saved with the session
+    for (const auto &import : imports)
+    {
+        if (import.file == importingWavetableFile)
+            importingWavetableFile = juce::File();
+
+        if (import.errorMessage.isEmpty())
+            userWavetableFile = import.file;
+
+        if (onWavetableLoaded)
+            onWavetableLoaded(import.file, import.errorMessage);
+    }
+
+    int program = requestedProgram.exchange(-1);
+
+    if (program >= 0 && program < getNumPrograms())
+    {
+        setCurrentProgram(program);
+        updateHostDisplay(juce::AudioProcessorListener::ChangeDetails().withProgramChanged(true));
+    }
+}
+
+void CynthiaAudioProcessor::applySnapshot(const ParameterSnapshot &snapshot)
+{
+    // the audio thread renders from the snapshot until the count is back to 0, i.e. until every
+    // parameter below has been written. Counted before the push, so it can't stop any earlier
+    numSnapshotsBeingApplied.fetch_add(1);
+
+    // the audio thread empties the queue every block, so it's only ever full while processing
+    // has stopped. Then nothing can see the parameters change halfway, and writing them is enough
+    bool queued = snapshotQueue.push(snapshot);
+    juce::ignoreUnused(queued);
+
+    snapshot.applyToNotifyingHost(getParameters());
+    numSnapshotsBeingApplied.fetch_sub(1);
+}
+
+bool CynthiaAudioProcessor::takeSnapshot()
+{
+    // only the latest one matters
+    bool taken = false;
+    while (snapshotQueue.pop(activeSnapshot))
+        taken = true;
+
+    if (taken)
+        usingSnapshot = true;
+
+    return taken;
+}
+
+// what update() reads: the parameter's value, or the snapshot's while one is in use
+float CynthiaAudioProcessor::valueOf(const juce::AudioParameterFloat *parameter) const
+{
+    return usingSnapshot ? parameter->convertFrom0to1(snapshotValueOf(parameter)) : parameter->get();
+}
+
+int CynthiaAudioProcessor::valueOf(const juce::AudioParameterInt *parameter) const
+{
+    return usingSnapshot ? juce::roundToInt(parameter->convertFrom0to1(snapshotValueOf(parameter))) : parameter->get();
+}
+
+int CynthiaAudioProcessor::valueOf(const juce::AudioParameterChoice *parameter) const
+{
+    return usingSnapshot ? juce::roundToInt(parameter->convertFrom0to1(snapshotValueOf(parameter))) : parameter->getIndex();
+}
+
+float CynthiaAudioProcessor::snapshotValueOf(const juce::RangedAudioParameter *parameter) const
+{
+    int index = parameter->getParameterIndex();
+    return juce::isPositiveAndBelow(index, activeSnapshot.numValues) ? activeSnapshot.values[static_cast<size_t>(index)]
+                                                                      : parameter->getValue();
+}
+
 //==============================================================================
 
 // Called by the DAW to query the number of channels supported
@@ -320,17 +631,123 @@ juce::AudioProcessorEditor *CynthiaAudioProcessor::createEditor()
 //==============================================================================
 void CynthiaAudioProcessor::getStateInformation(juce::MemoryBlock &destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
-    juce::ignoreUnused(destData);
+    if (stateFormat == PluginState::Format::Xml)
+    {
+        auto state = apvts.copyState();
+        state.setProperty("program", getSavedProgram(), nullptr);
+        state.setProperty("wavetable", getSavedWavetableFile().getFullPathName(), nullptr);
+
+        if (auto xml = state.createXml())
+            copyXmlToBinary(*xml, destData);
+
+        return;
+    }
+
+    // a few bytes per parameter, and no XML to build or parse
+    PluginState::writeBinary(getParameters(), { getSavedProgram(), getSavedWavetableFile().getFullPathName() }, destData);
 }
 
 void CynthiaAudioProcessor::setStateInformation(const void *data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
-    juce::ignoreUnused(data, sizeInBytes);
+    ParameterSnapshot snapshot;
+    PluginState::Extras extras;
+
+    if (decodeState(data, sizeInBytes, snapshot, extras))
+    {
+        // a library preset may not be indexed yet (the library scans on a background thread).
+        // changeListenerCallback() resolves the program once it is
+        currentProgram = 0;
+        unresolvedProgram = -1;
+
+        if (extras.program < getNumPrograms())
+            currentProgram = juce::jmax(0, extras.program);
+        else
+            unresolvedProgram = extras.program;
+
+        applySnapshot(snapshot);
+        restoreUserWavetable(extras);
+    }
+}
+
+int CynthiaAudioProcessor::getSavedProgram() const
+{
+    return unresolvedProgram >= 0 ? unresolvedProgram : currentProgram;
+}
+
+bool CynthiaAudioProcessor::decodeState(const void *data, int sizeInBytes, ParameterSnapshot &snapshot, PluginState::Extras &extras)
+{
+    if (PluginState::isBinaryState(data, sizeInBytes))
+        return PluginState::readBinary(data, sizeInBytes, getParameters(), snapshot, extras);
+
+    // XML fallback, for states saved with PluginState::Format::Xml
+    auto xml = getXmlFromBinary(data, sizeInBytes);
+
+    if (xml == nullptr || ! xml->hasTagName(apvts.state.getType()))
+        return false;
+
+    auto state = juce::ValueTree::fromXml(*xml);
+    extras.program = state.getProperty("program", 0);
+    extras.userWavetable = state.getProperty("wavetable").toString();
+    snapshot = ParameterSnapshot::defaults(getParameters());
+
+    // APVTS stores plain (denormalised) values
+    for (const auto &child : state)
+    {
+        int index = ParameterSnapshot::findIndex(getParameters(), child.getProperty("id").toString());
+
+        if (auto *parameter = dynamic_cast<juce::RangedAudioParameter *>(getParameters()[index]))
+            snapshot.values[index] = parameter->convertTo0to1(child.getProperty("value"));
+    }
+
+    return true;
+}
+
+void CynthiaAudioProcessor::restoreUserWavetable(const PluginState::Extras &extras)
+{
+    // a missing file keeps whatever table is loaded. The path is remembered either way,
+    // so saving the session again doesn't lose it
+    juce::File file(extras.userWavetable);
+
+    if (extras.userWavetable.isEmpty() || file == userWavetableFile || file == importingWavetableFile)
+        return;
+
+    if (file.existsAsFile())
+        loadUserWavetable(file);
+    else
+        userWavetableFile = file;
+}
+
+void CynthiaAudioProcessor::loadUserWavetable(const juce::File &file)
+{
+    importingWavetableFile = file;
+
+    backgroundJobs.addJob([this, file]
+    {
+        juce::String errorMessage;
+
+        if (auto wavetable = WavetableImporter::importFile(file, errorMessage))
+            wavetableHandoff.publish(wavetable);
+        else if (errorMessage.isEmpty())
+            errorMessage = "Couldn't import " + file.getFileName();
+
+        const juce::ScopedLock scopedLock(wavetableImportLock);
+        finishedWavetableImports.push_back({ file, errorMessage });
+    });
+}
+
+juce::File CynthiaAudioProcessor::getUserWavetableFile() const
+{
+    return userWavetableFile;
+}
+
+juce::File CynthiaAudioProcessor::getSavedWavetableFile() const
+{
+    return importingWavetableFile != juce::File() ? importingWavetableFile : userWavetableFile;
+}
+
+void CynthiaAudioProcessor::setStateFormat(PluginState::Format newFormat)
+{
+    stateFormat = newFormat;
 }
 
 //==============================================================================
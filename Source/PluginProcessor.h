@@ -2,10 +2,22 @@
 #include "Cynthia_DSP/Synth.h"
 #include "Cynthia_DSP/WaveformGenerator.h"
 #include "Cynthia_Utilities/Utils.h"
+#include "Cynthia_Utilities/LockFreeQueue.h"
+#include "Cynthia_Utilities/ParameterSnapshot.h"
+#include "Cynthia_Utilities/PluginState.h"
+#include "Cynthia_Utilities/ProgramBank.h"
+#include "Cynthia_Utilities/PresetLibrary.h"
+#include "Cynthia_Utilities/AudioThreadHandoff.h"
+#include "Cynthia_Utilities/ScopeBuffer.h"
+#include "Cynthia_Utilities/PerformanceMeter.h"
+#include "Cynthia_Utilities/VoicePlayheads.h"
+#include "Cynthia_Utilities/LiveMidiQueue.h"
 
 //==============================================================================
 class CynthiaAudioProcessor final : public juce::AudioProcessor, 
-                                    private juce::ValueTree::Listener
+                                    private juce::ValueTree::Listener,
+                                    private juce::ChangeListener,
+                                    private juce::Timer
 {
 public:
     //==============================================================================
@@ -45,6 +57,46 @@ public:
     void getStateInformation(juce::MemoryBlock &destData) override;
     void setStateInformation(const void *data, int sizeInBytes) override;
 
+    // getStateInformation() writes compact binary by default. XML is handy for diffing sessions
+    void setStateFormat(PluginState::Format newFormat);
+
+    // set every parameter at once. Message thread: the parameters are written and the host and
+    // editor notified here, while the audio thread renders from the whole snapshot until they're done
+    void applySnapshot(const ParameterSnapshot &snapshot);
+
+    // the preset library, shared by every instance. Programs past the factory ones are its presets
+    PresetLibrary& getPresetLibrary();
+
+    // load (or preview, while browsing) a library preset. Goes through applySnapshot(),
+    // so it takes effect at the next block without interrupting playback
+    bool loadPreset(const PresetLibrary::Entry &preset);
+
+    // save the current sound into the preset library
+    juce::File savePreset(const juce::String &name, const juce::StringArray &tags = {});
+
+    // import a wavetable from an audio file on a background thread. Once it's ready, the audio
+    // thread swaps it in at the start of a block, even while notes are playing
+    void loadUserWavetable(const juce::File &file);
+
+    // the last file that imported successfully
+    juce::File getUserWavetableFile() const;
+
+    // called on the message thread when an import finishes. The error message is empty if it worked
+    std::function<void(const juce::File &file, const juce::String &errorMessage)> onWavetableLoaded;
+
+    // the output as the audio thread rendered it, for the editor's scope and spectrum view
+    ScopeBuffer& getScopeBuffer() { return scopeBuffer; }
+
+    // each voice's envelope and LFO position, for the editor's envelope and LFO displays
+    VoicePlayheads& getVoicePlayheads() { return voicePlayheads; }
+
+    // MIDI played on the editor's keyboard. Push from the message thread only
+    LiveMidiQueue& getLiveMidiQueue() { return liveMidiQueue; }
+
+    // audio thread load, voice usage and near-xruns, safe to call from any thread
+    PerformanceMeter::Stats getPerformanceStats() const { return performanceMeter.getStats(); }
+    void resetPerformanceStats() { performanceMeter.reset(); }
+
     // needs to be public so the plugin editor can access it
     juce::AudioProcessorValueTreeState apvts {*this, nullptr, "Parameters", createParameterLayout()};
 private:
@@ -55,19 +107,96 @@ private:
     void createWaveTable(std::shared_ptr<juce::AudioBuffer<float>> wt); // called only once at initilization
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
-    void valueTreePropertyChanged(juce::ValueTree&, const juce::Identifier&) override
+    void valueTreePropertyChanged(juce::ValueTree& tree, const juce::Identifier&) override
     {
         parametersChanged.store(true);
+
+        // the voice pool can only be resized off the audio thread
+        if (tree.getProperty("id").toString() == ParameterID::voiceCount.getParamID())
+            updateVoicePool();
     }
 
+    // the program number to save: a restored one the library hasn't indexed yet, or the current one
+    int getSavedProgram() const;
+
+    // turn state data in either format into a snapshot. Doesn't touch the parameters
+    bool decodeState(const void *data, int sizeInBytes, ParameterSnapshot &snapshot, PluginState::Extras &extras);
+
+    // load the state's user wavetable, unless it's the one already loaded
+    void restoreUserWavetable(const PluginState::Extras &extras);
+
+    // the library's index changed, so the host's program list did too
+    void changeListenerCallback(juce::ChangeBroadcaster*) override;
+
+    // picks up MIDI program changes recorded by the audio thread, reports finished wavetable
+    // imports, and frees wavetables the audio thread no longer uses
+    void timerCallback() override;
+
     std::atomic<bool> parametersChanged { false };
+    std::atomic<int> requestedProgram { -1 };
+
+    // audio thread. Takes the latest queued snapshot, if there is one, and starts using it
+    bool takeSnapshot();
+
+    // update() reads the parameters through these, so it can read a snapshot instead
+    float valueOf(const juce::AudioParameterFloat *parameter) const;
+    int valueOf(const juce::AudioParameterInt *parameter) const;
+    int valueOf(const juce::AudioParameterChoice *parameter) const;
+    float snapshotValueOf(const juce::RangedAudioParameter *parameter) const;
+
+    // whole parameter snapshots (programs, restored state) on their way to the audio thread,
+    // and how many applySnapshot() calls are still writing theirs into the parameters
+    LockFreeQueue<ParameterSnapshot, 8> snapshotQueue;
+    std::atomic<int> numSnapshotsBeingApplied { 0 };
+
+    // audio thread only
+    ParameterSnapshot activeSnapshot;
+    bool usingSnapshot = false;
+
+    ProgramBank programBank { getParameters() };
+    juce::SharedResourcePointer<PresetLibrary> presetLibrary;
+    std::shared_ptr<const PresetLibrary::Index> presetIndex; // only touched on the message thread
+    std::atomic<int> numPresets { 0 };
+    int currentProgram = 0;
+    int unresolvedProgram = -1; // a restored library preset's program, until the library has indexed it
+
+    PluginState::Format stateFormat = PluginState::Format::Binary;
+
+    AudioThreadHandoff<Wavetable> wavetableHandoff;
+    juce::File userWavetableFile;
+    juce::File importingWavetableFile; // message thread only
+
+    // the wavetable path to save: one still being imported, or the one loaded
+    juce::File getSavedWavetableFile() const;
+
+    // imports the background jobs have finished, for timerCallback() to report
+    struct WavetableImport
+    {
+        juce::File file;
+        juce::String errorMessage;
+    };
+
+    juce::CriticalSection wavetableImportLock;
+    std::vector<WavetableImport> finishedWavetableImports;
+
+    ScopeBuffer scopeBuffer;
+    PerformanceMeter performanceMeter;
+    VoicePlayheads voicePlayheads;
+
+    // live MIDI from the editor, and the block's MIDI with it merged in. The buffer's storage
+    // is set aside in prepareToPlay(), so merging doesn't allocate
+    LiveMidiQueue liveMidiQueue;
+    juce::MidiBuffer blockMidi;
 
     void update();
     void updatePolyMode();
+    void updateVoicePool();
     void updateADSR();
     void updateFilter();
     void updateDateWavetable();
+    void updateOsc2();
     void updateLFO();
+    void updateEffects();
     
     Synth synth;
 
@@ -80,6 +209,17 @@ private:
     juce::AudioParameterChoice* wavetypeBParamOsc;
     juce::AudioParameterFloat* morphValueParamOsc;
     juce::AudioParameterFloat* detuneCentsParamOsc;
+    juce::AudioParameterChoice* tableSourceParamOsc;
+    juce::AudioParameterChoice* interpolationParamOsc;
+    juce::AudioParameterFloat* noiseLevelParam;
+    juce::AudioParameterChoice* noiseTypeParam;
+
+    juce::AudioParameterFloat* levelParamOsc2;
+    juce::AudioParameterChoice* wavetypeParamOsc2;
+    juce::AudioParameterInt* semitonesParamOsc2;
+    juce::AudioParameterFloat* fmAmountParamOsc2;
+    juce::AudioParameterFloat* ringModParamOsc2;
+    juce::AudioParameterChoice* syncParamOsc2;
 
     juce::AudioParameterChoice* wavetypeAParamLFO;
     juce::AudioParameterChoice* wavetypeBParamLFO;
@@ -87,8 +227,12 @@ private:
     juce::AudioParameterFloat* detuneCentsParamLFO;
     juce::AudioParameterFloat* modDepthParamLFO;
     juce::AudioParameterFloat* modFreqParamLFO;
+    juce::AudioParameterFloat* positionModParamLFO;
+    juce::AudioParameterChoice* syncRateParamLFO;
 
     juce::AudioParameterChoice* polyModeParam;
+    juce::AudioParameterInt* voiceCountParam;
+    juce::AudioParameterChoice* deterministicParam;
     juce::AudioParameterFloat* envAttackParam;
     juce::AudioParameterFloat* envDecayParam;
     juce::AudioParameterFloat* envSustainParam;
@@ -98,8 +242,22 @@ private:
     juce::AudioParameterFloat* filterCutoffParam;
     juce::AudioParameterFloat* filterResonanceParam;
 
+    juce::AudioParameterFloat* chorusMixParam;
+    juce::AudioParameterFloat* chorusRateParam;
+    juce::AudioParameterFloat* chorusDepthParam;
+    juce::AudioParameterFloat* delayMixParam;
+    juce::AudioParameterChoice* delayTimeParam;
+    juce::AudioParameterFloat* delayFeedbackParam;
+    juce::AudioParameterFloat* reverbMixParam;
+    juce::AudioParameterFloat* reverbSizeParam;
+    juce::AudioParameterFloat* reverbDampingParam;
+
     juce::AudioParameterFloat* outputGainParam;
 
+    // wavetable imports and other slow jobs. Declared last, so it's destroyed (and its jobs
+    // finished) before anything they use
+    juce::ThreadPool backgroundJobs { 1 };
+
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CynthiaAudioProcessor)
 };
@@ -0,0 +1,61 @@
+/*
+    ProcessorTestHelpers.h
+
+    Shared by the test suites that drive CynthiaAudioProcessor through processBlock(): setting
+    parameters by their plain value, and rendering a timed MIDI sequence block by block.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include "PluginProcessor.h"
+
+namespace ProcessorTestHelpers
+{
+    // a MIDI message at a sample position from the start of the render
+    struct TimedMessage
+    {
+        int time;
+        juce::MidiMessage message;
+    };
+
+    // keeps messages at the same time in the order they were added
+    inline void sortByTime(std::vector<TimedMessage> &messages)
+    {
+        std::stable_sort(messages.begin(), messages.end(), [](const auto &a, const auto &b) { return a.time < b.time; });
+    }
+
+    // value is the plain value, e.g. Hz for a cutoff or the index of a choice
+    inline void setParameter(CynthiaAudioProcessor &processor, const juce::ParameterID &id, float value)
+    {
+        auto *parameter = processor.apvts.getParameter(id.getParamID());
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    // numSamples of stereo output, rendered in blocks of blockSize (the last one may be shorter).
+    // the messages must be sorted by time. The processor must already be prepared
+    inline juce::AudioBuffer<float> render(CynthiaAudioProcessor &processor, const std::vector<TimedMessage> &midi, int numSamples, int blockSize)
+    {
+        juce::AudioBuffer<float> output(2, numSamples);
+        juce::MidiBuffer midiMessages;
+        size_t nextMessage = 0;
+
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            int blockLength = juce::jmin(blockSize, numSamples - start);
+            juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), 2, start, blockLength);
+
+            midiMessages.clear();
+            while (nextMessage < midi.size() && midi[nextMessage].time < start + blockLength)
+            {
+                midiMessages.addEvent(midi[nextMessage].message, midi[nextMessage].time - start);
+                ++nextMessage;
+            }
+
+            processor.processBlock(block, midiMessages);
+        }
+
+        return output;
+    }
+}
@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include "ProcessorTestHelpers.h"
+
+/*
+    Test Suite Name: TestDeterministicRendering
+
+    Each test renders the same reference MIDI (overlapping notes, enough of them to steal voices,
+    pitch bend and mod wheel) through a patch that uses every source of state: noise, oscillator 2
+    FM, the LFO, chorus, delay and reverb. Deterministic mode is on. The output is reduced to a
+    64-bit FNV-1a hash over the sample bits, frame by frame, so two renders match only if they're
+    bit for bit the same.
+
+    SameOutputAtEveryBlockSize: renders with blocks of 1, 37, 64 and 512 samples and checks that
+    the hashes match.
+
+    SameOutputAfterReset: renders, resets the processor, renders again, and checks the hashes match.
+
+    MatchesGoldenHash: compares the hash with the one recorded in Tests/Golden. A DSP change that
+    is meant to leave the sound alone must keep this passing. When the output is meant to change,
+    run the tests with CYNTHIA_UPDATE_GOLDEN=1 to record the new hash, and commit it.
+
+    Bit for bit only holds for one compiler on one instruction set: another compiler (or another
+    ISA, or -ffast-math) is free to contract, reorder and vectorise differently. So the hash is
+    kept per platform, in DeterministicRender-<compiler>-<arch>.hash, and a platform without one
+    is skipped rather than failed. Regressions across platforms are TestGoldenAudio's job, with
+    tolerances.
+*/
+
+namespace
+{
+    using namespace ProcessorTestHelpers;
+
+    constexpr double sampleRate = 48000.0;
+    constexpr int maxBlockSize = 512;
+    constexpr int numSamples = 96000;
+
+    std::vector<TimedMessage> makeReferenceMidi()
+    {
+        std::vector<TimedMessage> messages;
+
+        // 48 notes, a new one every 2000 samples, each held for 6000
+        for (int i = 0; i < 48; ++i)
+        {
+            int note = 48 + (i * 7) % 24;
+            auto velocity = static_cast<juce::uint8>(60 + (i * 13) % 60);
+            messages.push_back({ i * 2000, juce::MidiMessage::noteOn(1, note, velocity) });
+            messages.push_back({ i * 2000 + 6000, juce::MidiMessage::noteOff(1, note) });
+        }
+
+        for (int i = 0; i < 16; ++i)
+        {
+            messages.push_back({ 1000 + i * 5000, juce::MidiMessage::pitchWheel(1, 8192 + (i % 4 - 2) * 1500) });
+            messages.push_back({ 3100 + i * 5000, juce::MidiMessage::controllerEvent(1, 1, (i * 17) % 128) });
+        }
+
+        sortByTime(messages);
+        return messages;
+    }
+
+    void prepareReferencePatch(CynthiaAudioProcessor &processor)
+    {
+        setParameter(processor, ParameterID::deterministic, 1.0f);
+        setParameter(processor, ParameterID::noiseLevel, 0.2f);
+        setParameter(processor, ParameterID::noiseType, 1.0f);
+        setParameter(processor, ParameterID::levelOsc2, 0.3f);
+        setParameter(processor, ParameterID::fmAmountOsc2, 0.2f);
+        setParameter(processor, ParameterID::modDepthLFO, 0.3f);
+        setParameter(processor, ParameterID::modFreqLFO, 3.0f);
+        setParameter(processor, ParameterID::positionModLFO, 0.5f);
+        setParameter(processor, ParameterID::chorusMix, 0.3f);
+        setParameter(processor, ParameterID::delayMix, 0.3f);
+        setParameter(processor, ParameterID::reverbMix, 0.2f);
+        setParameter(processor, ParameterID::envRelease, 0.3f);
+
+        processor.setRateAndBufferSizeDetails(sampleRate, maxBlockSize);
+        processor.prepareToPlay(sampleRate, maxBlockSize);
+    }
+
+    // FNV-1a, one byte at a time over every sample's bits, left then right
+    struct OutputHash
+    {
+        void add(float sample)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &sample, sizeof(bits));
+
+            for (int byte = 0; byte < 4; ++byte)
+            {
+                value ^= (bits >> (8 * byte)) & 0xFFu;
+                value *= 0x100000001B3ull;
+            }
+        }
+
+        uint64_t value = 0xCBF29CE484222325ull;
+    };
+
+    uint64_t render(CynthiaAudioProcessor &processor, int blockSize)
+    {
+        static const auto midi = makeReferenceMidi();
+
+        auto output = ProcessorTestHelpers::render(processor, midi, numSamples, blockSize);
+        OutputHash hash;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            hash.add(output.getSample(0, i));
+            hash.add(output.getSample(1, i));
+        }
+
+        return hash.value;
+    }
+
+    uint64_t renderReference(int blockSize)
+    {
+        CynthiaAudioProcessor processor;
+        prepareReferencePatch(processor);
+        return render(processor, blockSize);
+    }
+
+    juce::String toString(uint64_t hash)
+    {
+        return juce::String::toHexString(static_cast<juce::int64>(hash)).paddedLeft('0', 16);
+    }
+
+    // the compiler and instruction set the hash holds for
+    juce::String getPlatformKey()
+    {
+       #if JUCE_CLANG
+        juce::String compiler = "clang";
+       #elif JUCE_GCC
+        juce::String compiler = "gcc";
+       #elif JUCE_MSVC
+        juce::String compiler = "msvc";
+       #else
+        juce::String compiler = "unknown";
+       #endif
+
+       #if JUCE_INTEL && JUCE_64BIT
+        juce::String arch = "x86_64";
+       #elif JUCE_INTEL
+        juce::String arch = "x86";
+       #elif JUCE_ARM && JUCE_64BIT
+        juce::String arch = "arm64";
+       #elif JUCE_ARM
+        juce::String arch = "arm";
+       #else
+        juce::String arch = "unknown";
+       #endif
+
+        return compiler + "-" + arch;
+    }
+}
+
+TEST(TestDeterministicRendering, SameOutputAtEveryBlockSize)
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    uint64_t reference = renderReference(maxBlockSize);
+
+    for (int blockSize : { 1, 37, 64 })
+        EXPECT_EQ(renderReference(blockSize), reference) << "with blocks of " << blockSize << " samples";
+}
+
+TEST(TestDeterministicRendering, SameOutputAfterReset)
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    CynthiaAudioProcessor processor;
+    prepareReferencePatch(processor);
+
+    uint64_t first = render(processor, 256);
+    processor.reset();
+    uint64_t second = render(processor, 256);
+
+    EXPECT_EQ(first, second);
+}
+
+TEST(TestDeterministicRendering, MatchesGoldenHash)
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::String hash = toString(renderReference(maxBlockSize));
+    juce::File goldenFile = juce::File(CYNTHIA_GOLDEN_DIR).getChildFile("DeterministicRender-" + getPlatformKey() + ".hash");
+
+    if (juce::SystemStats::getEnvironmentVariable("CYNTHIA_UPDATE_GOLDEN", {}) == "1")
+    {
+        goldenFile.getParentDirectory().createDirectory();
+        ASSERT_TRUE(goldenFile.replaceWithText(hash + "\n"));
+        GTEST_SKIP() << "recorded the golden hash " << hash.toStdString() << " in " << goldenFile.getFullPathName().toStdString();
+    }
+
+    if (! goldenFile.existsAsFile())
+        GTEST_SKIP() << "there's no golden hash for " << getPlatformKey().toStdString() << " (" << goldenFile.getFullPathName().toStdString()
+                     << "). Record it by running this test with CYNTHIA_UPDATE_GOLDEN=1 on a build you trust, and commit it";
+
+    EXPECT_EQ(hash.toStdString(), goldenFile.loadFileAsString().trim().toStdString())
+        << "the rendered output changed. If that's intended, run with CYNTHIA_UPDATE_GOLDEN=1 and commit the new hash";
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "Cynthia_DSP/Effects.h"
+
+/*
+    Test Suite Name: TestEffects
+
+    DelayFollowsTheTempo: sends an impulse through the ping-pong delay and checks that the first
+    echo arrives on the left after an eighth note at the set tempo, and the next one on the right
+    an eighth note later, quieter by the feedback.
+
+    EffectsStartCleanAfterBypass: checks that the chain reports itself off at mix 0, and that a delay
+    switched back on doesn't play the echoes left over from before it was switched off.
+
+    PreparesAgainAfterRelease: releases the chain's memory, prepares it again, and checks that the
+    delay and reverb still work with the parameters they had before.
+*/
+
+namespace
+{
+    constexpr float sampleRate = 48000.0f;
+}
+
+TEST(TestEffects, DelayFollowsTheTempo)
+{
+    DelayEffect delay;
+    delay.prepare(sampleRate);
+    delay.setParameters(1.0f, 0.5f, 1); // 1/8
+    delay.setTempo(100.0);
+
+    int eighthNote = juce::roundToInt(0.5 * 60.0 / 100.0 * sampleRate);
+    int numSamples = 2 * eighthNote + 10;
+
+    std::vector<float> left(static_cast<size_t>(numSamples)), right(static_cast<size_t>(numSamples));
+    left[0] = right[0] = 1.0f;
+
+    delay.process(left.data(), right.data(), numSamples);
+
+    // the dry impulse, then the echoes. the input is the mono sum (halved)
+    EXPECT_FLOAT_EQ(left[0], 1.0f);
+    EXPECT_FLOAT_EQ(left[static_cast<size_t>(eighthNote)], 1.0f);
+    EXPECT_FLOAT_EQ(right[static_cast<size_t>(eighthNote)], 0.0f);
+    EXPECT_FLOAT_EQ(right[static_cast<size_t>(2 * eighthNote)], 0.5f);
+
+    float otherSamples = 0.0f;
+    for (int i = 1; i < numSamples; ++i)
+    {
+        if (i != eighthNote)
+            otherSamples += std::abs(left[static_cast<size_t>(i)]);
+        if (i != 2 * eighthNote)
+            otherSamples += std::abs(right[static_cast<size_t>(i)]);
+    }
+    EXPECT_EQ(otherSamples, 0.0f);
+}
+
+TEST(TestEffects, EffectsStartCleanAfterBypass)
+{
+    constexpr int blockSize = 256;
+
+    EffectsChain effects;
+    effects.prepare(sampleRate);
+    EXPECT_FALSE(effects.isOn());
+
+    // fill the delay line with a loud block, then switch the delay off
+    effects.delay.setParameters(1.0f, 0.9f, 0);
+    EXPECT_TRUE(effects.isOn());
+
+    std::vector<float> left(blockSize, 1.0f), right(blockSize, 1.0f);
+    effects.process(left.data(), right.data(), blockSize);
+
+    effects.delay.setParameters(0.0f, 0.9f, 0);
+    EXPECT_FALSE(effects.isOn());
+    effects.skip();
+
+    // back on with silence going in: nothing should come out
+    effects.delay.setParameters(1.0f, 0.9f, 0);
+
+    for (int block = 0; block < 40; ++block)
+    {
+        std::fill(left.begin(), left.end(), 0.0f);
+        std::fill(right.begin(), right.end(), 0.0f);
+        effects.process(left.data(), right.data(), blockSize);
+
+        ASSERT_EQ(juce::FloatVectorOperations::findMaximum(left.data(), blockSize), 0.0f) << "block " << block;
+        ASSERT_EQ(juce::FloatVectorOperations::findMaximum(right.data(), blockSize), 0.0f) << "block " << block;
+    }
+}
+
+TEST(TestEffects, PreparesAgainAfterRelease)
+{
+    EffectsChain effects;
+    effects.prepare(sampleRate);
+    effects.delay.setParameters(1.0f, 0.0f, 1); // 1/8
+    effects.delay.setTempo(100.0);
+    effects.reverb.setParameters(0.3f, 0.5f, 0.5f);
+
+    effects.release();
+    effects.prepare(sampleRate);
+    EXPECT_TRUE(effects.isOn());
+
+    int eighthNote = juce::roundToInt(0.5 * 60.0 / 100.0 * sampleRate);
+    int numSamples = eighthNote + 10;
+
+    std::vector<float> left(static_cast<size_t>(numSamples)), right(static_cast<size_t>(numSamples));
+    left[0] = right[0] = 1.0f;
+
+    effects.process(left.data(), right.data(), numSamples);
+
+    float energy = 0.0f;
+    for (int i = 1; i < eighthNote; ++i)
+        energy += left[static_cast<size_t>(i)] * left[static_cast<size_t>(i)];
+
+    // the reverb tail before the echo, and the echo itself on top of it
+    EXPECT_GT(energy, 0.0f);
+    EXPECT_GT(std::abs(left[static_cast<size_t>(eighthNote)]), std::abs(left[static_cast<size_t>(eighthNote - 1)]));
+}
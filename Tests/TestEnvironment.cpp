@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+#include "Cynthia_DSP/WavetableCache.h"
+#include "Cynthia_Utilities/PresetLibrary.h"
+
+/*
+    Not a test suite. Registers a gtest environment that points everything the plugin keeps in the
+    user's application data folder at a temporary folder instead, so test runs never read or
+    change the user's own files. The folder is deleted when the tests are done.
+*/
+
+namespace
+{
+    class TemporaryUserDataEnvironment : public ::testing::Environment
+    {
+    public:
+        void SetUp() override
+        {
+            folder = juce::File::createTempFile("CynthiaTestData");
+            folder.createDirectory();
+
+            PresetLibrary::setDefaultPresetFolder(folder.getChildFile("Presets"));
+            WavetableCache::setDirectory(folder.getChildFile("WavetableCache"));
+        }
+
+        void TearDown() override
+        {
+            PresetLibrary::setDefaultPresetFolder({});
+            WavetableCache::setDirectory(WavetableCache::getDefaultDirectory());
+
+            folder.deleteRecursively();
+        }
+
+    private:
+        juce::File folder;
+    };
+
+    // gtest takes ownership
+    const auto *environment = ::testing::AddGlobalTestEnvironment(new TemporaryUserDataEnvironment());
+}
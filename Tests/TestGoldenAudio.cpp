@@ -0,0 +1,365 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_dsp/juce_dsp.h>
+#include "ProcessorTestHelpers.h"
+
+/*
+    Test Suite Name: TestGoldenAudio
+
+    Renders fixed scenarios (a patch and a MIDI sequence) through the processor and compares them
+    with reference WAVs in Tests/Golden. Unlike the hash in TestDeterministicRendering, the
+    comparison has tolerances, so a rewrite that changes the rounding (SIMD, block processing,
+    fixed-point phase) passes as long as it sounds the same:
+
+        RMS error        of the difference, in dB below the reference's RMS
+        peak deviation   the largest difference at any one sample
+        spectral         the largest difference between the average spectra, in dB per band
+
+    Every scenario reports its metrics and how long it took to render (as a fraction of realtime)
+    as test properties, so they show up in the XML output next to the result.
+
+    The references are float WAVs, only written when the tests run with CYNTHIA_UPDATE_GOLDEN=1,
+    which is for when the sound is meant to change (or a new scenario is added). Commit them along
+    with the change. A scenario without a reference is skipped, with a message saying how to
+    record it, so a checkout that doesn't have them yet still runs green.
+
+    MetricsCatchDifferences: checks the metrics on their own: zero for identical audio, and over
+    the tolerances for a 1 dB gain change and for a few samples of delay.
+
+    InitPatch, FilterAndExpression, Oscillator2AndNoise, Effects: one scenario each.
+*/
+
+namespace
+{
+    using namespace ProcessorTestHelpers;
+
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 256;
+    constexpr int numSamples = 48000;
+
+    struct Tolerances
+    {
+        double maxRmsErrorDb = -60.0;
+        float maxPeakDeviation = 1.0e-3f;
+        double maxSpectralDifferenceDb = 0.5;
+    };
+
+    struct Metrics
+    {
+        double rmsErrorDb = -std::numeric_limits<double>::infinity();
+        float peakDeviation = 0.0f;
+        double spectralDifferenceDb = 0.0;
+    };
+
+    struct Scenario
+    {
+        juce::String name;
+        std::function<void(CynthiaAudioProcessor &)> patch;
+        std::vector<TimedMessage> midi;
+    };
+
+    //==============================================================================
+    // the average magnitude spectrum of a channel in dB, Hann windowed, half overlapping frames
+    std::vector<double> averageSpectrumDb(const float *samples, int length)
+    {
+        constexpr int order = 11;
+        constexpr int size = 1 << order;
+
+        juce::dsp::FFT fft(order);
+        juce::dsp::WindowingFunction<float> window(size, juce::dsp::WindowingFunction<float>::hann, false);
+        std::vector<float> frame(2 * size);
+        std::vector<double> sum(size / 2 + 1, 0.0);
+        int numFrames = 0;
+
+        for (int start = 0; start + size <= length; start += size / 2)
+        {
+            std::copy(samples + start, samples + start + size, frame.begin());
+            std::fill(frame.begin() + size, frame.end(), 0.0f);
+            window.multiplyWithWindowingTable(frame.data(), size);
+            fft.performFrequencyOnlyForwardTransform(frame.data(), true);
+
+            for (size_t bin = 0; bin < sum.size(); ++bin)
+                sum[bin] += frame[bin];
+
+            ++numFrames;
+        }
+
+        // a floor well below anything audible, so silent bands compare as equal
+        for (auto &magnitude : sum)
+            magnitude = 20.0 * std::log10(juce::jmax(1.0e-7, magnitude / juce::jmax(1, numFrames)));
+
+        return sum;
+    }
+
+    Metrics compare(const juce::AudioBuffer<float> &reference, const juce::AudioBuffer<float> &rendered)
+    {
+        Metrics metrics;
+        double errorEnergy = 0.0, referenceEnergy = 0.0;
+        int length = juce::jmin(reference.getNumSamples(), rendered.getNumSamples());
+
+        for (int channel = 0; channel < reference.getNumChannels(); ++channel)
+        {
+            const float *expected = reference.getReadPointer(channel);
+            const float *actual = rendered.getReadPointer(channel);
+
+            for (int i = 0; i < length; ++i)
+            {
+                float difference = actual[i] - expected[i];
+                errorEnergy += difference * difference;
+                referenceEnergy += expected[i] * expected[i];
+                metrics.peakDeviation = juce::jmax(metrics.peakDeviation, std::abs(difference));
+            }
+
+            auto expectedSpectrum = averageSpectrumDb(expected, length);
+            auto actualSpectrum = averageSpectrumDb(actual, length);
+
+            for (size_t bin = 0; bin < expectedSpectrum.size(); ++bin)
+                metrics.spectralDifferenceDb = juce::jmax(metrics.spectralDifferenceDb, std::abs(actualSpectrum[bin] - expectedSpectrum[bin]));
+        }
+
+        if (errorEnergy > 0.0)
+            metrics.rmsErrorDb = 10.0 * std::log10(errorEnergy / juce::jmax(1.0e-20, referenceEnergy));
+
+        return metrics;
+    }
+
+    //==============================================================================
+    // the whole scenario in one buffer, and the time it took
+    juce::AudioBuffer<float> render(const Scenario &scenario, double &secondsTaken)
+    {
+        CynthiaAudioProcessor processor;
+
+        // the references must be reproducible, so the oscillators and noise start the same way every time
+        setParameter(processor, ParameterID::deterministic, 1.0f);
+        scenario.patch(processor);
+
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        auto startTicks = juce::Time::getHighResolutionTicks();
+        auto output = ProcessorTestHelpers::render(processor, scenario.midi, numSamples, blockSize);
+
+        secondsTaken = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+        return output;
+    }
+
+    bool readWav(const juce::File &file, juce::AudioBuffer<float> &buffer)
+    {
+        juce::WavAudioFormat format;
+        std::unique_ptr<juce::AudioFormatReader> reader(format.createReaderFor(file.createInputStream().release(), true));
+
+        if (reader == nullptr)
+            return false;
+
+        buffer.setSize(static_cast<int>(reader->numChannels), static_cast<int>(reader->lengthInSamples));
+        return reader->read(&buffer, 0, buffer.getNumSamples(), 0, true, true);
+    }
+
+    // 32-bit float, so the reference is exactly what was rendered
+    bool writeWav(const juce::File &file, const juce::AudioBuffer<float> &buffer)
+    {
+        file.getParentDirectory().createDirectory();
+        file.deleteFile();
+
+        std::unique_ptr<juce::OutputStream> stream = file.createOutputStream();
+        if (stream == nullptr)
+            return false;
+
+        juce::WavAudioFormat format;
+        std::unique_ptr<juce::AudioFormatWriter> writer(format.createWriterFor(stream.get(), sampleRate, static_cast<unsigned int>(buffer.getNumChannels()), 32, {}, 0));
+
+        if (writer == nullptr)
+            return false;
+
+        // the writer owns the stream now
+        stream.release();
+        return writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+    }
+
+    void checkScenario(const Scenario &scenario, const Tolerances &tolerances = {})
+    {
+        double secondsTaken = 0.0;
+        juce::AudioBuffer<float> rendered = render(scenario, secondsTaken);
+
+        ::testing::Test::RecordProperty("realtimeFraction", juce::String(secondsTaken * sampleRate / numSamples, 4).toStdString());
+
+        juce::File goldenFile = juce::File(CYNTHIA_GOLDEN_DIR).getChildFile(scenario.name + ".wav");
+
+        if (juce::SystemStats::getEnvironmentVariable("CYNTHIA_UPDATE_GOLDEN", {}) == "1")
+        {
+            ASSERT_TRUE(writeWav(goldenFile, rendered)) << "couldn't write " << goldenFile.getFullPathName().toStdString();
+            GTEST_SKIP() << "recorded the reference " << goldenFile.getFullPathName().toStdString();
+        }
+
+        if (! goldenFile.existsAsFile())
+            GTEST_SKIP() << "there's no reference " << goldenFile.getFullPathName().toStdString()
+                         << " yet. Record it by running this test with CYNTHIA_UPDATE_GOLDEN=1 on a build you trust, and commit it";
+
+        juce::AudioBuffer<float> reference;
+        ASSERT_TRUE(readWav(goldenFile, reference)) << "couldn't read " << goldenFile.getFullPathName().toStdString();
+        ASSERT_EQ(reference.getNumChannels(), rendered.getNumChannels());
+        ASSERT_EQ(reference.getNumSamples(), rendered.getNumSamples());
+
+        Metrics metrics = compare(reference, rendered);
+
+        ::testing::Test::RecordProperty("rmsErrorDb", juce::String(metrics.rmsErrorDb, 2).toStdString());
+        ::testing::Test::RecordProperty("peakDeviation", juce::String(metrics.peakDeviation, 7).toStdString());
+        ::testing::Test::RecordProperty("spectralDifferenceDb", juce::String(metrics.spectralDifferenceDb, 3).toStdString());
+
+        EXPECT_LE(metrics.rmsErrorDb, tolerances.maxRmsErrorDb);
+        EXPECT_LE(metrics.peakDeviation, tolerances.maxPeakDeviation);
+        EXPECT_LE(metrics.spectralDifferenceDb, tolerances.maxSpectralDifferenceDb);
+    }
+
+    //==============================================================================
+    // a held chord, and a short melody over it
+    std::vector<TimedMessage> chordAndMelody(int channel = 1)
+    {
+        std::vector<TimedMessage> midi;
+
+        for (int note : { 48, 55, 64 })
+        {
+            midi.push_back({ 0, juce::MidiMessage::noteOn(channel, note, (juce::uint8) 100) });
+            midi.push_back({ 36000, juce::MidiMessage::noteOff(channel, note) });
+        }
+
+        for (int i = 0; i < 6; ++i)
+        {
+            int note = 72 + (i * 5) % 12;
+            midi.push_back({ 4000 + i * 5000, juce::MidiMessage::noteOn(channel, note, (juce::uint8) (70 + i * 8)) });
+            midi.push_back({ 7500 + i * 5000, juce::MidiMessage::noteOff(channel, note) });
+        }
+
+        sortByTime(midi);
+        return midi;
+    }
+
+    Scenario initPatch()
+    {
+        return { "InitPatch", [](CynthiaAudioProcessor &) {}, chordAndMelody() };
+    }
+
+    // a resonant low-pass, swept by channel pressure, with pitch bend and CC74 morphing on an MPE channel
+    Scenario filterAndExpression()
+    {
+        auto midi = chordAndMelody(2);
+
+        // an MPE Configuration Message first, so channel 2 is a member channel of the lower zone
+        midi.insert(midi.begin(), { { 0, juce::MidiMessage::controllerEvent(1, 101, 0) },
+                                    { 0, juce::MidiMessage::controllerEvent(1, 100, 6) },
+                                    { 0, juce::MidiMessage::controllerEvent(1, 6, 15) } });
+
+        for (int i = 0; i < 40; ++i)
+        {
+            int time = 500 + i * 1000;
+            midi.push_back({ time, juce::MidiMessage::channelPressureChange(2, (i * 6) % 128) });
+            midi.push_back({ time, juce::MidiMessage::pitchWheel(2, 8192 + static_cast<int>(1200.0 * std::sin(i * 0.4))) });
+            midi.push_back({ time, juce::MidiMessage::controllerEvent(2, 74, (i * 9) % 128) });
+        }
+
+        sortByTime(midi);
+
+        return { "FilterAndExpression",
+                 [](CynthiaAudioProcessor &processor)
+                 {
+                     setParameter(processor, ParameterID::wavetypeAOsc, 1.0f);
+                     setParameter(processor, ParameterID::wavetypeBOsc, 3.0f);
+                     setParameter(processor, ParameterID::filterCutoff, 800.0f);
+                     setParameter(processor, ParameterID::filterResonance, 0.9f);
+                     setParameter(processor, ParameterID::modDepthLFO, 0.2f);
+                     setParameter(processor, ParameterID::modFreqLFO, 5.0f);
+                 },
+                 midi };
+    }
+
+    Scenario oscillator2AndNoise()
+    {
+        return { "Oscillator2AndNoise",
+                 [](CynthiaAudioProcessor &processor)
+                 {
+                     setParameter(processor, ParameterID::levelOsc2, 0.4f);
+                     setParameter(processor, ParameterID::semitonesOsc2, 7.0f);
+                     setParameter(processor, ParameterID::fmAmountOsc2, 0.3f);
+                     setParameter(processor, ParameterID::ringModOsc2, 0.2f);
+                     setParameter(processor, ParameterID::noiseLevel, 0.15f);
+                     setParameter(processor, ParameterID::noiseType, 2.0f);
+                     setParameter(processor, ParameterID::interpolationOsc, 1.0f);
+                 },
+                 chordAndMelody() };
+    }
+
+    Scenario effects()
+    {
+        return { "Effects",
+                 [](CynthiaAudioProcessor &processor)
+                 {
+                     setParameter(processor, ParameterID::envRelease, 0.5f);
+                     setParameter(processor, ParameterID::chorusMix, 0.5f);
+                     setParameter(processor, ParameterID::delayMix, 0.4f);
+                     setParameter(processor, ParameterID::delayFeedback, 0.5f);
+                     setParameter(processor, ParameterID::reverbMix, 0.3f);
+                 },
+                 chordAndMelody() };
+    }
+}
+
+TEST(TestGoldenAudio, MetricsCatchDifferences)
+{
+    juce::AudioBuffer<float> reference(2, 8192);
+
+    for (int channel = 0; channel < 2; ++channel)
+        for (int i = 0; i < reference.getNumSamples(); ++i)
+            reference.setSample(channel, i, 0.5f * std::sin(0.05f * i) + 0.2f * std::sin(0.31f * i));
+
+    Tolerances tolerances;
+
+    Metrics same = compare(reference, reference);
+    EXPECT_EQ(same.peakDeviation, 0.0f);
+    EXPECT_LT(same.rmsErrorDb, tolerances.maxRmsErrorDb);
+    EXPECT_EQ(same.spectralDifferenceDb, 0.0);
+
+    juce::AudioBuffer<float> louder(reference);
+    louder.applyGain(juce::Decibels::decibelsToGain(1.0f));
+    Metrics gain = compare(reference, louder);
+    EXPECT_GT(gain.rmsErrorDb, tolerances.maxRmsErrorDb);
+    EXPECT_GT(gain.peakDeviation, tolerances.maxPeakDeviation);
+    EXPECT_NEAR(gain.spectralDifferenceDb, 1.0, 0.01);
+
+    // a delay leaves the spectrum alone, but the waveforms no longer line up
+    juce::AudioBuffer<float> delayed(2, reference.getNumSamples());
+    delayed.clear();
+    for (int channel = 0; channel < 2; ++channel)
+        delayed.copyFrom(channel, 3, reference, channel, 0, reference.getNumSamples() - 3);
+
+    Metrics delay = compare(reference, delayed);
+    EXPECT_GT(delay.rmsErrorDb, tolerances.maxRmsErrorDb);
+    EXPECT_GT(delay.peakDeviation, tolerances.maxPeakDeviation);
+}
+
+TEST(TestGoldenAudio, InitPatch)
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    checkScenario(initPatch());
+}
+
+TEST(TestGoldenAudio, FilterAndExpression)
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    checkScenario(filterAndExpression());
+}
+
+TEST(TestGoldenAudio, Oscillator2AndNoise)
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    checkScenario(oscillator2AndNoise());
+}
+
+TEST(TestGoldenAudio, Effects)
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    checkScenario(effects());
+}
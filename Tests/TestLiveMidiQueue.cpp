@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include "Cynthia_Utilities/LiveMidiQueue.h"
+
+/*
+    Test Suite Name: TestLiveMidiQueue
+
+    PlacesEventsWhereTheyWerePlayed: pushes notes at known times and checks that they come out
+    one block later at the matching sample offsets, in order, with the right bytes.
+
+    FollowsTheActualDrainInterval: drains further apart and closer together than a block, as real
+    callbacks do, and checks that the interval is spread over the block rather than events being
+    clamped to its edges.
+
+    DropsWhatDoesNotFit: checks that sysex is refused, that a full queue drops the overflow,
+    and that a late block clamps old events to its first sample rather than losing them.
+*/
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 480; // 10 ms
+}
+
+TEST(TestLiveMidiQueue, PlacesEventsWhereTheyWerePlayed)
+{
+    LiveMidiQueue queue;
+    queue.prepare(sampleRate);
+
+    juce::MidiBuffer midi;
+    EXPECT_EQ(queue.drainInto(midi, blockSize, 1.0), 0);
+    EXPECT_TRUE(midi.isEmpty());
+
+    // played 2.5 ms and 7.5 ms into the block that runs up to the next drain
+    queue.push(juce::MidiMessage::noteOn(1, 60, (juce::uint8) 100), 1.0025);
+    queue.push(juce::MidiMessage::noteOff(1, 60), 1.0075);
+
+    EXPECT_EQ(queue.drainInto(midi, blockSize, 1.01), 2);
+
+    std::vector<std::pair<int, juce::MidiMessage>> events;
+    for (const auto metadata : midi)
+        events.emplace_back(metadata.samplePosition, metadata.getMessage());
+
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].first, 120);
+    EXPECT_TRUE(events[0].second.isNoteOn());
+    EXPECT_EQ(events[0].second.getNoteNumber(), 60);
+    EXPECT_EQ(events[0].second.getVelocity(), 100);
+    EXPECT_EQ(events[1].first, 360);
+    EXPECT_TRUE(events[1].second.isNoteOff());
+}
+
+TEST(TestLiveMidiQueue, FollowsTheActualDrainInterval)
+{
+    LiveMidiQueue queue;
+    queue.prepare(sampleRate);
+
+    juce::MidiBuffer midi;
+    queue.drainInto(midi, blockSize, 1.0);
+
+    auto getOffsets = [&midi]
+    {
+        std::vector<int> offsets;
+        for (const auto metadata : midi)
+            offsets.push_back(metadata.samplePosition);
+
+        midi.clear();
+        return offsets;
+    };
+
+    // 15 ms between drains: a sixth and five sixths of the way through
+    queue.push(juce::MidiMessage::noteOn(1, 60, (juce::uint8) 100), 1.0025);
+    queue.push(juce::MidiMessage::noteOff(1, 60), 1.0125);
+    EXPECT_EQ(queue.drainInto(midi, blockSize, 1.015), 2);
+    EXPECT_EQ(getOffsets(), std::vector<int>({ 80, 400 }));
+
+    // then only 6 ms: halfway
+    queue.push(juce::MidiMessage::noteOn(1, 62, (juce::uint8) 100), 1.018);
+    EXPECT_EQ(queue.drainInto(midi, blockSize, 1.021), 1);
+    EXPECT_EQ(getOffsets(), std::vector<int>({ 240 }));
+}
+
+TEST(TestLiveMidiQueue, DropsWhatDoesNotFit)
+{
+    LiveMidiQueue queue;
+    queue.prepare(sampleRate);
+
+    const juce::uint8 sysexData[] = { 0x7D, 0x01, 0x02, 0x03 };
+    EXPECT_FALSE(queue.push(juce::MidiMessage::createSysExMessage(sysexData, 4), 0.0));
+
+    for (int i = 0; i < LiveMidiQueue::capacity; ++i)
+        EXPECT_TRUE(queue.push(juce::MidiMessage::controllerEvent(1, 1, i % 128), 0.0));
+
+    EXPECT_FALSE(queue.push(juce::MidiMessage::controllerEvent(1, 1, 0), 0.0));
+
+    // the first block after a long gap: everything from before it lands on sample 0
+    juce::MidiBuffer midi;
+    EXPECT_EQ(queue.drainInto(midi, blockSize, 5.0), LiveMidiQueue::capacity);
+
+    for (const auto metadata : midi)
+        EXPECT_EQ(metadata.samplePosition, 0);
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "Cynthia_DSP/NoiseGenerator.h"
+
+namespace
+{
+    std::vector<float> renderNoise(NoiseGenerator::Type type, int numSamples, int chunkSize)
+    {
+        NoiseGenerator noise;
+        noise.setSeed(7);
+        noise.setType(type);
+        noise.setFrequency(1000.0f, 48000.0f);
+
+        std::vector<float> output(static_cast<size_t>(numSamples));
+        for (int start = 0; start < numSamples; start += chunkSize)
+            noise.renderBlock(output.data() + start, std::min(chunkSize, numSamples - start));
+
+        return output;
+    }
+
+    // power of the sample to sample difference over the power of the signal.
+    // about 2 for white noise, and lower the more the spectrum leans towards the bass
+    double getHighFrequencyRatio(const std::vector<float> &samples)
+    {
+        double power = 0.0, differencePower = 0.0;
+
+        for (size_t i = 1; i < samples.size(); ++i)
+        {
+            power += samples[i] * samples[i];
+            differencePower += (samples[i] - samples[i - 1]) * (samples[i] - samples[i - 1]);
+        }
+
+        return differencePower / power;
+    }
+}
+
+/*
+    Test Suite Name: TestNoiseGenerator
+    Test Name: WhiteNoiseIsUniform
+
+    This test checks that white noise stays within -1 to 1, averages out to 0, and has the RMS of a
+    uniform distribution (1 / sqrt(3)).
+*/
+
+TEST(TestNoiseGenerator, WhiteNoiseIsUniform)
+{
+    auto samples = renderNoise(NoiseGenerator::Type::White, 1 << 16, 512);
+
+    double sum = 0.0, sumOfSquares = 0.0;
+    for (float sample : samples)
+    {
+        ASSERT_GE(sample, -1.0f);
+        ASSERT_LE(sample, 1.0f);
+        sum += sample;
+        sumOfSquares += sample * sample;
+    }
+
+    double mean = sum / samples.size();
+    double rms = std::sqrt(sumOfSquares / samples.size());
+
+    EXPECT_NEAR(mean, 0.0, 0.01);
+    EXPECT_NEAR(rms, 1.0 / std::sqrt(3.0), 0.01);
+}
+
+/*
+    Test Suite Name: TestNoiseGenerator
+    Test Name: OutputDoesNotDependOnBlockSize
+
+    This test renders every noise type in one go and in odd sized chunks, and checks the results are
+    identical. Voices render in chunks that depend on the host's block size and the MIDI timing, so
+    anything else would make a render change with the buffer size.
+*/
+
+TEST(TestNoiseGenerator, OutputDoesNotDependOnBlockSize)
+{
+    constexpr int numSamples = 4096;
+
+    for (auto type : { NoiseGenerator::Type::White, NoiseGenerator::Type::Pink, NoiseGenerator::Type::Filtered })
+    {
+        auto whole = renderNoise(type, numSamples, numSamples);
+
+        for (int chunkSize : { 1, 3, 7, 13, 32 })
+            EXPECT_EQ(renderNoise(type, numSamples, chunkSize), whole) << "chunk size " << chunkSize;
+    }
+}
+
+/*
+    Test Suite Name: TestNoiseGenerator
+    Test Name: ColoursShapeTheSpectrum
+
+    This test compares how much high frequency energy each noise type has. Pink noise should have
+    clearly less than white noise, and noise band-passed at 1 kHz (out of 48 kHz) less still.
+    Different seeds should also give different noise.
+*/
+
+TEST(TestNoiseGenerator, ColoursShapeTheSpectrum)
+{
+    constexpr int numSamples = 1 << 16;
+
+    double white = getHighFrequencyRatio(renderNoise(NoiseGenerator::Type::White, numSamples, 64));
+    double pink = getHighFrequencyRatio(renderNoise(NoiseGenerator::Type::Pink, numSamples, 64));
+    double filtered = getHighFrequencyRatio(renderNoise(NoiseGenerator::Type::Filtered, numSamples, 64));
+
+    EXPECT_NEAR(white, 2.0, 0.05);
+    EXPECT_LT(pink, 1.0);
+    EXPECT_LT(filtered, 0.1);
+
+    NoiseGenerator first, second;
+    first.setSeed(1);
+    second.setSeed(2);
+
+    std::array<float, 64> firstSamples, secondSamples;
+    first.renderBlock(firstSamples.data(), 64);
+    second.renderBlock(secondSamples.data(), 64);
+    EXPECT_NE(firstSamples, secondSamples);
+}
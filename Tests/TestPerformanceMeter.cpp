@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include "PluginProcessor.h"
+
+/*
+    Test Suite Name: TestPerformanceMeter
+    Test Name: CountsBlocksVoicesAndSteals
+
+    This test plays more notes than the default voice count and checks that the processor's
+    performance stats report every block, the voices in use, the stolen voices and a sensible
+    load, and that resetting clears the counters.
+*/
+
+TEST(TestPerformanceMeter, CountsBlocksVoicesAndSteals)
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 256;
+    constexpr int numNotes = 20;
+
+    CynthiaAudioProcessor processor;
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::MidiBuffer midiMessages;
+
+    for (int note = 0; note < numNotes; ++note)
+        midiMessages.addEvent(juce::MidiMessage::noteOn(1, 40 + note, (juce::uint8) 100), note);
+
+    processor.processBlock(buffer, midiMessages);
+
+    for (int block = 0; block < 9; ++block)
+        processor.processBlock(buffer, midiMessages);
+
+    auto stats = processor.getPerformanceStats();
+    EXPECT_EQ(stats.numBlocks, 10u);
+    EXPECT_EQ(stats.voiceLimit, 16);
+    EXPECT_EQ(stats.activeVoices, 16);
+    EXPECT_EQ(stats.peakVoices, 16);
+    EXPECT_EQ(stats.stolenVoices, static_cast<juce::uint64>(numNotes - 16));
+    EXPECT_GT(stats.peakLoad, 0.0);
+    EXPECT_GE(stats.peakLoad, stats.lastBlockLoad);
+
+    processor.resetPerformanceStats();
+    stats = processor.getPerformanceStats();
+    EXPECT_EQ(stats.numBlocks, 0u);
+    EXPECT_EQ(stats.stolenVoices, 0u);
+    EXPECT_EQ(stats.peakLoad, 0.0);
+}
@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+#include "PluginProcessor.h"
+
+/*
+    Test Suite Name: TestPluginState
+    Test Name: BinaryAndXmlStateRoundTrip
+
+    This test ensures that a state saved by getStateInformation() restores every parameter
+    and the current program in a fresh processor, in both the binary and the XML format.
+*/
+
+TEST(TestPluginState, BinaryAndXmlStateRoundTrip)
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    for (auto format : { PluginState::Format::Binary, PluginState::Format::Xml })
+    {
+        CynthiaAudioProcessor source;
+        source.setStateFormat(format);
+        source.setCurrentProgram(2);
+
+        juce::Random random(42);
+        for (auto* parameter : source.getParameters())
+            parameter->setValueNotifyingHost(random.nextFloat());
+
+        juce::MemoryBlock state;
+        source.getStateInformation(state);
+
+        CynthiaAudioProcessor destination;
+        destination.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+
+        EXPECT_EQ(destination.getCurrentProgram(), 2);
+
+        auto& sourceParameters = source.getParameters();
+        auto& destinationParameters = destination.getParameters();
+        ASSERT_EQ(sourceParameters.size(), destinationParameters.size());
+
+        for (int index = 0; index < sourceParameters.size(); ++index)
+        {
+            EXPECT_NEAR(sourceParameters[index]->getValue(), destinationParameters[index]->getValue(), 1.0e-4f)
+                << "Parameter " << sourceParameters[index]->getName(64) << " was not restored";
+        }
+    }
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include "PluginProcessor.h"
+
+/*
+    Test Suite Name: TestPresetLibrary
+
+    IndexesSavedPresetsAndLoadsThem: saves two presets into an empty folder, waits for the background
+    scan to index them, and checks their names, tags and fingerprints. It then loads one of them into
+    a fresh processor and checks the cached index is picked up by another library without rescanning.
+
+    RestoresALibraryProgram: restores a session saved on a library preset before the library has
+    indexed it, and checks the program number survives (saving again keeps it) and becomes the
+    current program once the index arrives.
+
+    The processors share the default library, which TestEnvironment.cpp points at a temporary folder.
+*/
+
+namespace
+{
+    // the scan runs on a background thread, so give it a moment
+    bool waitForPresets(PresetLibrary& library, size_t expectedCount)
+    {
+        for (int attempt = 0; attempt < 500; ++attempt)
+        {
+            if (library.getIndex()->size() == expectedCount)
+                return true;
+
+            juce::Thread::sleep(10);
+        }
+
+        return false;
+    }
+}
+
+TEST(TestPresetLibrary, IndexesSavedPresetsAndLoadsThem)
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    auto folder = juce::File::createTempFile("CynthiaPresets");
+    ASSERT_TRUE(folder.createDirectory());
+
+    PresetLibrary library(folder);
+
+    CynthiaAudioProcessor source;
+    juce::Random random(7);
+    for (auto* parameter : source.getParameters())
+        parameter->setValueNotifyingHost(random.nextFloat());
+
+    juce::MemoryBlock state;
+    source.getStateInformation(state);
+
+    library.savePreset("Glass", state, { "Pads", "Bright" });
+    library.savePreset("Glass Copy", state);
+
+    ASSERT_TRUE(waitForPresets(library, 2));
+
+    auto index = library.getIndex();
+    const auto& glass = (*index)[0];
+    const auto& copy = (*index)[1];
+
+    EXPECT_EQ(glass.name, "Glass");
+    EXPECT_EQ(glass.tags, juce::StringArray({ "Pads", "Bright" }));
+    EXPECT_EQ(copy.name, "Glass Copy");
+    EXPECT_TRUE(copy.tags.isEmpty());
+    EXPECT_EQ(glass.fingerprint, copy.fingerprint);
+    EXPECT_EQ(library.search("pads"), std::vector<int>({ 0 }));
+
+    CynthiaAudioProcessor destination;
+    ASSERT_TRUE(destination.loadPreset(glass));
+
+    for (int parameter = 0; parameter < source.getParameters().size(); ++parameter)
+        EXPECT_NEAR(source.getParameters()[parameter]->getValue(), destination.getParameters()[parameter]->getValue(), 1.0e-4f);
+
+    // the cached index is available straight away, before any scan has finished
+    PresetLibrary cachedLibrary(folder);
+    EXPECT_EQ(cachedLibrary.getIndex()->size(), 2u);
+
+    folder.deleteRecursively();
+}
+
+TEST(TestPresetLibrary, RestoresALibraryProgram)
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    CynthiaAudioProcessor processor;
+    auto& library = processor.getPresetLibrary();
+    ASSERT_TRUE(library.getIndex()->empty());
+
+    // the second library preset, which isn't there yet
+    int numFactoryPrograms = processor.getNumPrograms();
+    int libraryProgram = numFactoryPrograms + 1;
+
+    juce::MemoryBlock state;
+    PluginState::writeBinary(processor.getParameters(), { libraryProgram, {} }, state);
+
+    processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+
+    // saved again before the index arrives, the session still points at the preset
+    juce::MemoryBlock savedAgain;
+    processor.getStateInformation(savedAgain);
+
+    ParameterSnapshot snapshot;
+    PluginState::Extras savedExtras;
+    ASSERT_TRUE(PluginState::readBinary(savedAgain.getData(), static_cast<int>(savedAgain.getSize()), processor.getParameters(), snapshot, savedExtras));
+    EXPECT_EQ(savedExtras.program, libraryProgram);
+
+    library.savePreset("First", state);
+    library.savePreset("Second", state);
+    ASSERT_TRUE(waitForPresets(library, 2));
+
+    // there's no message loop here, so deliver the library's change message directly
+    library.dispatchPendingMessages();
+
+    EXPECT_EQ(processor.getNumPrograms(), numFactoryPrograms + 2);
+    EXPECT_EQ(processor.getCurrentProgram(), libraryProgram);
+
+    library.getPresetFolder().deleteRecursively();
+}
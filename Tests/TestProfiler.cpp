@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "ProcessorTestHelpers.h"
+#include "Cynthia_Utilities/Profiler.h"
+
+/*
+    Test Suite Name: TestProfiler
+
+    Only runs when the project is configured with -DCYNTHIA_PROFILING=ON, and is skipped otherwise.
+
+    CountsEveryStage: plays chords through the processor with oscillator 2, noise and the effects
+    on, then checks that every stage was entered and counted some cycles, and that the voice
+    stages don't take longer than the block that contains them.
+
+    ExportsAChromeTrace: checks that the recorded blocks come out as trace JSON, with a slice per
+    block and a counter per stage, and that exporting takes them out of the queue. If the
+    CYNTHIA_TRACE_FILE environment variable is set, the trace is also written there, ready for
+    chrome://tracing or ui.perfetto.dev.
+*/
+
+namespace
+{
+    using namespace ProcessorTestHelpers;
+
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 256;
+    constexpr int numBlocks = 200;
+
+    // a chord every 50 blocks, so there's always something playing
+    void renderProfiledBlocks()
+    {
+        CynthiaAudioProcessor processor;
+        setParameter(processor, ParameterID::noiseLevel, 0.2f);
+        setParameter(processor, ParameterID::levelOsc2, 0.3f);
+        setParameter(processor, ParameterID::chorusMix, 0.3f);
+        setParameter(processor, ParameterID::delayMix, 0.3f);
+        setParameter(processor, ParameterID::reverbMix, 0.2f);
+
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        std::vector<TimedMessage> midi;
+
+        for (int block = 0; block < numBlocks; block += 50)
+            for (int note : { 48, 55, 60, 64 })
+                midi.push_back({ block * blockSize, juce::MidiMessage::noteOn(1, note + block / 50, (juce::uint8) 100) });
+
+        render(processor, midi, numBlocks * blockSize, blockSize);
+    }
+}
+
+TEST(TestProfiler, CountsEveryStage)
+{
+    if (! Profiler::isEnabled())
+        GTEST_SKIP() << "configure with -DCYNTHIA_PROFILING=ON to run";
+
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    Profiler::reset();
+    renderProfiledBlocks();
+
+    auto totals = Profiler::getTotals();
+    EXPECT_EQ(totals.numBlocks, static_cast<juce::uint64>(numBlocks));
+    EXPECT_EQ(totals.numDroppedBlocks, 0u);
+
+    for (int index = 0; index < Profiler::numStages; ++index)
+    {
+        auto stage = static_cast<Profiler::Stage>(index);
+        SCOPED_TRACE(Profiler::getStageName(stage));
+
+        EXPECT_GT(totals.calls[static_cast<size_t>(index)], 0u);
+        EXPECT_GT(totals.cycles[static_cast<size_t>(index)], 0u);
+
+        // stages are inclusive, so nothing can outlast the block it happened in
+        EXPECT_LE(totals.cycles[static_cast<size_t>(index)],
+                  totals.cycles[static_cast<size_t>(Profiler::Stage::ProcessBlock)]);
+
+        RecordProperty(juce::String(Profiler::getStageName(stage)).replaceCharacter(' ', '_').toStdString(),
+                       std::to_string(totals.cycles[static_cast<size_t>(index)]));
+    }
+
+    EXPECT_EQ(totals.calls[static_cast<size_t>(Profiler::Stage::ProcessBlock)], static_cast<juce::uint64>(numBlocks));
+}
+
+TEST(TestProfiler, ExportsAChromeTrace)
+{
+    if (! Profiler::isEnabled())
+        GTEST_SKIP() << "configure with -DCYNTHIA_PROFILING=ON to run";
+
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    Profiler::reset();
+    renderProfiledBlocks();
+
+    auto json = Profiler::toChromeTrace();
+    auto trace = juce::JSON::parse(json);
+
+    auto *events = trace["traceEvents"].getArray();
+    ASSERT_NE(events, nullptr);
+    EXPECT_EQ(events->size(), numBlocks * (1 + Profiler::numStages));
+
+    int numSlices = 0;
+    for (const auto &event : *events)
+        if (event["ph"].toString() == "X")
+        {
+            ++numSlices;
+            EXPECT_EQ(static_cast<int>(event["args"]["numSamples"]), blockSize);
+        }
+
+    EXPECT_EQ(numSlices, numBlocks);
+
+    // exported once: a second export has no blocks left
+    EXPECT_EQ(juce::JSON::parse(Profiler::toChromeTrace())["traceEvents"].getArray()->size(), 0);
+
+    auto traceFile = juce::SystemStats::getEnvironmentVariable("CYNTHIA_TRACE_FILE", {});
+    if (traceFile.isNotEmpty())
+        EXPECT_TRUE(juce::File(traceFile).replaceWithText(json));
+}
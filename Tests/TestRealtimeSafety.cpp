@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "PluginProcessor.h"
+#include "Cynthia_Utilities/RealtimeSafety.h"
+
+/*
+    Test Suite Name: TestRealtimeSafety
+
+    ProcessBlockDoesNotAllocateOrLock: drives CynthiaAudioProcessor with dense MIDI (notes, pitch bend,
+    pressure, CCs, sustain) and parameter automation, and fails if processBlock() allocates memory
+    or locks a mutex.
+
+    CatchesEveryAllocationFunction: checks that nothrow and over-aligned new/delete, and the aligned
+    C allocators on Linux, are reported too, so none of them can slip through the test above.
+
+    Only runs when the project is configured with -DCYNTHIA_RT_CHECKS=ON.
+*/
+
+namespace
+{
+    // stored through a volatile pointer so the compiler can't elide the new/delete pairs
+    void* volatile allocated = nullptr;
+
+    struct alignas(64) OverAligned
+    {
+        float values[16];
+    };
+
+    template <typename Function>
+    int countViolations(Function function)
+    {
+        RealtimeSafety::resetViolations();
+
+        {
+            RealtimeSafety::ScopedAudioThread audioThread;
+            function();
+        }
+
+        return RealtimeSafety::getNumViolations();
+    }
+}
+
+TEST(TestRealtimeSafety, ProcessBlockDoesNotAllocateOrLock)
+{
+    if (! RealtimeSafety::isEnabled())
+        GTEST_SKIP() << "configure with -DCYNTHIA_RT_CHECKS=ON to run the real-time safety checks";
+
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 256;
+    constexpr int numBlocks = 400;
+
+    CynthiaAudioProcessor processor;
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::MidiBuffer midiMessages;
+    juce::Random random(1234);
+
+    // allocate the MidiBuffer's storage up front, so the test itself doesn't muddy the results
+    midiMessages.ensureSize(4096);
+
+    RealtimeSafety::resetViolations();
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        midiMessages.clear();
+
+        for (int event = 0; event < 24; ++event)
+        {
+            int channel = random.nextInt(16) + 1;
+            int note = random.nextInt({ 36, 96 });
+            int position = random.nextInt(blockSize);
+
+            switch (random.nextInt(7))
+            {
+                case 0:  midiMessages.addEvent(juce::MidiMessage::noteOn(channel, note, (juce::uint8) random.nextInt({ 1, 128 })), position); break;
+                case 1:  midiMessages.addEvent(juce::MidiMessage::noteOff(channel, note), position); break;
+                case 2:  midiMessages.addEvent(juce::MidiMessage::pitchWheel(channel, random.nextInt(16384)), position); break;
+                case 3:  midiMessages.addEvent(juce::MidiMessage::channelPressureChange(channel, random.nextInt(128)), position); break;
+                case 4:  midiMessages.addEvent(juce::MidiMessage::controllerEvent(channel, 74, random.nextInt(128)), position); break;
+                case 5:  midiMessages.addEvent(juce::MidiMessage::controllerEvent(channel, 64, random.nextBool() ? 127 : 0), position); break;
+                default: midiMessages.addEvent(juce::MidiMessage::controllerEvent(channel, 1, random.nextInt(128)), position); break;
+            }
+        }
+
+        // automate a handful of parameters every block
+        for (auto* parameter : processor.getParameters())
+        {
+            if (random.nextFloat() < 0.25f)
+                parameter->setValueNotifyingHost(random.nextFloat());
+        }
+
+        // APVTS normally flushes parameter changes to its ValueTree from a timer on the message thread.
+        // there is no message loop here, so trigger the processor's listener directly
+        processor.apvts.state.sendPropertyChangeMessage("value");
+
+        processor.processBlock(buffer, midiMessages);
+    }
+
+    EXPECT_EQ(RealtimeSafety::getNumViolations(), 0) << RealtimeSafety::getReport();
+}
+
+TEST(TestRealtimeSafety, CatchesEveryAllocationFunction)
+{
+    if (! RealtimeSafety::isEnabled())
+        GTEST_SKIP() << "configure with -DCYNTHIA_RT_CHECKS=ON to run the real-time safety checks";
+
+    EXPECT_EQ(countViolations([] { allocated = new (std::nothrow) int(1); }), 1);
+    EXPECT_EQ(countViolations([] { delete static_cast<int*>(allocated); }), 1);
+
+    EXPECT_EQ(countViolations([] { allocated = new OverAligned(); }), 1);
+    EXPECT_EQ(countViolations([] { delete static_cast<OverAligned*>(allocated); }), 1);
+
+    EXPECT_EQ(countViolations([] { allocated = new (std::nothrow) OverAligned[4]; }), 1);
+    EXPECT_EQ(countViolations([] { delete[] static_cast<OverAligned*>(allocated); }), 1);
+
+   #if JUCE_LINUX
+    EXPECT_EQ(countViolations([] { void* pointer = nullptr; juce::ignoreUnused(posix_memalign(&pointer, 64, 256)); allocated = pointer; }), 1);
+    EXPECT_NE(allocated, nullptr);
+    EXPECT_EQ(countViolations([] { std::free(allocated); }), 1);
+
+    EXPECT_EQ(countViolations([] { allocated = aligned_alloc(64, 256); }), 1);
+    std::free(allocated);
+   #endif
+}
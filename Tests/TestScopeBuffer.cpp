@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include "Cynthia_Utilities/ScopeBuffer.h"
+
+/*
+    Test Suite Name: TestScopeBuffer
+    Test Name: KeepsTheNewestSamplesWhileSomeoneIsReading
+
+    This test pushes stereo blocks into a ScopeBuffer and checks that nothing is written while no
+    view is reading, that the mono mix arrives in order, and that the newest samples are still
+    returned after the ring has wrapped around several times.
+*/
+
+TEST(TestScopeBuffer, KeepsTheNewestSamplesWhileSomeoneIsReading)
+{
+    constexpr int blockSize = 500;
+
+    auto scopeBuffer = std::make_unique<ScopeBuffer>();
+    juce::AudioBuffer<float> block(2, blockSize);
+    float nextValue = 0.0f;
+
+    auto fillBlock = [&]
+    {
+        for (int sample = 0; sample < blockSize; ++sample)
+        {
+            block.setSample(0, sample, nextValue + 1.0f);
+            block.setSample(1, sample, nextValue - 1.0f); // mixes down to nextValue
+            nextValue += 1.0f;
+        }
+    };
+
+    // without a reader the audio thread doesn't even copy
+    fillBlock();
+    scopeBuffer->push(block, 0, blockSize);
+    EXPECT_EQ(scopeBuffer->getWritePosition(), 0u);
+
+    scopeBuffer->addReader();
+
+    int numBlocks = 3 * ScopeBuffer::capacity / blockSize;
+    for (int index = 0; index < numBlocks; ++index)
+    {
+        fillBlock();
+        scopeBuffer->push(block, 0, blockSize);
+    }
+
+    EXPECT_EQ(scopeBuffer->getWritePosition(), static_cast<uint32_t>(numBlocks * blockSize));
+
+    constexpr int numLatest = 2048;
+    std::vector<float> latest(numLatest);
+    scopeBuffer->copyLatest(latest.data(), numLatest);
+
+    for (int sample = 0; sample < numLatest; ++sample)
+        EXPECT_FLOAT_EQ(latest[static_cast<size_t>(sample)], nextValue - static_cast<float>(numLatest - sample));
+
+    scopeBuffer->removeReader();
+}
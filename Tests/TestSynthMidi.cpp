@@ -0,0 +1,219 @@
+#include <gtest/gtest.h>
+#include "Cynthia_DSP/Synth.h"
+
+/*
+    Test Suite Name: TestSynthMidi
+
+    PitchBendRangeFollowsTheZone: without an MPE zone every channel bends 2 semitones, so an
+    ordinary keyboard on any channel doesn't bend by octaves. With a zone, only its member
+    channels bend 48 semitones.
+
+    ConfiguredByMIDI: checks that an MPE Configuration Message sets up the zone, and that
+    RPN 0 sets a channel's pitch bend range (for all member channels when sent on one of them).
+
+    ChannelModeMessagesStayOnTheirChannel: All Notes Off and All Sound Off on one ordinary
+    channel leave the notes on other channels alone.
+
+    AllNotesOffKeepsSustainedNotes: All Notes Off while the pedal is down leaves the notes to the
+    pedal, and they're released when it comes up.
+
+    MasterChannelCoversTheZone: the sustain pedal, All Notes Off and All Sound Off on the MPE
+    master channel reach every member channel, and nothing outside the zone.
+*/
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 256;
+
+    void send(Synth &synth, const juce::MidiMessage &message)
+    {
+        auto *data = message.getRawData();
+        synth.midiMessage(data[0], message.getRawDataSize() > 1 ? data[1] : 0, message.getRawDataSize() > 2 ? data[2] : 0);
+    }
+
+    // channels are 1 to 16, as in juce::MidiMessage
+    void sendRPN(Synth &synth, int channel, int parameter, int coarse, int fine = -1)
+    {
+        send(synth, juce::MidiMessage::controllerEvent(channel, 101, parameter >> 7));
+        send(synth, juce::MidiMessage::controllerEvent(channel, 100, parameter & 0x7F));
+        send(synth, juce::MidiMessage::controllerEvent(channel, 6, coarse));
+
+        if (fine >= 0)
+            send(synth, juce::MidiMessage::controllerEvent(channel, 38, fine));
+    }
+
+    void prepare(Synth &synth)
+    {
+        synth.allocateResources(sampleRate, blockSize);
+        synth.numVoices = Synth::DEFAULT_VOICES;
+        synth.outputGain = 0.3f;
+        synth.setEnvAttack(0.001f);
+        synth.setEnvDecay(0.1f);
+        synth.setEnvSustain(0.8f);
+        synth.setEnvRelease(0.5f);
+        synth.setFilterType(0);
+        synth.setFilterCutoff(10000.0f);
+        synth.setFilterResonance(0.5f);
+        synth.reset();
+    }
+
+    constexpr float fullBend = 8191.0f / 8192.0f;
+
+    using State = VoicePlayheads::State;
+
+    // every voice's state, in voice order. Voices are taken in order while there are free ones,
+    // so the first note plays on voice 0, the next on voice 1 and so on
+    std::vector<State> getVoiceStates(const Synth &synth)
+    {
+        auto playheads = std::make_unique<VoicePlayheads>();
+        synth.publishPlayheads(*playheads);
+
+        std::vector<State> states;
+        for (int voice = 0; voice < playheads->getNumVoices(); ++voice)
+            states.push_back(playheads->get(voice).state);
+
+        return states;
+    }
+}
+
+TEST(TestSynthMidi, PitchBendRangeFollowsTheZone)
+{
+    Synth synth;
+    prepare(synth);
+
+    // no zone: channels 1 and 2 are both ordinary channels
+    send(synth, juce::MidiMessage::pitchWheel(1, 16383));
+    send(synth, juce::MidiMessage::pitchWheel(2, 16383));
+    EXPECT_NEAR(synth.getChannelPitchBend(0), Synth::MASTER_PITCH_BEND_RANGE * fullBend, 1.0e-4f);
+    EXPECT_NEAR(synth.getChannelPitchBend(1), Synth::MASTER_PITCH_BEND_RANGE * fullBend, 1.0e-4f);
+
+    // a zone with 4 member channels: 2 to 5
+    synth.setMPEZone(4);
+    send(synth, juce::MidiMessage::pitchWheel(1, 16383));
+    send(synth, juce::MidiMessage::pitchWheel(2, 16383));
+    send(synth, juce::MidiMessage::pitchWheel(6, 16383));
+    EXPECT_NEAR(synth.getChannelPitchBend(0), Synth::MASTER_PITCH_BEND_RANGE * fullBend, 1.0e-4f);
+    EXPECT_NEAR(synth.getChannelPitchBend(1), Synth::MEMBER_PITCH_BEND_RANGE * fullBend, 1.0e-3f);
+    EXPECT_NEAR(synth.getChannelPitchBend(5), Synth::MASTER_PITCH_BEND_RANGE * fullBend, 1.0e-4f);
+}
+
+TEST(TestSynthMidi, ConfiguredByMIDI)
+{
+    Synth synth;
+    prepare(synth);
+    EXPECT_EQ(synth.getNumMPEMemberChannels(), 0);
+
+    // MCM on the lower zone's master channel: 7 member channels
+    sendRPN(synth, 1, 6, 7);
+    EXPECT_EQ(synth.getNumMPEMemberChannels(), 7);
+
+    send(synth, juce::MidiMessage::pitchWheel(8, 0));
+    send(synth, juce::MidiMessage::pitchWheel(9, 0));
+    EXPECT_NEAR(synth.getChannelPitchBend(7), -Synth::MEMBER_PITCH_BEND_RANGE, 1.0e-4f);
+    EXPECT_NEAR(synth.getChannelPitchBend(8), -Synth::MASTER_PITCH_BEND_RANGE, 1.0e-4f);
+
+    // RPN 0 on a member channel sets every member channel's range
+    sendRPN(synth, 3, 0, 24);
+    send(synth, juce::MidiMessage::pitchWheel(5, 0));
+    EXPECT_NEAR(synth.getChannelPitchBend(4), -24.0f, 1.0e-4f);
+
+    // and on an ordinary channel, only that channel's. Semitones plus cents
+    sendRPN(synth, 12, 0, 12, 50);
+    send(synth, juce::MidiMessage::pitchWheel(12, 0));
+    send(synth, juce::MidiMessage::pitchWheel(13, 0));
+    EXPECT_NEAR(synth.getChannelPitchBend(11), -12.5f, 1.0e-4f);
+    EXPECT_NEAR(synth.getChannelPitchBend(12), -Synth::MASTER_PITCH_BEND_RANGE, 1.0e-4f);
+
+    // data entry without a parameter selected changes nothing
+    send(synth, juce::MidiMessage::controllerEvent(14, 6, 60));
+    send(synth, juce::MidiMessage::pitchWheel(14, 0));
+    EXPECT_NEAR(synth.getChannelPitchBend(13), -Synth::MASTER_PITCH_BEND_RANGE, 1.0e-4f);
+}
+
+TEST(TestSynthMidi, ChannelModeMessagesStayOnTheirChannel)
+{
+    Synth synth;
+    prepare(synth);
+
+    send(synth, juce::MidiMessage::noteOn(1, 60, (juce::uint8) 100));
+    send(synth, juce::MidiMessage::noteOn(2, 62, (juce::uint8) 100));
+
+    send(synth, juce::MidiMessage::allNotesOff(2));
+    auto states = getVoiceStates(synth);
+    EXPECT_EQ(states[0], State::Held);
+    EXPECT_EQ(states[1], State::Released);
+
+    send(synth, juce::MidiMessage::allSoundOff(1));
+    states = getVoiceStates(synth);
+    EXPECT_EQ(states[0], State::Idle);
+    EXPECT_EQ(states[1], State::Released);
+}
+
+TEST(TestSynthMidi, AllNotesOffKeepsSustainedNotes)
+{
+    Synth synth;
+    prepare(synth);
+
+    send(synth, juce::MidiMessage::controllerEvent(1, 64, 127));
+    send(synth, juce::MidiMessage::noteOn(1, 60, (juce::uint8) 100));
+    send(synth, juce::MidiMessage::noteOn(2, 62, (juce::uint8) 100));
+
+    send(synth, juce::MidiMessage::allNotesOff(1));
+    auto states = getVoiceStates(synth);
+    EXPECT_EQ(states[0], State::Held);
+    EXPECT_EQ(states[1], State::Held);
+
+    send(synth, juce::MidiMessage::controllerEvent(1, 64, 0));
+    states = getVoiceStates(synth);
+    EXPECT_EQ(states[0], State::Released);
+    EXPECT_EQ(states[1], State::Held);
+}
+
+TEST(TestSynthMidi, MasterChannelCoversTheZone)
+{
+    Synth synth;
+    prepare(synth);
+    synth.setMPEZone(3); // member channels 2 to 4
+
+    // the master channel's pedal holds the member channels' notes, not the ones outside
+    send(synth, juce::MidiMessage::controllerEvent(1, 64, 127));
+    send(synth, juce::MidiMessage::noteOn(2, 60, (juce::uint8) 100));
+    send(synth, juce::MidiMessage::noteOn(3, 62, (juce::uint8) 100));
+    send(synth, juce::MidiMessage::noteOn(6, 64, (juce::uint8) 100));
+    send(synth, juce::MidiMessage::noteOff(2, 60));
+    send(synth, juce::MidiMessage::noteOff(3, 62));
+    send(synth, juce::MidiMessage::noteOff(6, 64));
+
+    auto states = getVoiceStates(synth);
+    EXPECT_EQ(states[0], State::Held);
+    EXPECT_EQ(states[1], State::Held);
+    EXPECT_EQ(states[2], State::Released);
+
+    // a member channel's own pedal keeps holding its notes after the master's comes up
+    send(synth, juce::MidiMessage::controllerEvent(3, 64, 127));
+    send(synth, juce::MidiMessage::controllerEvent(1, 64, 0));
+    states = getVoiceStates(synth);
+    EXPECT_EQ(states[0], State::Released);
+    EXPECT_EQ(states[1], State::Held);
+
+    send(synth, juce::MidiMessage::controllerEvent(3, 64, 0));
+    EXPECT_EQ(getVoiceStates(synth)[1], State::Released);
+
+    // All Notes Off on the master channel releases the zone's notes only
+    send(synth, juce::MidiMessage::noteOn(2, 65, (juce::uint8) 100));
+    send(synth, juce::MidiMessage::noteOn(6, 67, (juce::uint8) 100));
+    send(synth, juce::MidiMessage::allNotesOff(1));
+    states = getVoiceStates(synth);
+    EXPECT_EQ(states[3], State::Released);
+    EXPECT_EQ(states[4], State::Held);
+
+    // and All Sound Off silences the zone's notes only
+    send(synth, juce::MidiMessage::allSoundOff(1));
+    states = getVoiceStates(synth);
+    EXPECT_EQ(states[0], State::Idle);
+    EXPECT_EQ(states[1], State::Idle);
+    EXPECT_EQ(states[2], State::Released);
+    EXPECT_EQ(states[3], State::Idle);
+    EXPECT_EQ(states[4], State::Held);
+}
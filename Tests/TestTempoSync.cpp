@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+#include "Cynthia_DSP/TempoSync.h"
+
+/*
+    Test Suite Name: TestTempoSync
+
+    LocksToTheSongPosition: starts playback half way through a beat with the LFO at a quarter note,
+    and checks that the phase is half a cycle, and a whole beat later back at half a cycle.
+
+    BlockSizeDoesNotMatter: plays the same stretch of song in blocks of 64 and in blocks of 100
+    samples, and checks that the phase is identical at every sample.
+
+    JumpRelocks: moves the song position somewhere it couldn't have got to by playing, and checks
+    that the phase follows it. Stopping keeps the LFO running from where it was.
+*/
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr double bpm = 120.0;
+    constexpr int quarterNoteIndex = 4;
+    constexpr double beatsPerSample = bpm / (60.0 * sampleRate);
+
+    TempoSync::Transport playingAt(double ppqPosition)
+    {
+        TempoSync::Transport transport;
+        transport.bpm = bpm;
+        transport.ppqPosition = ppqPosition;
+        transport.isPlaying = true;
+        transport.hasPosition = true;
+        return transport;
+    }
+
+    // every sample's phase over numSamples, fed to TempoSync in blocks like a host would
+    std::vector<PhaseAccumulator::Phase> playInBlocks(int blockSize, int numSamples)
+    {
+        TempoSync sync;
+        sync.prepare(sampleRate);
+        sync.setNoteValue(quarterNoteIndex);
+
+        std::vector<PhaseAccumulator::Phase> phases;
+
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            int blockLength = std::min(blockSize, numSamples - start);
+            sync.update(playingAt(start * beatsPerSample), blockLength);
+
+            for (int i = 0; i < blockLength; ++i)
+            {
+                phases.push_back(sync.getPhase());
+                sync.advance(1);
+            }
+        }
+
+        return phases;
+    }
+}
+
+TEST(TestTempoSync, LocksToTheSongPosition)
+{
+    TempoSync sync;
+    sync.prepare(sampleRate);
+    sync.setNoteValue(quarterNoteIndex);
+
+    EXPECT_TRUE(sync.update(playingAt(2.5), 512));
+    EXPECT_EQ(sync.getPhase(), 0x80000000u);
+
+    // a beat is a cycle at a quarter note
+    EXPECT_NEAR(sync.getTableDelta(), beatsPerSample * Wavetable::tableSize, 1e-9);
+
+    int samplesPerBeat = static_cast<int>(sampleRate * 60.0 / bpm);
+    sync.advance(samplesPerBeat);
+
+    double cycles = static_cast<double>(sync.getPhase()) / 4294967296.0;
+    EXPECT_NEAR(cycles, 0.5, 1e-4);
+}
+
+TEST(TestTempoSync, BlockSizeDoesNotMatter)
+{
+    int numSamples = 48000;
+
+    auto phases64 = playInBlocks(64, numSamples);
+    auto phases100 = playInBlocks(100, numSamples);
+
+    ASSERT_EQ(phases64.size(), phases100.size());
+
+    for (size_t i = 0; i < phases64.size(); ++i)
+        ASSERT_EQ(phases64[i], phases100[i]) << "at sample " << i;
+}
+
+TEST(TestTempoSync, JumpRelocks)
+{
+    TempoSync sync;
+    sync.prepare(sampleRate);
+    sync.setNoteValue(quarterNoteIndex);
+
+    sync.update(playingAt(0.0), 256);
+    sync.advance(256);
+
+    // carrying on from where the last block ended isn't a jump
+    EXPECT_FALSE(sync.update(playingAt(256 * beatsPerSample), 256));
+    sync.advance(256);
+
+    // a loop back to a quarter of the way through beat 4
+    EXPECT_TRUE(sync.update(playingAt(3.25), 256));
+    EXPECT_EQ(sync.getPhase(), 0x40000000u);
+    sync.advance(256);
+
+    // stopped: no position to follow, the LFO carries on at the tempo
+    PhaseAccumulator::Phase before = sync.getPhase();
+    TempoSync::Transport stopped = playingAt(0.0);
+    stopped.isPlaying = false;
+
+    EXPECT_FALSE(sync.update(stopped, 256));
+    EXPECT_EQ(sync.getPhase(), before);
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include "PluginProcessor.h"
+
+/*
+    Test Suite Name: TestVoicePlayheads
+    Test Name: PublishesEnvelopeAndLFOPositions
+
+    This test plays a note and checks that the processor publishes the voice's envelope stage,
+    level and time for the displays, that it follows the note into its release, and that nothing
+    is published while no display is reading.
+*/
+
+TEST(TestVoicePlayheads, PublishesEnvelopeAndLFOPositions)
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 480;
+
+    CynthiaAudioProcessor processor;
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    auto &playheads = processor.getVoicePlayheads();
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::MidiBuffer midiMessages;
+
+    // no display, no publishing
+    midiMessages.addEvent(juce::MidiMessage::noteOn(1, 60, (juce::uint8) 100), 0);
+    processor.processBlock(buffer, midiMessages);
+    EXPECT_EQ(playheads.getNumVoices(), 0);
+
+    playheads.addReader();
+
+    for (int block = 0; block < 10; ++block)
+        processor.processBlock(buffer, midiMessages);
+
+    ASSERT_GT(playheads.getNumVoices(), 0);
+    auto playhead = playheads.get(0);
+    EXPECT_EQ(playhead.state, VoicePlayheads::State::Held);
+    EXPECT_GT(playhead.envelopeLevel, 0.0f);
+    EXPECT_NEAR(playhead.envelopeSeconds, 11 * blockSize / sampleRate, 1.0e-3);
+    EXPECT_GE(playhead.lfoPhase, 0.0f);
+    EXPECT_LT(playhead.lfoPhase, 1.0f);
+
+    for (int voice = 1; voice < playheads.getNumVoices(); ++voice)
+        EXPECT_EQ(playheads.get(voice).state, VoicePlayheads::State::Idle);
+
+    midiMessages.addEvent(juce::MidiMessage::noteOff(1, 60), 0);
+    processor.processBlock(buffer, midiMessages);
+
+    playhead = playheads.get(0);
+    EXPECT_EQ(playhead.state, VoicePlayheads::State::Released);
+    EXPECT_NEAR(playhead.envelopeSeconds, blockSize / sampleRate, 1.0e-3);
+
+    playheads.removeReader();
+}
@@ -0,0 +1,396 @@
+#include <gtest/gtest.h>
+#include "Cynthia_DSP/Wavetable.h"
+#include "Cynthia_Utilities/WavetableImporter.h"
+#include "Cynthia_Utilities/AudioThreadHandoff.h"
+#include "Cynthia_DSP/MorphingOscillator.h"
+#include "Cynthia_DSP/WavetableCache.h"
+
+/*
+    Test Suite Name: TestWavetable
+
+    MipmapsAreBandLimited: imports a naive (aliasing) single-cycle sawtooth of an odd length
+    and checks that the top mip level is a pure sine, that a middle level has no harmonics above
+    its limit, and that the guard samples continue the cycle.
+
+    HandoffKeepsTablesAliveUntilReplaced: checks that a table handed to the audio thread
+    survives releaseUnused() until a newer one replaces it.
+
+    OscillatorScansFrames: plays a two frame table (a sine and an inverted sine) and checks
+    that the position crossfades the frames, both from the morph value and from modulation.
+
+    HigherOrderInterpolationIsCleaner: plays a table holding one high harmonic with each
+    interpolation mode and checks that the error against an exact sine shrinks from linear
+    to Hermite to sinc.
+
+    FixedPointPhaseWrapsExactly: checks the index/fraction split of the fixed-point phase, and that
+    an oscillator whose period is a whole number of samples repeats bit for bit, cycle after cycle.
+
+    SyncAndPhaseModulation: checks that hard sync makes an oscillator repeat at the period of the
+    one it follows, and that phase modulation of half a cycle turns a sine upside down while no
+    modulation changes nothing.
+
+    CacheMapsPreviouslyBuiltTables: checks that the wavetable cache shares a table within the
+    process, memory-maps it from disk once it's no longer shared, and that the mapped mipmaps
+    match the built ones.
+
+    CacheDropsStaleAndLeastRecentlyUsedTables: checks that writing a new table deletes files from
+    an older format, then the least recently used tables until the folder fits its maximum size.
+*/
+
+namespace
+{
+    // magnitude of one harmonic of a table, straight from the DFT definition
+    double getHarmonicMagnitude(const float* table, int harmonic)
+    {
+        double real = 0.0, imaginary = 0.0;
+
+        for (int sample = 0; sample < Wavetable::tableSize; ++sample)
+        {
+            double angle = juce::MathConstants<double>::twoPi * harmonic * sample / Wavetable::tableSize;
+            real += table[sample] * std::cos(angle);
+            imaginary -= table[sample] * std::sin(angle);
+        }
+
+        return std::sqrt(real * real + imaginary * imaginary) * 2.0 / Wavetable::tableSize;
+    }
+}
+
+TEST(TestWavetable, MipmapsAreBandLimited)
+{
+    constexpr int cycleLength = 1000;
+    std::vector<float> saw(cycleLength);
+
+    for (int sample = 0; sample < cycleLength; ++sample)
+        saw[static_cast<size_t>(sample)] = 2.0f * static_cast<float>(sample) / cycleLength - 1.0f;
+
+    juce::String errorMessage;
+    auto wavetable = WavetableImporter::importSamples(saw.data(), cycleLength, "Saw", errorMessage);
+    ASSERT_NE(wavetable, nullptr) << errorMessage;
+    EXPECT_EQ(wavetable->getNumFrames(), 1);
+
+    // the top level only keeps the fundamental
+    const float* top = wavetable->getTable(0, Wavetable::numMipLevels - 1);
+    EXPECT_GT(getHarmonicMagnitude(top, 1), 0.1);
+    for (int harmonic = 2; harmonic < 8; ++harmonic)
+        EXPECT_LT(getHarmonicMagnitude(top, harmonic), 1.0e-4);
+
+    // level 4 keeps 64 harmonics
+    const float* middle = wavetable->getTable(0, 4);
+    EXPECT_GT(getHarmonicMagnitude(middle, 64), 1.0e-3);
+    EXPECT_LT(getHarmonicMagnitude(middle, 65), 1.0e-4);
+    EXPECT_LT(getHarmonicMagnitude(middle, 200), 1.0e-4);
+
+    for (int guard = 1; guard <= Wavetable::guardSamples; ++guard)
+    {
+        EXPECT_FLOAT_EQ(middle[-guard], middle[Wavetable::tableSize - guard]);
+        EXPECT_FLOAT_EQ(middle[Wavetable::tableSize + guard - 1], middle[guard - 1]);
+    }
+
+    EXPECT_EQ(Wavetable::getMipLevel(0.5), 0);
+    EXPECT_EQ(Wavetable::getMipLevel(16.0), 4);
+    EXPECT_EQ(Wavetable::getMipLevel(5000.0), Wavetable::numMipLevels - 1);
+}
+
+TEST(TestWavetable, HandoffKeepsTablesAliveUntilReplaced)
+{
+    std::vector<float> sine(Wavetable::tableSize);
+    for (int sample = 0; sample < Wavetable::tableSize; ++sample)
+        sine[static_cast<size_t>(sample)] = std::sin(juce::MathConstants<float>::twoPi * sample / Wavetable::tableSize);
+
+    AudioThreadHandoff<Wavetable> handoff;
+    EXPECT_EQ(handoff.takeLatest(), nullptr);
+
+    Wavetable::Ptr first = Wavetable::build(sine.data(), 1, "first");
+    Wavetable::Ptr second = Wavetable::build(sine.data(), 1, "second");
+
+    handoff.publish(first);
+    EXPECT_EQ(handoff.takeLatest(), first.get());
+    EXPECT_EQ(handoff.takeLatest(), nullptr);
+
+    // the audio thread still uses the first table, so the pool must keep it
+    first = nullptr;
+    handoff.releaseUnused();
+
+    handoff.publish(second);
+    auto* latest = handoff.takeLatest();
+    ASSERT_NE(latest, nullptr);
+    EXPECT_EQ(latest->getName(), "second");
+
+    // now the first table can go, and the second one stays
+    handoff.releaseUnused();
+    second = nullptr;
+    handoff.releaseUnused();
+    EXPECT_EQ(latest->getName(), "second");
+}
+
+TEST(TestWavetable, OscillatorScansFrames)
+{
+    std::vector<float> frames(2 * Wavetable::tableSize);
+    for (int sample = 0; sample < Wavetable::tableSize; ++sample)
+    {
+        float value = std::sin(juce::MathConstants<float>::twoPi * sample / Wavetable::tableSize);
+        frames[static_cast<size_t>(sample)] = value;
+        frames[static_cast<size_t>(Wavetable::tableSize + sample)] = -value;
+    }
+
+    auto wavetable = Wavetable::build(frames.data(), 2, "sines");
+
+    MorphingOscillator oscillator;
+    oscillator.prepare(48000.0f);
+    oscillator.setBaseTableDelta(Wavetable::tableSize * 440.0 / 48000.0);
+    oscillator.setUserWavetable(wavetable.get());
+    oscillator.setUseUserWavetable(true);
+
+    constexpr int numSamples = 256;
+    std::array<float, numSamples> output;
+    auto getPeak = [&] { return juce::FloatVectorOperations::findMaximum(output.data(), numSamples); };
+
+    oscillator.setMorphValue(0.0f);
+    oscillator.renderBlock(output.data(), numSamples);
+    EXPECT_GT(getPeak(), 0.9f);
+
+    // halfway between a sine and its inverse is silence
+    oscillator.setMorphValue(0.5f);
+    oscillator.renderBlock(output.data(), numSamples);
+    EXPECT_LT(getPeak(), 1.0e-4f);
+
+    std::array<float, numSamples> modulation;
+    modulation.fill(0.5f);
+
+    oscillator.setMorphValue(0.0f);
+    oscillator.renderBlock(output.data(), numSamples, modulation.data());
+    EXPECT_LT(getPeak(), 1.0e-4f);
+}
+
+TEST(TestWavetable, FixedPointPhaseWrapsExactly)
+{
+    using namespace PhaseAccumulator;
+
+    Phase phase = fromTableDelta(5.25);
+    EXPECT_EQ(getIndex(phase), 5);
+    EXPECT_FLOAT_EQ(getFraction(phase), 0.25f);
+
+    // the last table sample wraps back to the first with no branch
+    phase = fromTableDelta(Wavetable::tableSize - 0.5) + fromTableDelta(1.0);
+    EXPECT_EQ(getIndex(phase), 0);
+    EXPECT_FLOAT_EQ(getFraction(phase), 0.5f);
+
+    constexpr int period = 64;
+    constexpr int numCycles = 2000;
+
+    MorphingOscillator oscillator;
+    oscillator.prepare(48000.0f);
+    oscillator.setWaveformIndices(1, 2);
+    oscillator.setMorphValue(0.3f);
+    oscillator.setInterpolation(MorphingOscillator::Interpolation::Hermite);
+    oscillator.setBaseTableDelta(static_cast<double>(Wavetable::tableSize) / period);
+
+    std::vector<float> output(period * numCycles);
+    oscillator.renderBlock(output.data(), static_cast<int>(output.size()));
+
+    for (int cycle = 1; cycle < numCycles; ++cycle)
+        ASSERT_EQ(std::memcmp(output.data(), output.data() + cycle * period, period * sizeof(float)), 0) << "cycle " << cycle;
+}
+
+TEST(TestWavetable, SyncAndPhaseModulation)
+{
+    constexpr int sourcePeriod = 64; // a whole number of samples, so the source wraps exactly
+    constexpr int numCycles = 20;
+    constexpr int numSamples = sourcePeriod * numCycles;
+    constexpr int chunkSize = MorphingOscillator::maxChunkSize;
+
+    auto makeOscillator = [](int waveformIndex, double period)
+    {
+        MorphingOscillator oscillator;
+        oscillator.prepare(48000.0f);
+        oscillator.setWaveformIndices(waveformIndex, waveformIndex);
+        oscillator.setBaseTableDelta(Wavetable::tableSize / period);
+        return oscillator;
+    };
+
+    // the carrier's own period has nothing to do with the source's
+    auto render = [&](bool sync, float phaseOffset)
+    {
+        auto source = makeOscillator(0, sourcePeriod);
+        auto carrier = makeOscillator(1, 37.3);
+
+        std::vector<float> output(numSamples);
+        std::array<float, chunkSize> sourceOutput, offsets;
+        offsets.fill(phaseOffset);
+
+        MorphingOscillator::Modulation modulation;
+        modulation.syncSource = sync ? &source : nullptr;
+        modulation.phaseOffset = phaseOffset != 0.0f ? offsets.data() : nullptr;
+
+        for (int start = 0; start < numSamples; start += chunkSize)
+        {
+            source.renderBlock(sourceOutput.data(), chunkSize);
+            carrier.renderBlock(output.data() + start, chunkSize, nullptr, modulation);
+        }
+
+        return output;
+    };
+
+    auto repeatsEveryPeriod = [&](const std::vector<float>& output)
+    {
+        for (int cycle = 1; cycle < numCycles; ++cycle)
+        {
+            if (std::memcmp(output.data(), output.data() + cycle * sourcePeriod, sourcePeriod * sizeof(float)) != 0)
+                return false;
+        }
+
+        return true;
+    };
+
+    EXPECT_FALSE(repeatsEveryPeriod(render(false, 0.0f)));
+    EXPECT_TRUE(repeatsEveryPeriod(render(true, 0.0f)));
+
+    // half a cycle ahead, a sine reads as minus itself
+    auto sine = makeOscillator(0, 100.0);
+    auto shiftedSine = makeOscillator(0, 100.0);
+
+    std::array<float, chunkSize> plain, shifted, offsets;
+    offsets.fill(0.5f);
+    MorphingOscillator::Modulation halfCycle;
+    halfCycle.phaseOffset = offsets.data();
+
+    sine.renderBlock(plain.data(), chunkSize);
+    shiftedSine.renderBlock(shifted.data(), chunkSize, nullptr, halfCycle);
+
+    for (int i = 0; i < chunkSize; ++i)
+        EXPECT_NEAR(shifted[static_cast<size_t>(i)], -plain[static_cast<size_t>(i)], 1.0e-4f);
+
+    // an empty Modulation is the plain oscillator, bit for bit
+    auto unmodulated = makeOscillator(1, 37.3);
+    std::vector<float> expected(numSamples);
+    unmodulated.renderBlock(expected.data(), numSamples);
+    EXPECT_EQ(render(false, 0.0f), expected);
+}
+
+TEST(TestWavetable, CacheMapsPreviouslyBuiltTables)
+{
+    auto previousDirectory = WavetableCache::getDirectory();
+    auto directory = juce::File::createTempFile("CynthiaWavetableCache");
+    WavetableCache::setDirectory(directory);
+
+    constexpr int numFrames = 3;
+    std::vector<float> frames(numFrames * Wavetable::tableSize);
+    juce::Random random(99);
+    for (auto& sample : frames)
+        sample = random.nextFloat() * 2.0f - 1.0f;
+
+    auto built = WavetableCache::getOrBuild(frames.data(), numFrames, "built");
+    EXPECT_FALSE(built->isMemoryMapped());
+    EXPECT_EQ(WavetableCache::getOrBuild(frames.data(), numFrames).get(), built.get());
+
+    WavetableCache::clearSharedTables();
+
+    auto mapped = WavetableCache::getOrBuild(frames.data(), numFrames, "mapped");
+    ASSERT_TRUE(mapped->isMemoryMapped());
+    ASSERT_EQ(mapped->getNumFrames(), numFrames);
+
+    for (int level = 0; level < Wavetable::numMipLevels; ++level)
+    {
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            const float* expected = built->getTable(frame, level) - Wavetable::guardSamples;
+            const float* actual = mapped->getTable(frame, level) - Wavetable::guardSamples;
+            EXPECT_EQ(std::memcmp(expected, actual, Wavetable::stride * sizeof(float)), 0);
+        }
+    }
+
+    // different content is a different table
+    frames[0] += 0.5f;
+    auto other = WavetableCache::getOrBuild(frames.data(), numFrames);
+    EXPECT_NE(other.get(), mapped.get());
+    EXPECT_FALSE(other->isMemoryMapped());
+
+    WavetableCache::setDirectory(previousDirectory);
+    directory.deleteRecursively();
+}
+
+TEST(TestWavetable, CacheDropsStaleAndLeastRecentlyUsedTables)
+{
+    auto previousDirectory = WavetableCache::getDirectory();
+    auto previousMaximumSize = WavetableCache::getMaximumSize();
+    auto directory = juce::File::createTempFile("CynthiaWavetableCache");
+    ASSERT_TRUE(directory.createDirectory());
+    WavetableCache::setDirectory(directory);
+
+    // written by a build with another format version
+    auto staleFile = directory.getChildFile("0123456789abcdef.cyntable");
+    ASSERT_TRUE(staleFile.replaceWithText("old"));
+
+    std::vector<float> frames(Wavetable::tableSize);
+    juce::Random random(7);
+    for (auto& sample : frames)
+        sample = random.nextFloat() * 2.0f - 1.0f;
+
+    auto firstHash = WavetableCache::computeContentHash(frames.data(), 1);
+    WavetableCache::getOrBuild(frames.data(), 1);
+    EXPECT_FALSE(staleFile.exists());
+
+    auto firstFile = WavetableCache::getFile(firstHash);
+    ASSERT_TRUE(firstFile.existsAsFile());
+    firstFile.setLastAccessTime(juce::Time::getCurrentTime() - juce::RelativeTime::hours(1));
+
+    // room for one table and a half
+    WavetableCache::setMaximumSize(firstFile.getSize() * 3 / 2);
+
+    frames[0] += 0.5f;
+    auto secondHash = WavetableCache::computeContentHash(frames.data(), 1);
+    WavetableCache::getOrBuild(frames.data(), 1);
+
+    EXPECT_FALSE(firstFile.exists());
+    EXPECT_TRUE(WavetableCache::getFile(secondHash).existsAsFile());
+
+    WavetableCache::clearSharedTables();
+    WavetableCache::setMaximumSize(previousMaximumSize);
+    WavetableCache::setDirectory(previousDirectory);
+    directory.deleteRecursively();
+}
+
+TEST(TestWavetable, HigherOrderInterpolationIsCleaner)
+{
+    // a high harmonic only has ~10 table samples per cycle, which is where the kernels differ
+    constexpr int harmonic = 200;
+    // exactly representable as a fixed-point increment, so the reference sine stays in phase
+    constexpr double tableDelta = 782451.0 / (1 << PhaseAccumulator::fractionBits);
+    constexpr int numSamples = 4096;
+
+    std::vector<float> sine(Wavetable::tableSize);
+    for (int sample = 0; sample < Wavetable::tableSize; ++sample)
+        sine[static_cast<size_t>(sample)] = static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * harmonic * sample / Wavetable::tableSize));
+
+    auto wavetable = Wavetable::build(sine.data(), 1, "harmonic");
+
+    auto getRmsError = [&](MorphingOscillator::Interpolation mode)
+    {
+        MorphingOscillator oscillator;
+        oscillator.prepare(48000.0f);
+        oscillator.setUserWavetable(wavetable.get());
+        oscillator.setUseUserWavetable(true);
+        oscillator.setInterpolation(mode);
+        oscillator.setBaseTableDelta(tableDelta);
+
+        std::vector<float> output(numSamples);
+        oscillator.renderBlock(output.data(), numSamples);
+
+        double errorPower = 0.0;
+        for (int n = 0; n < numSamples; ++n)
+        {
+            double expected = std::sin(juce::MathConstants<double>::twoPi * harmonic * n * tableDelta / Wavetable::tableSize);
+            errorPower += std::pow(output[static_cast<size_t>(n)] - expected, 2.0);
+        }
+
+        return std::sqrt(errorPower / numSamples);
+    };
+
+    double linearError = getRmsError(MorphingOscillator::Interpolation::Linear);
+    double hermiteError = getRmsError(MorphingOscillator::Interpolation::Hermite);
+    double sincError = getRmsError(MorphingOscillator::Interpolation::Sinc);
+
+    EXPECT_LT(hermiteError, 0.5 * linearError);
+    EXPECT_LT(sincError, 0.5 * hermiteError);
+    EXPECT_LT(sincError, 2.0e-3);
+}